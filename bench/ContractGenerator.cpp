@@ -0,0 +1,88 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Generator for synthetic Solidity sources of controllable shape.
+ */
+
+#include "ContractGenerator.h"
+
+#include <algorithm>
+#include <sstream>
+
+using namespace std;
+
+namespace dev
+{
+namespace solidity
+{
+namespace bench
+{
+
+namespace
+{
+
+/// Builds an arithmetic expression over the parameter x with the given
+/// nesting depth, exercising the recursive descent of the expression parser.
+string generateExpression(size_t _depth)
+{
+	if (_depth == 0)
+		return "x";
+	return "(x + (" + generateExpression(_depth - 1) + " * 3))";
+}
+
+}
+
+string generateContract(GeneratorSpec const& _spec)
+{
+	ostringstream source;
+	size_t depth = max<size_t>(1, _spec.inheritanceDepth);
+	for (size_t level = 0; level < depth; ++level)
+	{
+		source << "contract C" << level;
+		if (level > 0)
+			source << " is C" << (level - 1);
+		source << " {\n";
+		// Only the most derived contract carries the payload, so the
+		// inheritance chain itself is what varies with the depth.
+		if (level + 1 == depth)
+		{
+			if (_spec.structMembers > 0)
+			{
+				source << "\tstruct S {\n";
+				for (size_t i = 0; i < _spec.structMembers; ++i)
+					source << "\t\tuint m" << i << ";\n";
+				source << "\t}\n";
+				source << "\tS s;\n";
+			}
+			if (_spec.arrayLength > 0)
+				source << "\tuint[" << _spec.arrayLength << "] arr;\n";
+			for (size_t i = 0; i < _spec.functions; ++i)
+			{
+				source << "\tfunction f" << i << "(uint x) returns (uint) {\n";
+				source << "\t\treturn " << generateExpression(_spec.expressionDepth) << ";\n";
+				source << "\t}\n";
+			}
+		}
+		source << "}\n";
+	}
+	return source.str();
+}
+
+}
+}
+}
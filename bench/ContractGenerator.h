@@ -0,0 +1,51 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Generator for synthetic Solidity sources of controllable shape, used by
+ * solbench to measure how the compiler phases scale with input size.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace dev
+{
+namespace solidity
+{
+namespace bench
+{
+
+/// Shape of a generated source. The defaults give a small but non-trivial
+/// contract; scaling runs vary one dimension while keeping the others fixed.
+struct GeneratorSpec
+{
+	size_t functions = 10;        ///< number of functions in the most derived contract
+	size_t inheritanceDepth = 1;  ///< length of the linear inheritance chain
+	size_t expressionDepth = 4;   ///< nesting depth of the generated return expressions
+	size_t structMembers = 0;     ///< members of a generated struct state variable
+	size_t arrayLength = 0;       ///< length of a generated fixed-size state array
+};
+
+/// @returns a compilable Solidity source with the given shape.
+std::string generateContract(GeneratorSpec const& _spec);
+
+}
+}
+}
@@ -0,0 +1,371 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Benchmark driver for the compiler phases. Runs scanning, parsing, semantic
+ * analysis and code generation in isolation over the contract corpus in
+ * test/contracts and reports ns/op and bytes/op, optionally as JSON.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cmath>
+#include <boost/program_options.hpp>
+#include <json/json.h>
+#include <libdevcore/CommonIO.h>
+#include <libsolidity/CompilerStack.h>
+#include <libsolidity/Scanner.h>
+#include <libsolidity/Version.h>
+#include "ContractGenerator.h"
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+namespace po = boost::program_options;
+
+namespace
+{
+
+#ifndef SOLBENCH_CORPUS_DIR
+#define SOLBENCH_CORPUS_DIR ""
+#endif
+
+/// Extracts the contract source embedded as a raw string literal in one of the
+/// test fixtures in test/contracts, so the corpus is not duplicated here.
+string extractEmbeddedSource(string const& _path)
+{
+	string content = contentsString(_path);
+	string const startMarker = "R\"DELIMITER(";
+	string const endMarker = ")DELIMITER\"";
+	size_t start = content.find(startMarker);
+	size_t end = content.find(endMarker);
+	if (start == string::npos || end == string::npos || end <= start)
+		return string();
+	start += startMarker.size();
+	return content.substr(start, end - start);
+}
+
+/// Sums all numeric leaves of a memory accounting document.
+double sumBytes(Json::Value const& _value)
+{
+	if (_value.isNumeric())
+		return _value.asDouble();
+	double total = 0;
+	if (_value.isObject() || _value.isArray())
+		for (Json::Value const& member: _value)
+			total += sumBytes(member);
+	return total;
+}
+
+struct Result
+{
+	string name;
+	double nsPerOp = 0;
+	double bytesPerOp = 0;
+	size_t repetitions = 0;
+};
+
+/// Times one invocation of @a _op in nanoseconds. Benchmarks call this around
+/// the phase under test so that per-iteration setup stays untimed.
+double timeOp(function<void()> const& _op)
+{
+	auto start = chrono::steady_clock::now();
+	_op();
+	auto duration = chrono::steady_clock::now() - start;
+	return double(chrono::duration_cast<chrono::nanoseconds>(duration).count());
+}
+
+/// Runs @a _op (which returns (ns, bytes) for one operation) with warmup and
+/// repetition control and @returns the averaged result.
+Result measure(string const& _name, size_t _warmup, size_t _repetitions, function<pair<double, double>()> const& _op)
+{
+	for (size_t i = 0; i < _warmup; ++i)
+		_op();
+	double ns = 0;
+	double bytes = 0;
+	for (size_t i = 0; i < _repetitions; ++i)
+	{
+		pair<double, double> sample = _op();
+		ns += sample.first;
+		bytes += sample.second;
+	}
+	Result result;
+	result.name = _name;
+	result.repetitions = _repetitions;
+	result.nsPerOp = _repetitions > 0 ? ns / _repetitions : 0;
+	result.bytesPerOp = _repetitions > 0 ? bytes / _repetitions : 0;
+	return result;
+}
+
+/// Benchmarks all compiler phases in isolation over one source and @returns
+/// the results named "<phase>/<label>".
+vector<Result> measurePhases(string const& _label, string const& _source, size_t _warmup, size_t _repetitions)
+{
+	vector<Result> results;
+	CharStream stream(_source);
+
+	results.push_back(measure("scan/" + _label, _warmup, _repetitions, [&]() -> pair<double, double>
+	{
+		// Whole-source tokenization happens in the constructor.
+		double ns = timeOp([&]() { Scanner scanner(stream, _label, true); });
+		return make_pair(ns, double(_source.size()));
+	}));
+
+	results.push_back(measure("parse/" + _label, _warmup, _repetitions, [&]() -> pair<double, double>
+	{
+		CompilerStack stack;
+		stack.addSource(_label, _source);
+		double ns = timeOp([&]()
+		{
+			if (!stack.parse())
+			{
+				cerr << "Parsing of benchmark source " << _label << " failed." << endl;
+				exit(2);
+			}
+		});
+		return make_pair(ns, sumBytes(stack.memoryAccounting()));
+	}));
+
+	results.push_back(measure("analyze/" + _label, _warmup, _repetitions, [&]() -> pair<double, double>
+	{
+		CompilerStack stack;
+		stack.addSource(_label, _source);
+		stack.parse();
+		// Only name resolution and type checking are timed here.
+		double ns = timeOp([&]()
+		{
+			if (!stack.typeCheck())
+			{
+				cerr << "Analysis of benchmark source " << _label << " failed." << endl;
+				exit(2);
+			}
+		});
+		return make_pair(ns, sumBytes(stack.memoryAccounting()));
+	}));
+
+	results.push_back(measure("codegen/" + _label, _warmup, _repetitions, [&]() -> pair<double, double>
+	{
+		CompilerStack stack;
+		stack.addSource(_label, _source);
+		stack.typeCheck();
+		double ns = timeOp([&]()
+		{
+			if (!stack.compile())
+			{
+				cerr << "Compilation of benchmark source " << _label << " failed." << endl;
+				exit(2);
+			}
+		});
+		return make_pair(ns, sumBytes(stack.memoryAccounting()));
+	}));
+
+	return results;
+}
+
+/// Fits time = c * n^exponent to the samples via least squares in log-log
+/// space and @returns the exponent, the empirical scaling of one phase.
+double fitExponent(vector<pair<double, double>> const& _samples)
+{
+	if (_samples.size() < 2)
+		return 0;
+	double sumX = 0;
+	double sumY = 0;
+	double sumXX = 0;
+	double sumXY = 0;
+	for (auto const& sample: _samples)
+	{
+		double x = log(sample.first);
+		double y = log(max(sample.second, 1.0));
+		sumX += x;
+		sumY += y;
+		sumXX += x * x;
+		sumXY += x * y;
+	}
+	double n = double(_samples.size());
+	return (n * sumXY - sumX * sumY) / (n * sumXX - sumX * sumX);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	po::options_description desc("Usage: solbench [options]");
+	desc.add_options()
+		("help", "Show help message and exit.")
+		("warmup", po::value<size_t>()->default_value(2), "Untimed warmup iterations per benchmark.")
+		("repetitions", po::value<size_t>()->default_value(10), "Timed iterations per benchmark.")
+		("corpus-dir", po::value<string>()->default_value(SOLBENCH_CORPUS_DIR), "Directory holding the contract corpus fixtures.")
+		("json", "Emit the results as JSON for trend tracking.")
+		("stress", "Run the synthetic scaling benchmarks instead of the corpus.")
+		("stress-max", po::value<size_t>()->default_value(64), "Largest function count N of the generated contracts; sizes double from 8 up to this.")
+		("stress-inheritance", po::value<size_t>()->default_value(4), "Inheritance chain depth of the generated contracts.")
+		("stress-expression-depth", po::value<size_t>()->default_value(4), "Expression nesting depth of the generated contracts.")
+		("assert-scaling", po::value<double>(), "Fail (exit code 3) if a phase's fitted time exponent over N exceeds this value.");
+	po::variables_map args;
+	try
+	{
+		po::store(po::parse_command_line(argc, argv, desc), args);
+		po::notify(args);
+	}
+	catch (po::error const& _error)
+	{
+		cerr << _error.what() << endl;
+		return 1;
+	}
+	if (args.count("help"))
+	{
+		cout << desc;
+		return 0;
+	}
+
+	size_t warmup = args["warmup"].as<size_t>();
+	size_t repetitions = args["repetitions"].as<size_t>();
+	string corpusDir = args["corpus-dir"].as<string>();
+
+	if (args.count("stress"))
+	{
+		bench::GeneratorSpec base;
+		base.inheritanceDepth = args["stress-inheritance"].as<size_t>();
+		base.expressionDepth = args["stress-expression-depth"].as<size_t>();
+		base.structMembers = 8;
+		base.arrayLength = 32;
+		size_t maxN = args["stress-max"].as<size_t>();
+
+		vector<Result> results;
+		map<string, vector<pair<double, double>>> timeSamples;
+		map<string, vector<pair<double, double>>> memorySamples;
+		for (size_t n = 8; n <= maxN; n *= 2)
+		{
+			bench::GeneratorSpec spec = base;
+			spec.functions = n;
+			string source = bench::generateContract(spec);
+			for (Result const& result: measurePhases("N=" + to_string(n), source, warmup, repetitions))
+			{
+				results.push_back(result);
+				string phase = result.name.substr(0, result.name.find('/'));
+				timeSamples[phase].push_back(make_pair(double(n), result.nsPerOp));
+				memorySamples[phase].push_back(make_pair(double(n), result.bytesPerOp));
+			}
+		}
+
+		bool failed = false;
+		if (args.count("json"))
+		{
+			Json::Value output(Json::objectValue);
+			output["version"] = VersionString;
+			Json::Value phases(Json::arrayValue);
+			for (auto const& phase: timeSamples)
+			{
+				Json::Value entry(Json::objectValue);
+				entry["phase"] = phase.first;
+				entry["timeExponent"] = fitExponent(phase.second);
+				entry["memoryExponent"] = fitExponent(memorySamples[phase.first]);
+				Json::Value samples(Json::arrayValue);
+				for (auto const& sample: phase.second)
+				{
+					Json::Value point(Json::objectValue);
+					point["n"] = Json::UInt(size_t(sample.first));
+					point["nsPerOp"] = sample.second;
+					samples.append(point);
+				}
+				entry["samples"] = samples;
+				phases.append(entry);
+			}
+			output["stress"] = phases;
+			cout << Json::FastWriter().write(output);
+		}
+		else
+		{
+			cout << "benchmark\tns/op\tbytes/op" << endl;
+			for (Result const& result: results)
+				cout << result.name << "\t" << uint64_t(result.nsPerOp) << "\t" << uint64_t(result.bytesPerOp) << endl;
+			cout << endl << "phase\ttime-exponent\tmemory-exponent" << endl;
+			for (auto const& phase: timeSamples)
+				cout << phase.first << "\t" << fitExponent(phase.second) << "\t" << fitExponent(memorySamples[phase.first]) << endl;
+		}
+		if (args.count("assert-scaling"))
+		{
+			double maxExponent = args["assert-scaling"].as<double>();
+			for (auto const& phase: timeSamples)
+				if (fitExponent(phase.second) > maxExponent)
+				{
+					cerr << "Scaling assertion failed: phase " << phase.first << " has time exponent "
+						<< fitExponent(phase.second) << " > " << maxExponent << "." << endl;
+					failed = true;
+				}
+		}
+		return failed ? 3 : 0;
+	}
+
+	map<string, string> corpus;
+	for (auto const& fixture: map<string, string>{
+		{"Wallet", "Wallet.cpp"},
+		{"AuctionRegistrar", "AuctionRegistrar.cpp"},
+		{"FixedFeeRegistrar", "FixedFeeRegistrar.cpp"}
+	})
+	{
+		string source = extractEmbeddedSource(corpusDir + "/" + fixture.second);
+		if (source.empty())
+			cerr << "Skipping corpus entry " << fixture.first << ": no embedded source found." << endl;
+		else
+			corpus[fixture.first] = source;
+	}
+	if (corpus.empty())
+	{
+		cerr << "No corpus sources found in " << corpusDir << "." << endl;
+		return 1;
+	}
+
+	vector<Result> results;
+	for (auto const& entry: corpus)
+		for (Result const& result: measurePhases(entry.first, entry.second, warmup, repetitions))
+			results.push_back(result);
+
+	if (args.count("json"))
+	{
+		Json::Value output(Json::objectValue);
+		output["version"] = VersionString;
+		output["warmup"] = Json::UInt(warmup);
+		output["repetitions"] = Json::UInt(repetitions);
+		Json::Value benchmarks(Json::arrayValue);
+		for (Result const& result: results)
+		{
+			Json::Value benchmark(Json::objectValue);
+			benchmark["name"] = result.name;
+			benchmark["nsPerOp"] = result.nsPerOp;
+			benchmark["bytesPerOp"] = result.bytesPerOp;
+			benchmark["repetitions"] = Json::UInt(result.repetitions);
+			benchmarks.append(benchmark);
+		}
+		output["benchmarks"] = benchmarks;
+		cout << Json::FastWriter().write(output);
+	}
+	else
+	{
+		cout << "benchmark\tns/op\tbytes/op" << endl;
+		for (Result const& result: results)
+			cout << result.name << "\t" << uint64_t(result.nsPerOp) << "\t" << uint64_t(result.bytesPerOp) << endl;
+	}
+
+	return 0;
+}
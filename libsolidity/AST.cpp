@@ -21,7 +21,9 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
+#include <mutex>
 #include <libsolidity/Utils.h>
 #include <libsolidity/AST.h>
 #include <libsolidity/ASTVisitor.h>
@@ -34,20 +36,36 @@ using namespace std;
 using namespace dev;
 using namespace dev::solidity;
 
+namespace
+{
+
+/// Source of the dense node IDs, see ASTNode::id().
+atomic<size_t> s_nextNodeID{0};
+
+}
+
 ASTNode::ASTNode(SourceLocation const& _location):
+	m_id(s_nextNodeID++),
 	m_location(_location)
 {
 }
 
 ASTNode::~ASTNode()
 {
-	delete m_annotation;
+	if (!m_annotation)
+		return;
+	if (m_arena)
+		// Arena-backed annotations are destroyed in place; the memory itself
+		// is returned when the arena's slabs are freed.
+		m_annotation->~ASTAnnotation();
+	else
+		delete m_annotation;
 }
 
 ASTAnnotation& ASTNode::annotation() const
 {
 	if (!m_annotation)
-		m_annotation = new ASTAnnotation();
+		m_annotation = createAnnotation<ASTAnnotation>();
 	return *m_annotation;
 }
 
@@ -56,20 +74,27 @@ Error ASTNode::createTypeError(string const& _description) const
 	return Error(Error::Type::TypeError) << errinfo_sourceLocation(location()) << errinfo_comment(_description);
 }
 
-map<FixedHash<4>, FunctionTypePointer> ContractDefinition::interfaceFunctions() const
+map<FixedHash<4>, FunctionTypePointer> const& ContractDefinition::interfaceFunctions() const
 {
-	auto exportedFunctionList = interfaceFunctionList();
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
+	if (!m_interfaceFunctions)
+	{
+		auto const& exportedFunctionList = interfaceFunctionList();
 
-	map<FixedHash<4>, FunctionTypePointer> exportedFunctions;
-	for (auto const& it: exportedFunctionList)
-		exportedFunctions.insert(it);
+		unique_ptr<map<FixedHash<4>, FunctionTypePointer>> exportedFunctions(
+			new map<FixedHash<4>, FunctionTypePointer>()
+		);
+		for (auto const& it: exportedFunctionList)
+			exportedFunctions->insert(it);
 
-	solAssert(
-		exportedFunctionList.size() == exportedFunctions.size(),
-		"Hash collision at Function Definition Hash calculation"
-	);
+		solAssert(
+			exportedFunctionList.size() == exportedFunctions->size(),
+			"Hash collision at Function Definition Hash calculation"
+		);
 
-	return exportedFunctions;
+		m_interfaceFunctions = move(exportedFunctions);
+	}
+	return *m_interfaceFunctions;
 }
 
 FunctionDefinition const* ContractDefinition::constructor() const
@@ -91,6 +116,9 @@ FunctionDefinition const* ContractDefinition::fallbackFunction() const
 
 vector<ASTPointer<EventDefinition>> const& ContractDefinition::interfaceEvents() const
 {
+	// Contracts are type checked concurrently, and a derived contract can trigger
+	// this initialization on its bases; guarded by the shared type cache mutex.
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
 	if (!m_interfaceEvents)
 	{
 		set<string> eventsSeen;
@@ -108,6 +136,7 @@ vector<ASTPointer<EventDefinition>> const& ContractDefinition::interfaceEvents()
 
 vector<pair<FixedHash<4>, FunctionTypePointer>> const& ContractDefinition::interfaceFunctionList() const
 {
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
 	if (!m_interfaceFunctionList)
 	{
 		set<string> functionsSeen;
@@ -163,6 +192,7 @@ void ContractDefinition::setUserDocumentation(string const& _userDocumentation)
 
 vector<Declaration const*> const& ContractDefinition::inheritableMembers() const
 {
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
 	if (!m_inheritableMembers)
 	{
 		set<string> memberSeen;
@@ -196,14 +226,14 @@ TypePointer ContractDefinition::type(ContractDefinition const* m_currentContract
 ContractDefinitionAnnotation& ContractDefinition::annotation() const
 {
 	if (!m_annotation)
-		m_annotation = new ContractDefinitionAnnotation();
+		m_annotation = createAnnotation<ContractDefinitionAnnotation>();
 	return static_cast<ContractDefinitionAnnotation&>(*m_annotation);
 }
 
 TypeNameAnnotation& TypeName::annotation() const
 {
 	if (!m_annotation)
-		m_annotation = new TypeNameAnnotation();
+		m_annotation = createAnnotation<TypeNameAnnotation>();
 	return static_cast<TypeNameAnnotation&>(*m_annotation);
 }
 
@@ -215,7 +245,7 @@ TypePointer StructDefinition::type(ContractDefinition const*) const
 TypeDeclarationAnnotation& StructDefinition::annotation() const
 {
 	if (!m_annotation)
-		m_annotation = new TypeDeclarationAnnotation();
+		m_annotation = createAnnotation<TypeDeclarationAnnotation>();
 	return static_cast<TypeDeclarationAnnotation&>(*m_annotation);
 }
 
@@ -234,7 +264,7 @@ TypePointer EnumDefinition::type(ContractDefinition const*) const
 TypeDeclarationAnnotation& EnumDefinition::annotation() const
 {
 	if (!m_annotation)
-		m_annotation = new TypeDeclarationAnnotation();
+		m_annotation = createAnnotation<TypeDeclarationAnnotation>();
 	return static_cast<TypeDeclarationAnnotation&>(*m_annotation);
 }
 
@@ -261,7 +291,7 @@ TypePointer EventDefinition::type(ContractDefinition const*) const
 UserDefinedTypeNameAnnotation& UserDefinedTypeName::annotation() const
 {
 	if (!m_annotation)
-		m_annotation = new UserDefinedTypeNameAnnotation();
+		m_annotation = createAnnotation<UserDefinedTypeNameAnnotation>();
 	return static_cast<UserDefinedTypeNameAnnotation&>(*m_annotation);
 }
 
@@ -311,55 +341,55 @@ TypePointer VariableDeclaration::type(ContractDefinition const*) const
 VariableDeclarationAnnotation& VariableDeclaration::annotation() const
 {
 	if (!m_annotation)
-		m_annotation = new VariableDeclarationAnnotation();
+		m_annotation = createAnnotation<VariableDeclarationAnnotation>();
 	return static_cast<VariableDeclarationAnnotation&>(*m_annotation);
 }
 
 ReturnAnnotation& Return::annotation() const
 {
 	if (!m_annotation)
-		m_annotation = new ReturnAnnotation();
+		m_annotation = createAnnotation<ReturnAnnotation>();
 	return static_cast<ReturnAnnotation&>(*m_annotation);
 }
 
 VariableDeclarationStatementAnnotation& VariableDeclarationStatement::annotation() const
 {
 	if (!m_annotation)
-		m_annotation = new VariableDeclarationStatementAnnotation();
+		m_annotation = createAnnotation<VariableDeclarationStatementAnnotation>();
 	return static_cast<VariableDeclarationStatementAnnotation&>(*m_annotation);
 }
 
 ExpressionAnnotation& Expression::annotation() const
 {
 	if (!m_annotation)
-		m_annotation = new ExpressionAnnotation();
+		m_annotation = createAnnotation<ExpressionAnnotation>();
 	return static_cast<ExpressionAnnotation&>(*m_annotation);
 }
 
 MemberAccessAnnotation& MemberAccess::annotation() const
 {
 	if (!m_annotation)
-		m_annotation = new MemberAccessAnnotation();
+		m_annotation = createAnnotation<MemberAccessAnnotation>();
 	return static_cast<MemberAccessAnnotation&>(*m_annotation);
 }
 
 BinaryOperationAnnotation& BinaryOperation::annotation() const
 {
 	if (!m_annotation)
-		m_annotation = new BinaryOperationAnnotation();
+		m_annotation = createAnnotation<BinaryOperationAnnotation>();
 	return static_cast<BinaryOperationAnnotation&>(*m_annotation);
 }
 
 FunctionCallAnnotation& FunctionCall::annotation() const
 {
 	if (!m_annotation)
-		m_annotation = new FunctionCallAnnotation();
+		m_annotation = createAnnotation<FunctionCallAnnotation>();
 	return static_cast<FunctionCallAnnotation&>(*m_annotation);
 }
 
 IdentifierAnnotation& Identifier::annotation() const
 {
 	if (!m_annotation)
-		m_annotation = new IdentifierAnnotation();
+		m_annotation = createAnnotation<IdentifierAnnotation>();
 	return static_cast<IdentifierAnnotation&>(*m_annotation);
 }
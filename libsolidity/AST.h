@@ -27,6 +27,7 @@
 #include <vector>
 #include <memory>
 #include <boost/noncopyable.hpp>
+#include <new>
 #include <libevmasm/SourceLocation.h>
 #include <libsolidity/Utils.h>
 #include <libsolidity/ASTForward.h>
@@ -34,6 +35,7 @@
 #include <libsolidity/Types.h>
 #include <libsolidity/Exceptions.h>
 #include <libsolidity/ASTAnnotations.h>
+#include <libsolidity/ASTArena.h>
 
 namespace dev
 {
@@ -73,6 +75,11 @@ public:
 	/// Returns the source code location of this node.
 	SourceLocation const& location() const { return m_location; }
 
+	/// @returns the id of this node: a process-wide unique number assigned in creation
+	/// order. IDs of the nodes of one parse are contiguous, so they can serve as indices
+	/// into flat side tables (see ASTNodeMap).
+	size_t id() const { return m_id; }
+
 	/// Creates a @ref TypeError exception and decorates it with the location of the node and
 	/// the given description
 	Error createTypeError(std::string const& _description) const;
@@ -80,6 +87,12 @@ public:
 	///@todo make this const-safe by providing a different way to access the annotation
 	virtual ASTAnnotation& annotation() const;
 
+	/// Sets the arena whose memory backs this node. Annotations are then bump-allocated
+	/// from the same arena instead of the global heap. The caller has to guarantee that
+	/// the arena outlives the node (nodes created through the parser's factory satisfy
+	/// this because their control blocks keep the arena alive).
+	void setAnnotationArena(ASTArena* _arena) { m_arena = _arena; }
+
 	///@{
 	///@name equality operators
 	/// Equality relies on the fact that nodes cannot be copied.
@@ -88,11 +101,23 @@ public:
 	///@}
 
 protected:
+	/// Creates the annotation object, placing it into the arena if one is set.
+	template <class T>
+	T* createAnnotation() const
+	{
+		if (m_arena)
+			return new(m_arena->allocate(sizeof(T), alignof(T))) T();
+		return new T();
+	}
+
 	/// Annotation - is specialised in derived classes, is created upon request (because of polymorphism).
 	mutable ASTAnnotation* m_annotation = nullptr;
 
 private:
+	size_t m_id;
 	SourceLocation m_location;
+	/// Arena backing the annotation (and usually the node itself), can be null.
+	ASTArena* m_arena = nullptr;
 };
 
 /**
@@ -109,8 +134,15 @@ public:
 
 	std::vector<ASTPointer<ASTNode>> nodes() const { return m_nodes; }
 
+	/// Attaches the arena the nodes of this source unit were allocated in,
+	/// mainly for memory accounting. The nodes themselves keep the arena
+	/// alive through their control blocks in any case.
+	void setArena(std::shared_ptr<ASTArena const> const& _arena) { m_arena = _arena; }
+	std::shared_ptr<ASTArena const> const& arena() const { return m_arena; }
+
 private:
 	std::vector<ASTPointer<ASTNode>> m_nodes;
+	std::shared_ptr<ASTArena const> m_arena;
 };
 
 /**
@@ -272,8 +304,9 @@ public:
 	bool isLibrary() const { return m_isLibrary; }
 
 	/// @returns a map of canonical function signatures to FunctionDefinitions
-	/// as intended for use by the ABI.
-	std::map<FixedHash<4>, FunctionTypePointer> interfaceFunctions() const;
+	/// as intended for use by the ABI. Sorted by selector and built only once;
+	/// codegen, the interface handler and gas estimation share the instance.
+	std::map<FixedHash<4>, FunctionTypePointer> const& interfaceFunctions() const;
 	std::vector<std::pair<FixedHash<4>, FunctionTypePointer>> const& interfaceFunctionList() const;
 
 	/// @returns a list of the inheritable members of this contract
@@ -310,6 +343,7 @@ private:
 
 	std::vector<ContractDefinition const*> m_linearizedBaseContracts;
 	mutable std::unique_ptr<std::vector<std::pair<FixedHash<4>, FunctionTypePointer>>> m_interfaceFunctionList;
+	mutable std::unique_ptr<std::map<FixedHash<4>, FunctionTypePointer>> m_interfaceFunctions;
 	mutable std::unique_ptr<std::vector<ASTPointer<EventDefinition>>> m_interfaceEvents;
 	mutable std::unique_ptr<std::vector<Declaration const*>> m_inheritableMembers;
 };
@@ -806,6 +840,8 @@ public:
 	virtual void accept(ASTVisitor& _visitor) override;
 	virtual void accept(ASTConstVisitor& _visitor) const override;
 
+	std::vector<ASTPointer<Statement>> const& statements() const { return m_statements; }
+
 private:
 	std::vector<ASTPointer<Statement>> m_statements;
 };
@@ -1341,10 +1377,20 @@ public:
 
 	SubDenomination subDenomination() const { return m_subDenomination; }
 
+	/// @returns true if the scanner already converted this number literal to
+	/// its numeric value, so consumers do not have to re-parse the text.
+	bool scannedValueKnown() const { return m_scannedValueKnown; }
+	/// @returns the pre-parsed value, only valid if scannedValueKnown().
+	u256 const& scannedValue() const { return m_scannedValue; }
+	/// Attaches the numeric value determined by the scanner.
+	void setScannedValue(u256 const& _value) { m_scannedValue = _value; m_scannedValueKnown = true; }
+
 private:
 	Token::Value m_token;
 	ASTPointer<ASTString> m_value;
 	SubDenomination m_subDenomination;
+	u256 m_scannedValue;
+	bool m_scannedValueKnown = false;
 };
 
 /// @}
@@ -26,6 +26,7 @@
 #include <memory>
 #include <vector>
 #include <set>
+#include <libdevcore/Common.h>
 #include <libsolidity/ASTForward.h>
 
 namespace dev
@@ -102,6 +103,9 @@ struct ExpressionAnnotation: ASTAnnotation
 	/// Types of arguments if the expression is a function that is called - used
 	/// for overload resolution.
 	std::shared_ptr<std::vector<TypePointer>> argumentTypes;
+	/// Compile-time value of the expression, already in the EVM representation of @a type,
+	/// if constant folding was able to determine one. Set by ConstantFolder.
+	std::shared_ptr<u256 const> foldedValue;
 };
 
 struct IdentifierAnnotation: ExpressionAnnotation
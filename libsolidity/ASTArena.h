@@ -0,0 +1,110 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Slab/bump allocator backing the AST of a source unit.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <libsolidity/Utils.h>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Bump allocator for AST nodes. Nodes are placement-allocated into large
+ * slabs (via allocate_shared and ASTArenaAllocator), so parsing performs one
+ * heap allocation per slab instead of one per node, nodes of a source unit
+ * are laid out contiguously for the later passes, and all memory is returned
+ * wholesale once the last node referencing the arena goes away.
+ */
+class ASTArena
+{
+public:
+	void* allocate(size_t _size, size_t _alignment)
+	{
+		solAssert(_alignment != 0 && (_alignment & (_alignment - 1)) == 0, "");
+		size_t offset = (m_used + _alignment - 1) & ~(_alignment - 1);
+		if (m_slabs.empty() || offset + _size > m_currentSlabSize)
+		{
+			// Oversized requests get a slab of their own.
+			size_t slabSize = std::max(c_slabSize, _size);
+			m_slabs.emplace_back(new char[slabSize]);
+			m_currentSlabSize = slabSize;
+			offset = 0;
+		}
+		m_used = offset + _size;
+		m_bytesAllocated += _size;
+		return m_slabs.back().get() + offset;
+	}
+
+	/// Individual deallocation is a no-op; the slabs are freed when the arena
+	/// itself is destroyed.
+	void deallocate(void*, size_t) {}
+
+	size_t bytesAllocated() const { return m_bytesAllocated; }
+	size_t slabCount() const { return m_slabs.size(); }
+
+private:
+	static size_t const c_slabSize = 1 << 16;
+
+	std::vector<std::unique_ptr<char[]>> m_slabs;
+	size_t m_currentSlabSize = 0;
+	size_t m_used = 0;
+	size_t m_bytesAllocated = 0;
+};
+
+/**
+ * Standard-library compatible allocator handing out memory from an ASTArena.
+ * It holds shared ownership of the arena, so every control block created via
+ * allocate_shared keeps the arena (and thereby all slabs) alive for as long
+ * as any node is still referenced.
+ */
+template <class T>
+class ASTArenaAllocator
+{
+public:
+	using value_type = T;
+
+	explicit ASTArenaAllocator(std::shared_ptr<ASTArena> _arena): m_arena(std::move(_arena)) {}
+	template <class U>
+	ASTArenaAllocator(ASTArenaAllocator<U> const& _other): m_arena(_other.arena()) {}
+
+	T* allocate(size_t _n)
+	{
+		return static_cast<T*>(m_arena->allocate(_n * sizeof(T), alignof(T)));
+	}
+	void deallocate(T* _pointer, size_t _n) { m_arena->deallocate(_pointer, _n * sizeof(T)); }
+
+	std::shared_ptr<ASTArena> const& arena() const { return m_arena; }
+
+	template <class U>
+	bool operator==(ASTArenaAllocator<U> const& _other) const { return m_arena == _other.arena(); }
+	template <class U>
+	bool operator!=(ASTArenaAllocator<U> const& _other) const { return m_arena != _other.arena(); }
+
+private:
+	std::shared_ptr<ASTArena> m_arena;
+};
+
+}
+}
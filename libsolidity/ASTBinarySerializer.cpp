@@ -0,0 +1,849 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Compact binary serialization of the AST with a fast load path.
+ */
+
+#include <libsolidity/ASTBinarySerializer.h>
+#include <map>
+#include <libdevcore/CommonData.h>
+#include <libsolidity/AST.h>
+#include <libsolidity/ASTArena.h>
+#include <libsolidity/ASTStringPool.h>
+#include <libsolidity/Exceptions.h>
+#include <libsolidity/Version.h>
+
+using namespace std;
+
+namespace dev
+{
+namespace solidity
+{
+
+namespace
+{
+
+/// Tag identifying the concrete node class in the stream. The values are part
+/// of the format and must never be reordered; append new nodes at the end and
+/// bump ASTBinarySerializer::c_formatVersion.
+enum NodeKind
+{
+	NullNode = 0,
+	SourceUnitNode,
+	ImportDirectiveNode,
+	ContractDefinitionNode,
+	InheritanceSpecifierNode,
+	StructDefinitionNode,
+	EnumDefinitionNode,
+	EnumValueNode,
+	ParameterListNode,
+	FunctionDefinitionNode,
+	VariableDeclarationNode,
+	ModifierDefinitionNode,
+	ModifierInvocationNode,
+	EventDefinitionNode,
+	ElementaryTypeNameNode,
+	UserDefinedTypeNameNode,
+	MappingNode,
+	ArrayTypeNameNode,
+	BlockNode,
+	PlaceholderStatementNode,
+	IfStatementNode,
+	WhileStatementNode,
+	ForStatementNode,
+	ContinueNode,
+	BreakNode,
+	ReturnNode,
+	ThrowNode,
+	VariableDeclarationStatementNode,
+	ExpressionStatementNode,
+	AssignmentNode,
+	TupleExpressionNode,
+	UnaryOperationNode,
+	BinaryOperationNode,
+	FunctionCallNode,
+	NewExpressionNode,
+	MemberAccessNode,
+	IndexAccessNode,
+	IdentifierNode,
+	ElementaryTypeNameExpressionNode,
+	LiteralNode
+};
+
+void appendVarint(bytes& _out, size_t _value)
+{
+	while (_value >= 0x80)
+	{
+		_out.push_back(byte(_value & 0x7f) | 0x80);
+		_value >>= 7;
+	}
+	_out.push_back(byte(_value));
+}
+
+void appendLengthPrefixed(bytes& _out, string const& _string)
+{
+	appendVarint(_out, _string.size());
+	_out.insert(_out.end(), _string.begin(), _string.end());
+}
+
+/**
+ * Writes the node stream and collects the string table as a side effect; the
+ * table and the header are only assembled once the whole tree is written.
+ */
+class Writer
+{
+public:
+	void writeNode(ASTNode const* _node);
+	/// @returns header, string table and node stream concatenated.
+	bytes assemble(string const& _sourceName) const;
+
+private:
+	/// Emits the node tag and the source location common to all nodes.
+	void begin(NodeKind _kind, ASTNode const& _node)
+	{
+		appendVarint(m_stream, _kind);
+		// Shifted by one so that the "unknown position" value -1 stays a
+		// single byte.
+		appendVarint(m_stream, size_t(_node.location().start + 1));
+		appendVarint(m_stream, size_t(_node.location().end + 1));
+	}
+	size_t stringIndex(string const& _string)
+	{
+		auto it = m_stringIndices.find(_string);
+		if (it == m_stringIndices.end())
+		{
+			it = m_stringIndices.insert(make_pair(_string, m_strings.size())).first;
+			m_strings.push_back(_string);
+		}
+		return it->second;
+	}
+	void writeString(string const& _string) { appendVarint(m_stream, stringIndex(_string)); }
+	/// Index shifted by one, zero denotes absence.
+	void writeOptionalString(ASTPointer<ASTString> const& _string)
+	{
+		appendVarint(m_stream, _string ? stringIndex(*_string) + 1 : 0);
+	}
+	void writeBool(bool _value) { m_stream.push_back(_value ? 1 : 0); }
+	void writeEnum(int _value) { appendVarint(m_stream, size_t(_value)); }
+	template <class T>
+	void writeNodes(vector<ASTPointer<T>> const& _nodes)
+	{
+		appendVarint(m_stream, _nodes.size());
+		for (ASTPointer<T> const& node: _nodes)
+			writeNode(node.get());
+	}
+
+	vector<string> m_strings;
+	map<string, size_t> m_stringIndices;
+	bytes m_stream;
+};
+
+void Writer::writeNode(ASTNode const* _node)
+{
+	if (!_node)
+	{
+		appendVarint(m_stream, NullNode);
+		return;
+	}
+	if (auto node = dynamic_cast<SourceUnit const*>(_node))
+	{
+		begin(SourceUnitNode, *_node);
+		writeNodes(node->nodes());
+	}
+	else if (auto node = dynamic_cast<ImportDirective const*>(_node))
+	{
+		begin(ImportDirectiveNode, *_node);
+		writeString(node->identifier());
+	}
+	else if (auto node = dynamic_cast<ContractDefinition const*>(_node))
+	{
+		begin(ContractDefinitionNode, *_node);
+		writeString(node->name());
+		writeOptionalString(node->documentation());
+		writeNodes(node->baseContracts());
+		writeNodes(node->definedStructs());
+		writeNodes(node->definedEnums());
+		writeNodes(node->stateVariables());
+		writeNodes(node->definedFunctions());
+		writeNodes(node->functionModifiers());
+		writeNodes(node->events());
+		writeBool(node->isLibrary());
+	}
+	else if (auto node = dynamic_cast<InheritanceSpecifier const*>(_node))
+	{
+		begin(InheritanceSpecifierNode, *_node);
+		writeNode(&node->name());
+		writeNodes(node->arguments());
+	}
+	else if (auto node = dynamic_cast<StructDefinition const*>(_node))
+	{
+		begin(StructDefinitionNode, *_node);
+		writeString(node->name());
+		writeNodes(node->members());
+	}
+	else if (auto node = dynamic_cast<EnumDefinition const*>(_node))
+	{
+		begin(EnumDefinitionNode, *_node);
+		writeString(node->name());
+		writeNodes(node->members());
+	}
+	else if (auto node = dynamic_cast<EnumValue const*>(_node))
+	{
+		begin(EnumValueNode, *_node);
+		writeString(node->name());
+	}
+	else if (auto node = dynamic_cast<ParameterList const*>(_node))
+	{
+		begin(ParameterListNode, *_node);
+		writeNodes(node->parameters());
+	}
+	else if (auto node = dynamic_cast<FunctionDefinition const*>(_node))
+	{
+		begin(FunctionDefinitionNode, *_node);
+		writeString(node->name());
+		writeEnum(int(node->visibility()));
+		writeBool(node->isConstructor());
+		writeOptionalString(node->documentation());
+		writeNode(&node->parameterList());
+		writeBool(node->isDeclaredConst());
+		writeNodes(node->modifiers());
+		writeNode(node->returnParameterList().get());
+		writeNode(node->isImplemented() ? &node->body() : nullptr);
+	}
+	else if (auto node = dynamic_cast<VariableDeclaration const*>(_node))
+	{
+		begin(VariableDeclarationNode, *_node);
+		writeNode(node->typeName());
+		writeString(node->name());
+		writeNode(node->value().get());
+		writeEnum(int(node->visibility()));
+		writeBool(node->isStateVariable());
+		writeBool(node->isIndexed());
+		writeBool(node->isConstant());
+		writeEnum(int(node->referenceLocation()));
+	}
+	else if (auto node = dynamic_cast<ModifierDefinition const*>(_node))
+	{
+		begin(ModifierDefinitionNode, *_node);
+		writeString(node->name());
+		writeOptionalString(node->documentation());
+		writeNode(&node->parameterList());
+		writeNode(&node->body());
+	}
+	else if (auto node = dynamic_cast<ModifierInvocation const*>(_node))
+	{
+		begin(ModifierInvocationNode, *_node);
+		writeNode(node->name().get());
+		writeNodes(node->arguments());
+	}
+	else if (auto node = dynamic_cast<EventDefinition const*>(_node))
+	{
+		begin(EventDefinitionNode, *_node);
+		writeString(node->name());
+		writeOptionalString(node->documentation());
+		writeNode(&node->parameterList());
+		writeBool(node->isAnonymous());
+	}
+	else if (auto node = dynamic_cast<ElementaryTypeName const*>(_node))
+	{
+		begin(ElementaryTypeNameNode, *_node);
+		writeEnum(int(node->typeName()));
+	}
+	else if (auto node = dynamic_cast<UserDefinedTypeName const*>(_node))
+	{
+		begin(UserDefinedTypeNameNode, *_node);
+		appendVarint(m_stream, node->namePath().size());
+		for (ASTString const& part: node->namePath())
+			writeString(part);
+	}
+	else if (auto node = dynamic_cast<Mapping const*>(_node))
+	{
+		begin(MappingNode, *_node);
+		writeNode(&node->keyType());
+		writeNode(&node->valueType());
+	}
+	else if (auto node = dynamic_cast<ArrayTypeName const*>(_node))
+	{
+		begin(ArrayTypeNameNode, *_node);
+		writeNode(&node->baseType());
+		writeNode(node->length());
+	}
+	else if (auto node = dynamic_cast<Block const*>(_node))
+	{
+		begin(BlockNode, *_node);
+		writeNodes(node->statements());
+	}
+	else if (dynamic_cast<PlaceholderStatement const*>(_node))
+		begin(PlaceholderStatementNode, *_node);
+	else if (auto node = dynamic_cast<IfStatement const*>(_node))
+	{
+		begin(IfStatementNode, *_node);
+		writeNode(&node->condition());
+		writeNode(&node->trueStatement());
+		writeNode(node->falseStatement());
+	}
+	else if (auto node = dynamic_cast<WhileStatement const*>(_node))
+	{
+		begin(WhileStatementNode, *_node);
+		writeNode(&node->condition());
+		writeNode(&node->body());
+	}
+	else if (auto node = dynamic_cast<ForStatement const*>(_node))
+	{
+		begin(ForStatementNode, *_node);
+		writeNode(node->initializationExpression());
+		writeNode(node->condition());
+		writeNode(node->loopExpression());
+		writeNode(&node->body());
+	}
+	else if (dynamic_cast<Continue const*>(_node))
+		begin(ContinueNode, *_node);
+	else if (dynamic_cast<Break const*>(_node))
+		begin(BreakNode, *_node);
+	else if (auto node = dynamic_cast<Return const*>(_node))
+	{
+		begin(ReturnNode, *_node);
+		writeNode(node->expression());
+	}
+	else if (dynamic_cast<Throw const*>(_node))
+		begin(ThrowNode, *_node);
+	else if (auto node = dynamic_cast<VariableDeclarationStatement const*>(_node))
+	{
+		begin(VariableDeclarationStatementNode, *_node);
+		writeNodes(node->declarations());
+		writeNode(node->initialValue());
+	}
+	else if (auto node = dynamic_cast<ExpressionStatement const*>(_node))
+	{
+		begin(ExpressionStatementNode, *_node);
+		writeNode(&node->expression());
+	}
+	else if (auto node = dynamic_cast<Assignment const*>(_node))
+	{
+		begin(AssignmentNode, *_node);
+		writeNode(&node->leftHandSide());
+		writeEnum(int(node->assignmentOperator()));
+		writeNode(&node->rightHandSide());
+	}
+	else if (auto node = dynamic_cast<TupleExpression const*>(_node))
+	{
+		begin(TupleExpressionNode, *_node);
+		writeNodes(node->components());
+	}
+	else if (auto node = dynamic_cast<UnaryOperation const*>(_node))
+	{
+		begin(UnaryOperationNode, *_node);
+		writeEnum(int(node->getOperator()));
+		writeBool(node->isPrefixOperation());
+		writeNode(&node->subExpression());
+	}
+	else if (auto node = dynamic_cast<BinaryOperation const*>(_node))
+	{
+		begin(BinaryOperationNode, *_node);
+		writeNode(&node->leftExpression());
+		writeEnum(int(node->getOperator()));
+		writeNode(&node->rightExpression());
+	}
+	else if (auto node = dynamic_cast<FunctionCall const*>(_node))
+	{
+		begin(FunctionCallNode, *_node);
+		writeNode(&node->expression());
+		writeNodes(node->arguments());
+		appendVarint(m_stream, node->names().size());
+		for (ASTPointer<ASTString> const& name: node->names())
+			writeString(*name);
+	}
+	else if (auto node = dynamic_cast<NewExpression const*>(_node))
+	{
+		begin(NewExpressionNode, *_node);
+		writeNode(&node->contractName());
+	}
+	else if (auto node = dynamic_cast<MemberAccess const*>(_node))
+	{
+		begin(MemberAccessNode, *_node);
+		writeNode(&node->expression());
+		writeString(node->memberName());
+	}
+	else if (auto node = dynamic_cast<IndexAccess const*>(_node))
+	{
+		begin(IndexAccessNode, *_node);
+		writeNode(&node->baseExpression());
+		writeNode(node->indexExpression());
+	}
+	else if (auto node = dynamic_cast<Identifier const*>(_node))
+	{
+		begin(IdentifierNode, *_node);
+		writeString(node->name());
+	}
+	else if (auto node = dynamic_cast<ElementaryTypeNameExpression const*>(_node))
+	{
+		begin(ElementaryTypeNameExpressionNode, *_node);
+		writeEnum(int(node->typeToken()));
+	}
+	else if (auto node = dynamic_cast<Literal const*>(_node))
+	{
+		begin(LiteralNode, *_node);
+		writeEnum(int(node->token()));
+		writeString(node->value());
+		writeEnum(int(node->subDenomination()));
+		writeBool(node->scannedValueKnown());
+		if (node->scannedValueKnown())
+			m_stream += toBigEndian(node->scannedValue());
+	}
+	else
+		solAssert(false, "Unknown AST node type during serialization.");
+}
+
+bytes Writer::assemble(string const& _sourceName) const
+{
+	bytes out{'s', 'o', 'l', 'b'};
+	appendVarint(out, ASTBinarySerializer::c_formatVersion);
+	appendLengthPrefixed(out, VersionString);
+	appendLengthPrefixed(out, _sourceName);
+	appendVarint(out, m_strings.size());
+	for (string const& entry: m_strings)
+		appendLengthPrefixed(out, entry);
+	out += m_stream;
+	return out;
+}
+
+/**
+ * Reconstructs the tree from a node stream. Nodes are bump-allocated into a
+ * fresh arena and identifier strings go through the global interning pool,
+ * exactly as if they had come out of the parser.
+ */
+class Reader
+{
+public:
+	explicit Reader(bytes const& _data): m_data(_data) {}
+
+	ASTPointer<SourceUnit> run();
+
+private:
+	/// Aborts on malformed input; the caller turns this into an empty result.
+	void require(bool _condition) const
+	{
+		if (!_condition)
+			BOOST_THROW_EXCEPTION(InternalCompilerError() << errinfo_comment("Corrupt binary AST stream."));
+	}
+	byte readByte()
+	{
+		require(m_position < m_data.size());
+		return m_data[m_position++];
+	}
+	size_t readVarint()
+	{
+		size_t value = 0;
+		unsigned shift = 0;
+		while (true)
+		{
+			byte part = readByte();
+			require(shift < 8 * sizeof(size_t));
+			value |= size_t(part & 0x7f) << shift;
+			if (!(part & 0x80))
+				return value;
+			shift += 7;
+		}
+	}
+	string readLengthPrefixed()
+	{
+		size_t length = readVarint();
+		require(m_position + length <= m_data.size());
+		string result(m_data.begin() + m_position, m_data.begin() + m_position + length);
+		m_position += length;
+		return result;
+	}
+	bool readBool() { return readByte() != 0; }
+	int readEnum() { return int(readVarint()); }
+	SourceLocation readLocation()
+	{
+		int start = int(readVarint()) - 1;
+		int end = int(readVarint()) - 1;
+		return SourceLocation(start, end, m_sourceName);
+	}
+	ASTPointer<ASTString> readString()
+	{
+		size_t index = readVarint();
+		require(index < m_strings.size());
+		return m_strings[index];
+	}
+	ASTPointer<ASTString> readOptionalString()
+	{
+		size_t index = readVarint();
+		if (index == 0)
+			return ASTPointer<ASTString>();
+		require(index - 1 < m_strings.size());
+		return m_strings[index - 1];
+	}
+	ASTPointer<ASTNode> readNode();
+	template <class T>
+	ASTPointer<T> readNodeAs()
+	{
+		ASTPointer<ASTNode> node = readNode();
+		if (!node)
+			return ASTPointer<T>();
+		ASTPointer<T> typed = dynamic_pointer_cast<T>(node);
+		require(!!typed);
+		return typed;
+	}
+	template <class T>
+	vector<ASTPointer<T>> readNodes()
+	{
+		vector<ASTPointer<T>> nodes(readVarint());
+		for (ASTPointer<T>& node: nodes)
+			node = readNodeAs<T>();
+		return nodes;
+	}
+	/// Mirrors the parser's node factory: placement-allocates the node into
+	/// the arena and routes later annotations there as well.
+	template <class NodeType, typename... Args>
+	ASTPointer<NodeType> createNode(SourceLocation const& _location, Args&& ... _args)
+	{
+		ASTPointer<NodeType> node = allocate_shared<NodeType>(
+			ASTArenaAllocator<NodeType>(m_arena),
+			_location,
+			forward<Args>(_args)...
+		);
+		node->setAnnotationArena(m_arena.get());
+		return node;
+	}
+
+	bytes const& m_data;
+	size_t m_position = 0;
+	std::shared_ptr<ASTArena> m_arena;
+	std::shared_ptr<string const> m_sourceName;
+	vector<ASTPointer<ASTString>> m_strings;
+};
+
+ASTPointer<SourceUnit> Reader::run()
+{
+	require(m_data.size() >= 4 && m_data[0] == 's' && m_data[1] == 'o' && m_data[2] == 'l' && m_data[3] == 'b');
+	m_position = 4;
+	if (readVarint() != ASTBinarySerializer::c_formatVersion)
+		return ASTPointer<SourceUnit>();
+	if (readLengthPrefixed() != VersionString)
+		return ASTPointer<SourceUnit>();
+	m_sourceName = make_shared<string const>(readLengthPrefixed());
+	m_arena = make_shared<ASTArena>();
+	size_t stringCount = readVarint();
+	m_strings.reserve(stringCount);
+	for (size_t i = 0; i < stringCount; ++i)
+		m_strings.push_back(ASTStringPool::global().intern(readLengthPrefixed()));
+	ASTPointer<SourceUnit> sourceUnit = readNodeAs<SourceUnit>();
+	require(!!sourceUnit && m_position == m_data.size());
+	sourceUnit->setArena(m_arena);
+	return sourceUnit;
+}
+
+ASTPointer<ASTNode> Reader::readNode()
+{
+	size_t kind = readVarint();
+	if (kind == NullNode)
+		return ASTPointer<ASTNode>();
+	SourceLocation location = readLocation();
+	// Children are read into named locals first - constructor arguments do
+	// not have a guaranteed evaluation order.
+	switch (kind)
+	{
+	case SourceUnitNode:
+	{
+		vector<ASTPointer<ASTNode>> nodes = readNodes<ASTNode>();
+		return createNode<SourceUnit>(location, nodes);
+	}
+	case ImportDirectiveNode:
+		return createNode<ImportDirective>(location, readString());
+	case ContractDefinitionNode:
+	{
+		ASTPointer<ASTString> name = readString();
+		ASTPointer<ASTString> documentation = readOptionalString();
+		vector<ASTPointer<InheritanceSpecifier>> baseContracts = readNodes<InheritanceSpecifier>();
+		vector<ASTPointer<StructDefinition>> structs = readNodes<StructDefinition>();
+		vector<ASTPointer<EnumDefinition>> enums = readNodes<EnumDefinition>();
+		vector<ASTPointer<VariableDeclaration>> stateVariables = readNodes<VariableDeclaration>();
+		vector<ASTPointer<FunctionDefinition>> functions = readNodes<FunctionDefinition>();
+		vector<ASTPointer<ModifierDefinition>> modifiers = readNodes<ModifierDefinition>();
+		vector<ASTPointer<EventDefinition>> events = readNodes<EventDefinition>();
+		bool isLibrary = readBool();
+		return createNode<ContractDefinition>(
+			location,
+			name,
+			documentation,
+			baseContracts,
+			structs,
+			enums,
+			stateVariables,
+			functions,
+			modifiers,
+			events,
+			isLibrary
+		);
+	}
+	case InheritanceSpecifierNode:
+	{
+		ASTPointer<Identifier> name = readNodeAs<Identifier>();
+		vector<ASTPointer<Expression>> arguments = readNodes<Expression>();
+		return createNode<InheritanceSpecifier>(location, name, arguments);
+	}
+	case StructDefinitionNode:
+	{
+		ASTPointer<ASTString> name = readString();
+		vector<ASTPointer<VariableDeclaration>> members = readNodes<VariableDeclaration>();
+		return createNode<StructDefinition>(location, name, members);
+	}
+	case EnumDefinitionNode:
+	{
+		ASTPointer<ASTString> name = readString();
+		vector<ASTPointer<EnumValue>> members = readNodes<EnumValue>();
+		return createNode<EnumDefinition>(location, name, members);
+	}
+	case EnumValueNode:
+		return createNode<EnumValue>(location, readString());
+	case ParameterListNode:
+	{
+		vector<ASTPointer<VariableDeclaration>> parameters = readNodes<VariableDeclaration>();
+		return createNode<ParameterList>(location, parameters);
+	}
+	case FunctionDefinitionNode:
+	{
+		ASTPointer<ASTString> name = readString();
+		Declaration::Visibility visibility = Declaration::Visibility(readEnum());
+		bool isConstructor = readBool();
+		ASTPointer<ASTString> documentation = readOptionalString();
+		ASTPointer<ParameterList> parameters = readNodeAs<ParameterList>();
+		bool isDeclaredConst = readBool();
+		vector<ASTPointer<ModifierInvocation>> modifiers = readNodes<ModifierInvocation>();
+		ASTPointer<ParameterList> returnParameters = readNodeAs<ParameterList>();
+		ASTPointer<Block> body = readNodeAs<Block>();
+		return createNode<FunctionDefinition>(
+			location,
+			name,
+			visibility,
+			isConstructor,
+			documentation,
+			parameters,
+			isDeclaredConst,
+			modifiers,
+			returnParameters,
+			body
+		);
+	}
+	case VariableDeclarationNode:
+	{
+		ASTPointer<TypeName> typeName = readNodeAs<TypeName>();
+		ASTPointer<ASTString> name = readString();
+		ASTPointer<Expression> value = readNodeAs<Expression>();
+		Declaration::Visibility visibility = Declaration::Visibility(readEnum());
+		bool isStateVariable = readBool();
+		bool isIndexed = readBool();
+		bool isConstant = readBool();
+		VariableDeclaration::Location referenceLocation = VariableDeclaration::Location(readEnum());
+		return createNode<VariableDeclaration>(
+			location,
+			typeName,
+			name,
+			value,
+			visibility,
+			isStateVariable,
+			isIndexed,
+			isConstant,
+			referenceLocation
+		);
+	}
+	case ModifierDefinitionNode:
+	{
+		ASTPointer<ASTString> name = readString();
+		ASTPointer<ASTString> documentation = readOptionalString();
+		ASTPointer<ParameterList> parameters = readNodeAs<ParameterList>();
+		ASTPointer<Block> body = readNodeAs<Block>();
+		return createNode<ModifierDefinition>(location, name, documentation, parameters, body);
+	}
+	case ModifierInvocationNode:
+	{
+		ASTPointer<Identifier> name = readNodeAs<Identifier>();
+		vector<ASTPointer<Expression>> arguments = readNodes<Expression>();
+		return createNode<ModifierInvocation>(location, name, arguments);
+	}
+	case EventDefinitionNode:
+	{
+		ASTPointer<ASTString> name = readString();
+		ASTPointer<ASTString> documentation = readOptionalString();
+		ASTPointer<ParameterList> parameters = readNodeAs<ParameterList>();
+		bool anonymous = readBool();
+		return createNode<EventDefinition>(location, name, documentation, parameters, anonymous);
+	}
+	case ElementaryTypeNameNode:
+		return createNode<ElementaryTypeName>(location, Token::Value(readEnum()));
+	case UserDefinedTypeNameNode:
+	{
+		vector<ASTString> namePath(readVarint());
+		for (ASTString& part: namePath)
+			part = *readString();
+		return createNode<UserDefinedTypeName>(location, namePath);
+	}
+	case MappingNode:
+	{
+		ASTPointer<ElementaryTypeName> keyType = readNodeAs<ElementaryTypeName>();
+		ASTPointer<TypeName> valueType = readNodeAs<TypeName>();
+		return createNode<Mapping>(location, keyType, valueType);
+	}
+	case ArrayTypeNameNode:
+	{
+		ASTPointer<TypeName> baseType = readNodeAs<TypeName>();
+		ASTPointer<Expression> length = readNodeAs<Expression>();
+		return createNode<ArrayTypeName>(location, baseType, length);
+	}
+	case BlockNode:
+	{
+		vector<ASTPointer<Statement>> statements = readNodes<Statement>();
+		return createNode<Block>(location, statements);
+	}
+	case PlaceholderStatementNode:
+		return createNode<PlaceholderStatement>(location);
+	case IfStatementNode:
+	{
+		ASTPointer<Expression> condition = readNodeAs<Expression>();
+		ASTPointer<Statement> trueBody = readNodeAs<Statement>();
+		ASTPointer<Statement> falseBody = readNodeAs<Statement>();
+		return createNode<IfStatement>(location, condition, trueBody, falseBody);
+	}
+	case WhileStatementNode:
+	{
+		ASTPointer<Expression> condition = readNodeAs<Expression>();
+		ASTPointer<Statement> body = readNodeAs<Statement>();
+		return createNode<WhileStatement>(location, condition, body);
+	}
+	case ForStatementNode:
+	{
+		ASTPointer<Statement> initExpression = readNodeAs<Statement>();
+		ASTPointer<Expression> condition = readNodeAs<Expression>();
+		ASTPointer<ExpressionStatement> loopExpression = readNodeAs<ExpressionStatement>();
+		ASTPointer<Statement> body = readNodeAs<Statement>();
+		return createNode<ForStatement>(location, initExpression, condition, loopExpression, body);
+	}
+	case ContinueNode:
+		return createNode<Continue>(location);
+	case BreakNode:
+		return createNode<Break>(location);
+	case ReturnNode:
+		return createNode<Return>(location, readNodeAs<Expression>());
+	case ThrowNode:
+		return createNode<Throw>(location);
+	case VariableDeclarationStatementNode:
+	{
+		vector<ASTPointer<VariableDeclaration>> variables = readNodes<VariableDeclaration>();
+		ASTPointer<Expression> initialValue = readNodeAs<Expression>();
+		return createNode<VariableDeclarationStatement>(location, variables, initialValue);
+	}
+	case ExpressionStatementNode:
+		return createNode<ExpressionStatement>(location, readNodeAs<Expression>());
+	case AssignmentNode:
+	{
+		ASTPointer<Expression> leftHandSide = readNodeAs<Expression>();
+		Token::Value assignmentOperator = Token::Value(readEnum());
+		ASTPointer<Expression> rightHandSide = readNodeAs<Expression>();
+		return createNode<Assignment>(location, leftHandSide, assignmentOperator, rightHandSide);
+	}
+	case TupleExpressionNode:
+	{
+		vector<ASTPointer<Expression>> components = readNodes<Expression>();
+		return createNode<TupleExpression>(location, components);
+	}
+	case UnaryOperationNode:
+	{
+		Token::Value op = Token::Value(readEnum());
+		bool isPrefix = readBool();
+		ASTPointer<Expression> subExpression = readNodeAs<Expression>();
+		return createNode<UnaryOperation>(location, op, subExpression, isPrefix);
+	}
+	case BinaryOperationNode:
+	{
+		ASTPointer<Expression> left = readNodeAs<Expression>();
+		Token::Value op = Token::Value(readEnum());
+		ASTPointer<Expression> right = readNodeAs<Expression>();
+		return createNode<BinaryOperation>(location, left, op, right);
+	}
+	case FunctionCallNode:
+	{
+		ASTPointer<Expression> expression = readNodeAs<Expression>();
+		vector<ASTPointer<Expression>> arguments = readNodes<Expression>();
+		vector<ASTPointer<ASTString>> names(readVarint());
+		for (ASTPointer<ASTString>& name: names)
+			name = readString();
+		return createNode<FunctionCall>(location, expression, arguments, names);
+	}
+	case NewExpressionNode:
+		return createNode<NewExpression>(location, readNodeAs<Identifier>());
+	case MemberAccessNode:
+	{
+		ASTPointer<Expression> expression = readNodeAs<Expression>();
+		ASTPointer<ASTString> memberName = readString();
+		return createNode<MemberAccess>(location, expression, memberName);
+	}
+	case IndexAccessNode:
+	{
+		ASTPointer<Expression> base = readNodeAs<Expression>();
+		ASTPointer<Expression> index = readNodeAs<Expression>();
+		return createNode<IndexAccess>(location, base, index);
+	}
+	case IdentifierNode:
+		return createNode<Identifier>(location, readString());
+	case ElementaryTypeNameExpressionNode:
+		return createNode<ElementaryTypeNameExpression>(location, Token::Value(readEnum()));
+	case LiteralNode:
+	{
+		Token::Value token = Token::Value(readEnum());
+		ASTPointer<ASTString> value = readString();
+		Literal::SubDenomination subDenomination = Literal::SubDenomination(readEnum());
+		ASTPointer<Literal> literal = createNode<Literal>(location, token, value, subDenomination);
+		if (readBool())
+		{
+			require(m_position + 32 <= m_data.size());
+			literal->setScannedValue(fromBigEndian<u256>(bytesConstRef(m_data.data() + m_position, 32)));
+			m_position += 32;
+		}
+		return literal;
+	}
+	default:
+		require(false);
+	}
+	return ASTPointer<ASTNode>();
+}
+
+}
+
+bytes ASTBinarySerializer::serialize(SourceUnit const& _sourceUnit)
+{
+	Writer writer;
+	writer.writeNode(&_sourceUnit);
+	return writer.assemble(_sourceUnit.location().sourceName ? *_sourceUnit.location().sourceName : string());
+}
+
+ASTPointer<SourceUnit> ASTBinarySerializer::deserialize(bytes const& _data)
+{
+	try
+	{
+		return Reader(_data).run();
+	}
+	catch (Exception const&)
+	{
+		return ASTPointer<SourceUnit>();
+	}
+}
+
+}
+}
@@ -0,0 +1,57 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Compact binary serialization of the AST with a fast load path.
+ */
+
+#pragma once
+
+#include <libdevcore/Common.h>
+#include <libsolidity/ASTForward.h>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Serializes a parsed source unit into a compact, string-table based binary
+ * format and reconstructs it again without re-running the Scanner or Parser.
+ * The stream carries the compiler version string and a format version; loading
+ * rejects streams written by a different compiler or format revision.
+ * Only the syntactic structure is stored: annotations reference pooled types
+ * and declarations of other source units and are therefore rebuilt by the
+ * normal analysis passes (NameAndTypeResolver, TypeChecker) after loading.
+ */
+class ASTBinarySerializer
+{
+public:
+	/// Revision of the binary layout, bumped whenever the format changes.
+	static unsigned const c_formatVersion = 1;
+
+	/// @returns the binary encoding of @a _sourceUnit.
+	static bytes serialize(SourceUnit const& _sourceUnit);
+	/// Reconstructs a source unit from @a _data. Nodes are bump-allocated into
+	/// a fresh arena just like nodes created by the parser.
+	/// @returns an empty pointer if the stream is corrupt or was written by a
+	/// different compiler or format version.
+	static ASTPointer<SourceUnit> deserialize(bytes const& _data);
+};
+
+}
+}
@@ -31,30 +31,66 @@ namespace dev
 namespace solidity
 {
 
+namespace
+{
+
+/// Attribute keys whose values are emitted as JSON booleans instead of strings.
+bool isBooleanKey(string const& _key)
+{
+	return _key == "const" || _key == "public" || _key == "local" ||
+		_key == "lvalue" || _key == "local_lvalue" || _key == "prefix";
+}
+
+}
+
 void ASTJsonConverter::addKeyValue(Json::Value& _obj, string const& _key, string const& _val)
 {
 	// special handling for booleans
-	if (_key == "const" || _key == "public" || _key == "local" ||
-		_key == "lvalue" || _key == "local_lvalue" || _key == "prefix")
+	if (isBooleanKey(_key))
 		_obj[_key] = (_val == "1") ? true : false;
-	else
-		// else simply add it as a string
+	else if (!_val.empty())
+		// else simply add it as a string, dropping empty values
 		_obj[_key] = _val;
 }
 
-void ASTJsonConverter::addJsonNode(string const& _nodeName,
+string ASTJsonConverter::sourceLocation(ASTNode const& _node) const
+{
+	SourceLocation const& location = _node.location();
+	int sourceIndex = -1;
+	if (location.sourceName)
+	{
+		auto it = m_sourceIndices.find(*location.sourceName);
+		if (it != m_sourceIndices.end())
+			sourceIndex = it->second;
+	}
+	return
+		to_string(location.start) + ":" +
+		to_string(location.end - location.start) + ":" +
+		to_string(sourceIndex);
+}
+
+void ASTJsonConverter::addJsonNode(ASTNode const& _node,
+								   string const& _nodeName,
 								   initializer_list<pair<string const, string const>> _list,
 								   bool _hasChildren = false)
 {
+	if (m_stream)
+	{
+		streamJsonNode(_node, _nodeName, _list, _hasChildren);
+		return;
+	}
+
 	Json::Value node;
 
 	node["name"] = _nodeName;
+	node["src"] = sourceLocation(_node);
 	if (_list.size() != 0)
 	{
 		Json::Value attrs;
 		for (auto& e: _list)
 			addKeyValue(attrs, e.first, e.second);
-		node["attributes"] = attrs;
+		if (!attrs.isNull())
+			node["attributes"] = attrs;
 	}
 
 	m_jsonNodePtrs.top()->append(node);
@@ -68,19 +104,95 @@ void ASTJsonConverter::addJsonNode(string const& _nodeName,
 	}
 }
 
-ASTJsonConverter::ASTJsonConverter(ASTNode const& _ast): m_ast(&_ast)
+void ASTJsonConverter::streamJsonNode(ASTNode const& _node,
+									  string const& _nodeName,
+									  initializer_list<pair<string const, string const>> _list,
+									  bool _hasChildren)
+{
+	solAssert(!m_hasElement.empty(), "Uneven json nodes stack. Internal error.");
+	ostream& out = *m_stream;
+	if (m_hasElement.back())
+		out << ",";
+	m_hasElement.back() = true;
+	out << "\n" << string(m_hasElement.size(), '\t');
+	out << "{\"name\": " << Json::valueToQuotedString(_nodeName.c_str());
+	out << ", \"src\": \"" << sourceLocation(_node) << "\"";
+	if (_list.size() != 0)
+	{
+		bool first = true;
+		for (auto& e: _list)
+		{
+			// empty non-boolean attributes are dropped
+			if (!isBooleanKey(e.first) && e.second.empty())
+				continue;
+			out << (first ? ", \"attributes\": {" : ", ");
+			first = false;
+			out << Json::valueToQuotedString(e.first.c_str()) << ": ";
+			if (isBooleanKey(e.first))
+				out << ((e.second == "1") ? "true" : "false");
+			else
+				out << Json::valueToQuotedString(e.second.c_str());
+		}
+		if (!first)
+			out << "}";
+	}
+	if (_hasChildren)
+	{
+		out << ", \"children\": [";
+		m_hasElement.push_back(false);
+	}
+	else
+		out << "}";
+}
+
+void ASTJsonConverter::goUp()
+{
+	if (m_stream)
+	{
+		solAssert(!m_hasElement.empty(), "Uneven json nodes stack. Internal error.");
+		*m_stream << "\n" << string(m_hasElement.size() - 1, '\t') << "]}";
+		m_hasElement.pop_back();
+		return;
+	}
+	solAssert(!m_jsonNodePtrs.empty(), "Uneven json nodes stack. Internal error.");
+	m_jsonNodePtrs.pop();
+}
+
+ASTJsonConverter::ASTJsonConverter(ASTNode const& _ast, vector<string> const& _sourceList):
+	m_sourceList(_sourceList), m_ast(&_ast)
 {
+	for (size_t i = 0; i < m_sourceList.size(); ++i)
+		m_sourceIndices[m_sourceList[i]] = int(i);
+
 	Json::Value children(Json::arrayValue);
+	Json::Value sourceList(Json::arrayValue);
+	for (string const& source: m_sourceList)
+		sourceList.append(source);
 
 	m_astJson["name"] = "root";
+	m_astJson["sourceList"] = sourceList;
 	m_astJson["children"] = children;
 	m_jsonNodePtrs.push(&m_astJson["children"]);
 }
 
 void ASTJsonConverter::print(ostream& _stream)
 {
-	process();
-	_stream << m_astJson;
+	if (processed)
+	{
+		// The tree was already materialised for json() - just write it out.
+		_stream << m_astJson;
+		return;
+	}
+	m_stream = &_stream;
+	m_hasElement.push_back(false);
+	_stream << "{\n\t\"name\": \"root\",\n\t\"sourceList\": [";
+	for (size_t i = 0; i < m_sourceList.size(); ++i)
+		_stream << (i > 0 ? ", " : "") << Json::valueToQuotedString(m_sourceList[i].c_str());
+	_stream << "],\n\t\"children\": [";
+	m_ast->accept(*this);
+	_stream << "\n\t]\n}\n";
+	m_hasElement.pop_back();
+	m_stream = nullptr;
 }
 
 Json::Value const& ASTJsonConverter::json()
@@ -91,31 +203,31 @@ Json::Value const& ASTJsonConverter::json()
 
 bool ASTJsonConverter::visit(ImportDirective const& _node)
 {
-	addJsonNode("Import", { make_pair("file", _node.identifier())});
+	addJsonNode(_node, "Import", { make_pair("file", _node.identifier())});
 	return true;
 }
 
 bool ASTJsonConverter::visit(ContractDefinition const& _node)
 {
-	addJsonNode("Contract", { make_pair("name", _node.name()) }, true);
+	addJsonNode(_node, "Contract", { make_pair("name", _node.name()) }, true);
 	return true;
 }
 
 bool ASTJsonConverter::visit(StructDefinition const& _node)
 {
-	addJsonNode("Struct", { make_pair("name", _node.name()) }, true);
+	addJsonNode(_node, "Struct", { make_pair("name", _node.name()) }, true);
 	return true;
 }
 
-bool ASTJsonConverter::visit(ParameterList const&)
+bool ASTJsonConverter::visit(ParameterList const& _node)
 {
-	addJsonNode("ParameterList", {}, true);
+	addJsonNode(_node, "ParameterList", {}, true);
 	return true;
 }
 
 bool ASTJsonConverter::visit(FunctionDefinition const& _node)
 {
-	addJsonNode("Function",
+	addJsonNode(_node, "Function",
 				{ make_pair("name", _node.name()),
 					make_pair("public", boost::lexical_cast<std::string>(_node.isPublic())),
 					make_pair("const", boost::lexical_cast<std::string>(_node.isDeclaredConst())) },
@@ -125,7 +237,7 @@ bool ASTJsonConverter::visit(FunctionDefinition const& _node)
 
 bool ASTJsonConverter::visit(VariableDeclaration const& _node)
 {
-	addJsonNode("VariableDeclaration", {
+	addJsonNode(_node, "VariableDeclaration", {
 		make_pair("name", _node.name()),
 		make_pair("name", _node.name()),
 	}, true);
@@ -139,102 +251,102 @@ bool ASTJsonConverter::visit(TypeName const&)
 
 bool ASTJsonConverter::visit(ElementaryTypeName const& _node)
 {
-	addJsonNode("ElementaryTypeName", { make_pair("name", Token::toString(_node.typeName())) });
+	addJsonNode(_node, "ElementaryTypeName", { make_pair("name", Token::toString(_node.typeName())) });
 	return true;
 }
 
 bool ASTJsonConverter::visit(UserDefinedTypeName const& _node)
 {
-	addJsonNode("UserDefinedTypeName", {
+	addJsonNode(_node, "UserDefinedTypeName", {
 		make_pair("name", boost::algorithm::join(_node.namePath(), "."))
 	});
 	return true;
 }
 
-bool ASTJsonConverter::visit(Mapping const&)
+bool ASTJsonConverter::visit(Mapping const& _node)
 {
-	addJsonNode("Mapping", {}, true);
+	addJsonNode(_node, "Mapping", {}, true);
 	return true;
 }
 
-bool ASTJsonConverter::visit(Block const&)
+bool ASTJsonConverter::visit(Block const& _node)
 {
-	addJsonNode("Block", {}, true);
+	addJsonNode(_node, "Block", {}, true);
 	return true;
 }
 
-bool ASTJsonConverter::visit(IfStatement const&)
+bool ASTJsonConverter::visit(IfStatement const& _node)
 {
-	addJsonNode("IfStatement", {}, true);
+	addJsonNode(_node, "IfStatement", {}, true);
 	return true;
 }
 
-bool ASTJsonConverter::visit(WhileStatement const&)
+bool ASTJsonConverter::visit(WhileStatement const& _node)
 {
-	addJsonNode("WhileStatement", {}, true);
+	addJsonNode(_node, "WhileStatement", {}, true);
 	return true;
 }
 
-bool ASTJsonConverter::visit(ForStatement const&)
+bool ASTJsonConverter::visit(ForStatement const& _node)
 {
-	addJsonNode("ForStatement", {}, true);
+	addJsonNode(_node, "ForStatement", {}, true);
 	return true;
 }
 
-bool ASTJsonConverter::visit(Continue const&)
+bool ASTJsonConverter::visit(Continue const& _node)
 {
-	addJsonNode("Continue", {});
+	addJsonNode(_node, "Continue", {});
 	return true;
 }
 
-bool ASTJsonConverter::visit(Break const&)
+bool ASTJsonConverter::visit(Break const& _node)
 {
-	addJsonNode("Break", {});
+	addJsonNode(_node, "Break", {});
 	return true;
 }
 
-bool ASTJsonConverter::visit(Return const&)
+bool ASTJsonConverter::visit(Return const& _node)
 {
-	addJsonNode("Return", {}, true);;
+	addJsonNode(_node, "Return", {}, true);;
 	return true;
 }
 
-bool ASTJsonConverter::visit(Throw const&)
+bool ASTJsonConverter::visit(Throw const& _node)
 {
-	addJsonNode("Throw", {}, true);;
+	addJsonNode(_node, "Throw", {}, true);;
 	return true;
 }
 
-bool ASTJsonConverter::visit(VariableDeclarationStatement const&)
+bool ASTJsonConverter::visit(VariableDeclarationStatement const& _node)
 {
-	addJsonNode("VariableDefinition", {}, true);
+	addJsonNode(_node, "VariableDefinition", {}, true);
 	return true;
 }
 
-bool ASTJsonConverter::visit(ExpressionStatement const&)
+bool ASTJsonConverter::visit(ExpressionStatement const& _node)
 {
-	addJsonNode("ExpressionStatement", {}, true);
+	addJsonNode(_node, "ExpressionStatement", {}, true);
 	return true;
 }
 
 bool ASTJsonConverter::visit(Assignment const& _node)
 {
-	addJsonNode("Assignment",
+	addJsonNode(_node, "Assignment",
 				{ make_pair("operator", Token::toString(_node.assignmentOperator())),
 					make_pair("type", type(_node)) },
 				true);
 	return true;
 }
 
-bool ASTJsonConverter::visit(TupleExpression const&)
+bool ASTJsonConverter::visit(TupleExpression const& _node)
 {
-	addJsonNode("TupleExpression",{}, true);
+	addJsonNode(_node, "TupleExpression",{}, true);
 	return true;
 }
 
 bool ASTJsonConverter::visit(UnaryOperation const& _node)
 {
-	addJsonNode("UnaryOperation",
+	addJsonNode(_node, "UnaryOperation",
 				{ make_pair("prefix", boost::lexical_cast<std::string>(_node.isPrefixOperation())),
 					make_pair("operator", Token::toString(_node.getOperator())),
 					make_pair("type", type(_node)) },
@@ -244,7 +356,7 @@ bool ASTJsonConverter::visit(UnaryOperation const& _node)
 
 bool ASTJsonConverter::visit(BinaryOperation const& _node)
 {
-	addJsonNode("BinaryOperation", {
+	addJsonNode(_node, "BinaryOperation", {
 		make_pair("operator", Token::toString(_node.getOperator())),
 		make_pair("type", type(_node))
 	}, true);
@@ -253,7 +365,7 @@ bool ASTJsonConverter::visit(BinaryOperation const& _node)
 
 bool ASTJsonConverter::visit(FunctionCall const& _node)
 {
-	addJsonNode("FunctionCall", {
+	addJsonNode(_node, "FunctionCall", {
 		make_pair("type_conversion", boost::lexical_cast<std::string>(_node.annotation().isTypeConversion)),
 		make_pair("type", type(_node))
 	}, true);
@@ -262,13 +374,13 @@ bool ASTJsonConverter::visit(FunctionCall const& _node)
 
 bool ASTJsonConverter::visit(NewExpression const& _node)
 {
-	addJsonNode("NewExpression", { make_pair("type", type(_node)) }, true);
+	addJsonNode(_node, "NewExpression", { make_pair("type", type(_node)) }, true);
 	return true;
 }
 
 bool ASTJsonConverter::visit(MemberAccess const& _node)
 {
-	addJsonNode("MemberAccess",
+	addJsonNode(_node, "MemberAccess",
 				{ make_pair("member_name", _node.memberName()),
 					make_pair("type", type(_node)) },
 				true);
@@ -277,20 +389,20 @@ bool ASTJsonConverter::visit(MemberAccess const& _node)
 
 bool ASTJsonConverter::visit(IndexAccess const& _node)
 {
-	addJsonNode("IndexAccess", { make_pair("type", type(_node)) }, true);
+	addJsonNode(_node, "IndexAccess", { make_pair("type", type(_node)) }, true);
 	return true;
 }
 
 bool ASTJsonConverter::visit(Identifier const& _node)
 {
-	addJsonNode("Identifier",
+	addJsonNode(_node, "Identifier",
 				{ make_pair("value", _node.name()), make_pair("type", type(_node)) });
 	return true;
 }
 
 bool ASTJsonConverter::visit(ElementaryTypeNameExpression const& _node)
 {
-	addJsonNode("ElementaryTypenameExpression",
+	addJsonNode(_node, "ElementaryTypenameExpression",
 				{ make_pair("value", Token::toString(_node.typeToken())), make_pair("type", type(_node)) });
 	return true;
 }
@@ -298,7 +410,7 @@ bool ASTJsonConverter::visit(ElementaryTypeNameExpression const& _node)
 bool ASTJsonConverter::visit(Literal const& _node)
 {
 	char const* tokenString = Token::toString(_node.token());
-	addJsonNode("Literal",
+	addJsonNode(_node, "Literal",
 				{ make_pair("string", (tokenString) ? tokenString : "null"),
 					make_pair("value", _node.value()),
 					make_pair("type", type(_node)) });
@@ -22,8 +22,10 @@
 
 #pragma once
 
+#include <map>
 #include <ostream>
 #include <stack>
+#include <vector>
 #include <libsolidity/ASTVisitor.h>
 #include <libsolidity/Exceptions.h>
 #include <libsolidity/Utils.h>
@@ -41,9 +43,15 @@ namespace solidity
 class ASTJsonConverter: public ASTConstVisitor
 {
 public:
-	/// Create a converter to JSON for the given abstract syntax tree.
-	explicit ASTJsonConverter(ASTNode const& _ast);
-	/// Output the json representation of the AST to _stream.
+	/// Create a converter to JSON for the given abstract syntax tree. @a _sourceList
+	/// maps source names to the indices used in the compact "src" location attribute
+	/// and is emitted once at the root of the output.
+	explicit ASTJsonConverter(
+		ASTNode const& _ast,
+		std::vector<std::string> const& _sourceList = std::vector<std::string>()
+	);
+	/// Output the json representation of the AST to _stream. The output is written during
+	/// the AST walk itself, without materialising an intermediate Json::Value tree.
 	void print(std::ostream& _stream);
 	Json::Value const& json();
 
@@ -114,20 +122,32 @@ public:
 private:
 	void process();
 	void addKeyValue(Json::Value& _obj, std::string const& _key, std::string const& _val);
-	void addJsonNode(std::string const& _nodeName,
+	void addJsonNode(ASTNode const& _node,
+					 std::string const& _nodeName,
 					 std::initializer_list<std::pair<std::string const, std::string const>> _list,
 					 bool _hasChildren);
+	/// Writes a node directly to the output stream while print() is running.
+	void streamJsonNode(ASTNode const& _node,
+						std::string const& _nodeName,
+						std::initializer_list<std::pair<std::string const, std::string const>> _list,
+						bool _hasChildren);
+	/// @returns the location of @a _node in the compact "start:length:sourceIndex" encoding.
+	std::string sourceLocation(ASTNode const& _node) const;
 	std::string type(Expression const& _expression);
 	std::string type(VariableDeclaration const& _varDecl);
-	inline void goUp()
-	{
-		solAssert(!m_jsonNodePtrs.empty(), "Uneven json nodes stack. Internal error.");
-		m_jsonNodePtrs.pop();
-	}
+	void goUp();
 
 	bool processed = false;
 	Json::Value m_astJson;
 	std::stack<Json::Value*> m_jsonNodePtrs;
+	/// Output stream while print() is walking the AST, nullptr otherwise.
+	std::ostream* m_stream = nullptr;
+	/// One entry per open children array while streaming; true once the array
+	/// has received its first element (i.e. the next one needs a comma).
+	std::vector<bool> m_hasElement;
+	/// Source names in the order referenced by the "src" source indices.
+	std::vector<std::string> m_sourceList;
+	std::map<std::string, int> m_sourceIndices;
 	std::string m_source;
 	ASTNode const* m_ast;
 };
@@ -0,0 +1,145 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Memory accounting over ASTs: node counts and byte estimates per node kind.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <json/json.h>
+#include <libsolidity/AST.h>
+#include <libsolidity/ASTVisitor.h>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Walks ASTs and accumulates node counts and memory estimates per node kind,
+ * together with the exact number of bytes the backing arenas allocated.
+ * The per-kind byte figures are static node sizes only; heap members (vectors,
+ * strings) and annotations are covered by the arena figure, which is exact.
+ */
+class ASTMemoryCounter: private ASTConstVisitor
+{
+public:
+	struct Usage
+	{
+		size_t count = 0;
+		size_t bytes = 0;
+	};
+
+	/// Adds the nodes reachable from @a _sourceUnit and the allocation of its
+	/// arena (if attached) to the totals.
+	void add(SourceUnit const& _sourceUnit)
+	{
+		_sourceUnit.accept(*this);
+		if (_sourceUnit.arena())
+			m_arenaBytes += _sourceUnit.arena()->bytesAllocated();
+	}
+
+	std::map<std::string, Usage> const& usagePerKind() const { return m_usage; }
+	size_t nodeCount() const { return m_nodeCount; }
+	/// @returns the estimated static size of all counted nodes.
+	size_t nodeBytes() const { return m_nodeBytes; }
+	/// @returns the bytes allocated by the arenas of the added source units
+	/// (nodes, annotations and their containers).
+	size_t arenaBytes() const { return m_arenaBytes; }
+
+	/// @returns the accumulated figures as a JSON object.
+	Json::Value toJson() const
+	{
+		Json::Value result(Json::objectValue);
+		result["nodeCount"] = Json::UInt(m_nodeCount);
+		result["nodeBytes"] = Json::UInt(m_nodeBytes);
+		result["arenaBytes"] = Json::UInt(m_arenaBytes);
+		Json::Value kinds(Json::objectValue);
+		for (auto const& entry: m_usage)
+		{
+			Json::Value usage(Json::objectValue);
+			usage["count"] = Json::UInt(entry.second.count);
+			usage["bytes"] = Json::UInt(entry.second.bytes);
+			kinds[entry.first] = usage;
+		}
+		result["nodesPerKind"] = kinds;
+		return result;
+	}
+
+private:
+	template <class NodeType>
+	bool record(char const* _kind)
+	{
+		Usage& usage = m_usage[_kind];
+		usage.count++;
+		usage.bytes += sizeof(NodeType);
+		m_nodeCount++;
+		m_nodeBytes += sizeof(NodeType);
+		return true;
+	}
+
+	virtual bool visit(SourceUnit const&) override { return record<SourceUnit>("SourceUnit"); }
+	virtual bool visit(ImportDirective const&) override { return record<ImportDirective>("ImportDirective"); }
+	virtual bool visit(ContractDefinition const&) override { return record<ContractDefinition>("ContractDefinition"); }
+	virtual bool visit(InheritanceSpecifier const&) override { return record<InheritanceSpecifier>("InheritanceSpecifier"); }
+	virtual bool visit(StructDefinition const&) override { return record<StructDefinition>("StructDefinition"); }
+	virtual bool visit(EnumDefinition const&) override { return record<EnumDefinition>("EnumDefinition"); }
+	virtual bool visit(EnumValue const&) override { return record<EnumValue>("EnumValue"); }
+	virtual bool visit(ParameterList const&) override { return record<ParameterList>("ParameterList"); }
+	virtual bool visit(FunctionDefinition const&) override { return record<FunctionDefinition>("FunctionDefinition"); }
+	virtual bool visit(VariableDeclaration const&) override { return record<VariableDeclaration>("VariableDeclaration"); }
+	virtual bool visit(ModifierDefinition const&) override { return record<ModifierDefinition>("ModifierDefinition"); }
+	virtual bool visit(ModifierInvocation const&) override { return record<ModifierInvocation>("ModifierInvocation"); }
+	virtual bool visit(EventDefinition const&) override { return record<EventDefinition>("EventDefinition"); }
+	virtual bool visit(ElementaryTypeName const&) override { return record<ElementaryTypeName>("ElementaryTypeName"); }
+	virtual bool visit(UserDefinedTypeName const&) override { return record<UserDefinedTypeName>("UserDefinedTypeName"); }
+	virtual bool visit(Mapping const&) override { return record<Mapping>("Mapping"); }
+	virtual bool visit(ArrayTypeName const&) override { return record<ArrayTypeName>("ArrayTypeName"); }
+	virtual bool visit(Block const&) override { return record<Block>("Block"); }
+	virtual bool visit(PlaceholderStatement const&) override { return record<PlaceholderStatement>("PlaceholderStatement"); }
+	virtual bool visit(IfStatement const&) override { return record<IfStatement>("IfStatement"); }
+	virtual bool visit(WhileStatement const&) override { return record<WhileStatement>("WhileStatement"); }
+	virtual bool visit(ForStatement const&) override { return record<ForStatement>("ForStatement"); }
+	virtual bool visit(Continue const&) override { return record<Continue>("Continue"); }
+	virtual bool visit(Break const&) override { return record<Break>("Break"); }
+	virtual bool visit(Return const&) override { return record<Return>("Return"); }
+	virtual bool visit(Throw const&) override { return record<Throw>("Throw"); }
+	virtual bool visit(VariableDeclarationStatement const&) override { return record<VariableDeclarationStatement>("VariableDeclarationStatement"); }
+	virtual bool visit(ExpressionStatement const&) override { return record<ExpressionStatement>("ExpressionStatement"); }
+	virtual bool visit(Assignment const&) override { return record<Assignment>("Assignment"); }
+	virtual bool visit(TupleExpression const&) override { return record<TupleExpression>("TupleExpression"); }
+	virtual bool visit(UnaryOperation const&) override { return record<UnaryOperation>("UnaryOperation"); }
+	virtual bool visit(BinaryOperation const&) override { return record<BinaryOperation>("BinaryOperation"); }
+	virtual bool visit(FunctionCall const&) override { return record<FunctionCall>("FunctionCall"); }
+	virtual bool visit(NewExpression const&) override { return record<NewExpression>("NewExpression"); }
+	virtual bool visit(MemberAccess const&) override { return record<MemberAccess>("MemberAccess"); }
+	virtual bool visit(IndexAccess const&) override { return record<IndexAccess>("IndexAccess"); }
+	virtual bool visit(Identifier const&) override { return record<Identifier>("Identifier"); }
+	virtual bool visit(ElementaryTypeNameExpression const&) override { return record<ElementaryTypeNameExpression>("ElementaryTypeNameExpression"); }
+	virtual bool visit(Literal const&) override { return record<Literal>("Literal"); }
+
+	std::map<std::string, Usage> m_usage;
+	size_t m_nodeCount = 0;
+	size_t m_nodeBytes = 0;
+	size_t m_arenaBytes = 0;
+};
+
+}
+}
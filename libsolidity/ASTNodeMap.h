@@ -0,0 +1,128 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Flat map from AST nodes to values, indexed by the dense node ID.
+ */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+#include <libsolidity/AST.h>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Map from AST nodes to values backed by a flat vector indexed by ASTNode::id().
+ * Node IDs of one parse are contiguous, so lookups are O(1) array accesses and
+ * iteration is cache-linear, in contrast to a pointer-keyed std::map. The vector
+ * is offset by the smallest ID inserted so far, which keeps it small even though
+ * the IDs themselves grow over the lifetime of the process.
+ */
+template <class Value>
+class ASTNodeMap
+{
+public:
+	using Entry = std::pair<ASTNode const*, Value>;
+
+	/// @returns the value for @a _node, inserting a default-constructed one if not present.
+	Value& operator[](ASTNode const* _node)
+	{
+		Entry& entry = slotFor(_node->id());
+		entry.first = _node;
+		return entry.second;
+	}
+
+	size_t count(ASTNode const* _node) const
+	{
+		size_t id = _node->id();
+		return id >= m_base && id - m_base < m_entries.size() && m_entries[id - m_base].first ? 1 : 0;
+	}
+
+	Value const& at(ASTNode const* _node) const
+	{
+		solAssert(count(_node), "Node not present in map.");
+		return m_entries[_node->id() - m_base].second;
+	}
+
+	/// Removes @a _node from the map; its slot stays allocated but empty.
+	void erase(ASTNode const* _node)
+	{
+		if (count(_node))
+			m_entries[_node->id() - m_base] = Entry(nullptr, Value());
+	}
+
+	/// Forward iterator over the present entries, skipping empty slots.
+	class const_iterator
+	{
+	public:
+		const_iterator(
+			typename std::vector<Entry>::const_iterator _position,
+			typename std::vector<Entry>::const_iterator _end
+		): m_position(_position), m_end(_end)
+		{
+			skipEmptySlots();
+		}
+
+		Entry const& operator*() const { return *m_position; }
+		Entry const* operator->() const { return &*m_position; }
+		const_iterator& operator++() { ++m_position; skipEmptySlots(); return *this; }
+		bool operator==(const_iterator const& _other) const { return m_position == _other.m_position; }
+		bool operator!=(const_iterator const& _other) const { return !operator==(_other); }
+
+	private:
+		void skipEmptySlots()
+		{
+			while (m_position != m_end && !m_position->first)
+				++m_position;
+		}
+
+		typename std::vector<Entry>::const_iterator m_position;
+		typename std::vector<Entry>::const_iterator m_end;
+	};
+
+	const_iterator begin() const { return const_iterator(m_entries.begin(), m_entries.end()); }
+	const_iterator end() const { return const_iterator(m_entries.end(), m_entries.end()); }
+	const_iterator cbegin() const { return begin(); }
+	const_iterator cend() const { return end(); }
+
+private:
+	Entry& slotFor(size_t _id)
+	{
+		if (m_entries.empty())
+			m_base = _id;
+		else if (_id < m_base)
+		{
+			m_entries.insert(m_entries.begin(), m_base - _id, Entry(nullptr, Value()));
+			m_base = _id;
+		}
+		if (_id - m_base >= m_entries.size())
+			m_entries.resize(_id - m_base + 1);
+		return m_entries[_id - m_base];
+	}
+
+	/// Smallest node ID inserted so far; index of a node is id() - m_base.
+	size_t m_base = 0;
+	std::vector<Entry> m_entries;
+};
+
+}
+}
@@ -0,0 +1,93 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * CRTP-based AST visitor with static dispatch of visit calls.
+ */
+
+#pragma once
+
+#include <libsolidity/ASTVisitor.h>
+#include <libsolidity/ASTTraversal.h>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Statically dispatched alternative to ASTConstVisitor for passes that are
+ * fully known at compile time. Handlers are resolved against the derived
+ * class via CRTP, so visit()/endVisit() bodies are non-virtual and can be
+ * inlined; only the single type-discovery hop through ASTNode::accept()
+ * remains virtual (instead of two virtual dispatches per event with
+ * ASTConstVisitor).
+ *
+ * Usage: derive as `class MyPass: private ASTStaticVisitor<MyPass>`, declare
+ * `friend class ASTStaticVisitor<MyPass>;` if the handlers are private, pull
+ * in the defaults with `using ASTStaticVisitor<MyPass>::visit;` (and
+ * endVisit), shadow visit()/endVisit() for the node types of interest and
+ * start the traversal with walk().
+ */
+template <class Derived>
+class ASTStaticVisitor
+{
+public:
+	/// Traverses the subtree rooted at @a _root, calling the derived class's
+	/// visit()/endVisit() handlers with the same semantics as ASTNode::accept.
+	void walk(ASTNode const& _root)
+	{
+		Dispatcher dispatcher(derived());
+		_root.accept(dispatcher);
+	}
+
+	/// Default handlers, shadow these (or the typed overloads below) in the
+	/// derived class.
+	bool visitNode(ASTNode const&) { return true; }
+	void endVisitNode(ASTNode const&) {}
+
+#define V(NodeType) \
+	bool visit(NodeType const& _node) { return derived().visitNode(_node); } \
+	void endVisit(NodeType const& _node) { derived().endVisitNode(_node); }
+	SOLIDITY_AST_NODE_LIST(V)
+#undef V
+
+protected:
+	Derived& derived() { return static_cast<Derived&>(*this); }
+
+private:
+	/// Thin adapter plugged into ASTNode::accept. Each typed callback
+	/// forwards directly to the derived class, which resolves the handler at
+	/// compile time.
+	class Dispatcher: public ASTConstVisitor
+	{
+	public:
+		explicit Dispatcher(Derived& _visitor): m_visitor(_visitor) {}
+
+#define V(NodeType) \
+		virtual bool visit(NodeType const& _node) override { return m_visitor.visit(_node); } \
+		virtual void endVisit(NodeType const& _node) override { m_visitor.endVisit(_node); }
+		SOLIDITY_AST_NODE_LIST(V)
+#undef V
+
+	private:
+		Derived& m_visitor;
+	};
+};
+
+}
+}
@@ -0,0 +1,55 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Interning pool for identifier strings in the AST.
+ */
+
+#include <libsolidity/ASTStringPool.h>
+
+using namespace std;
+
+namespace dev
+{
+namespace solidity
+{
+
+ASTStringPool& ASTStringPool::global()
+{
+	static ASTStringPool pool;
+	return pool;
+}
+
+ASTPointer<ASTString> ASTStringPool::intern(string const& _string)
+{
+	if (_string.size() > c_maxInternedLength)
+		return make_shared<ASTString>(_string);
+	lock_guard<mutex> guard(m_mutex);
+	auto it = m_pool.find(_string);
+	if (it == m_pool.end())
+		it = m_pool.emplace(_string, make_shared<ASTString>(_string)).first;
+	return it->second;
+}
+
+size_t ASTStringPool::size() const
+{
+	lock_guard<mutex> guard(m_mutex);
+	return m_pool.size();
+}
+
+}
+}
@@ -0,0 +1,66 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Interning pool for identifier strings in the AST.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <libsolidity/ASTForward.h>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Process-wide interning pool for ASTString. Each distinct identifier is
+ * stored exactly once, so the same names occurring thousands of times across
+ * an AST share a single string object and handle comparisons can be done by
+ * pointer. Only short (identifier-like) strings are interned; long string
+ * literals would pin large amounts of memory in the pool for the lifetime of
+ * the process and are handed out as fresh copies instead.
+ */
+class ASTStringPool
+{
+public:
+	static ASTStringPool& global();
+
+	/// @returns a shared handle to an interned copy of @a _string (the same
+	/// handle for every equal string, provided it is short enough).
+	ASTPointer<ASTString> intern(std::string const& _string);
+
+	/// Precomputed hash of an interned string, usable as symbol-table key.
+	static size_t hash(std::string const& _string) { return std::hash<std::string>()(_string); }
+
+	size_t size() const;
+
+private:
+	/// Maximum length of strings that are interned.
+	static size_t const c_maxInternedLength = 64;
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<std::string, ASTPointer<ASTString>> m_pool;
+};
+
+}
+}
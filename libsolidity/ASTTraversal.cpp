@@ -0,0 +1,141 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Iterative (explicit-stack) AST traversal.
+ */
+
+#include <libsolidity/ASTTraversal.h>
+
+using namespace std;
+
+namespace dev
+{
+namespace solidity
+{
+
+namespace
+{
+
+/// Collects the direct children of one node. The parent's visit returns true
+/// so that accept() descends one level; every child's visit is recorded and
+/// returns false, cutting off deeper recursion.
+class ChildCollector: public ASTConstVisitor
+{
+public:
+	explicit ChildCollector(ASTNode const& _parent): m_parent(&_parent) {}
+
+	vector<ASTNode const*> const& children() const { return m_children; }
+
+protected:
+	virtual bool visitNode(ASTNode const& _node) override
+	{
+		if (&_node == m_parent)
+			return true;
+		m_children.push_back(&_node);
+		return false;
+	}
+
+private:
+	ASTNode const* m_parent;
+	vector<ASTNode const*> m_children;
+};
+
+/// Forwards the typed visit() calls of one node to the wrapped visitor
+/// without descending and swallows the matching endVisit().
+class PreVisitDispatcher: public ASTConstVisitor
+{
+public:
+	explicit PreVisitDispatcher(ASTConstVisitor& _visitor): m_visitor(_visitor) {}
+
+	/// @returns whether the wrapped visitor asked to descend into children.
+	bool descend() const { return m_descend; }
+
+#define V(NodeType) \
+	virtual bool visit(NodeType const& _node) override { m_descend = m_visitor.visit(_node); return false; } \
+	virtual void endVisit(NodeType const&) override {}
+	SOLIDITY_AST_NODE_LIST(V)
+#undef V
+
+private:
+	ASTConstVisitor& m_visitor;
+	bool m_descend = false;
+};
+
+/// Forwards the typed endVisit() calls of one node to the wrapped visitor and
+/// swallows the matching visit() (returning false so children are skipped).
+class PostVisitDispatcher: public ASTConstVisitor
+{
+public:
+	explicit PostVisitDispatcher(ASTConstVisitor& _visitor): m_visitor(_visitor) {}
+
+#define V(NodeType) \
+	virtual bool visit(NodeType const&) override { return false; } \
+	virtual void endVisit(NodeType const& _node) override { m_visitor.endVisit(_node); }
+	SOLIDITY_AST_NODE_LIST(V)
+#undef V
+
+private:
+	ASTConstVisitor& m_visitor;
+};
+
+}
+
+vector<ASTNode const*> collectChildren(ASTNode const& _node)
+{
+	ChildCollector collector(_node);
+	_node.accept(collector);
+	return collector.children();
+}
+
+void acceptIteratively(ASTNode const& _root, ASTConstVisitor& _visitor)
+{
+	struct WorkItem
+	{
+		ASTNode const* node;
+		bool visited;
+	};
+
+	PreVisitDispatcher pre(_visitor);
+	PostVisitDispatcher post(_visitor);
+	vector<WorkItem> stack{{&_root, false}};
+	while (!stack.empty())
+	{
+		if (!stack.back().visited)
+		{
+			stack.back().visited = true;
+			ASTNode const* node = stack.back().node;
+			node->accept(pre);
+			if (pre.descend())
+			{
+				vector<ASTNode const*> children = collectChildren(*node);
+				// Push in reverse so children are processed in document order.
+				for (auto it = children.rbegin(); it != children.rend(); ++it)
+					stack.push_back({*it, false});
+			}
+		}
+		else
+		{
+			ASTNode const* node = stack.back().node;
+			stack.pop_back();
+			node->accept(post);
+		}
+	}
+}
+
+}
+}
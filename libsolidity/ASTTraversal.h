@@ -0,0 +1,88 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Iterative (explicit-stack) AST traversal.
+ */
+
+#pragma once
+
+#include <vector>
+#include <libsolidity/ASTVisitor.h>
+
+namespace dev
+{
+namespace solidity
+{
+
+/// Invokes the macro V once for every concrete AST node type.
+#define SOLIDITY_AST_NODE_LIST(V) \
+	V(SourceUnit) \
+	V(ImportDirective) \
+	V(ContractDefinition) \
+	V(InheritanceSpecifier) \
+	V(StructDefinition) \
+	V(EnumDefinition) \
+	V(EnumValue) \
+	V(ParameterList) \
+	V(FunctionDefinition) \
+	V(VariableDeclaration) \
+	V(ModifierDefinition) \
+	V(ModifierInvocation) \
+	V(EventDefinition) \
+	V(TypeName) \
+	V(ElementaryTypeName) \
+	V(UserDefinedTypeName) \
+	V(Mapping) \
+	V(ArrayTypeName) \
+	V(Block) \
+	V(PlaceholderStatement) \
+	V(IfStatement) \
+	V(WhileStatement) \
+	V(ForStatement) \
+	V(Continue) \
+	V(Break) \
+	V(Return) \
+	V(Throw) \
+	V(VariableDeclarationStatement) \
+	V(ExpressionStatement) \
+	V(Assignment) \
+	V(TupleExpression) \
+	V(UnaryOperation) \
+	V(BinaryOperation) \
+	V(FunctionCall) \
+	V(NewExpression) \
+	V(MemberAccess) \
+	V(IndexAccess) \
+	V(Identifier) \
+	V(ElementaryTypeNameExpression) \
+	V(Literal)
+
+/// @returns the direct children of @a _node in document order. The
+/// enumeration goes through the node's own accept(), so it stays in sync
+/// with the traversal order encoded in AST_accept.h by construction.
+std::vector<ASTNode const*> collectChildren(ASTNode const& _node);
+
+/// Performs the same traversal as ASTNode::accept - visit, children in
+/// document order, endVisit - but with an explicit work stack, so passes
+/// based on ASTConstVisitor can process machine-generated sources whose
+/// expressions nest thousands of levels deep without overflowing the call
+/// stack.
+void acceptIteratively(ASTNode const& _root, ASTConstVisitor& _visitor);
+
+}
+}
@@ -44,8 +44,6 @@ void ArrayUtils::copyArrayToStorage(ArrayType const& _targetType, ArrayType cons
 	Type const* targetBaseType = _targetType.isByteArray() ? &uint256 : &(*_targetType.baseType());
 	Type const* sourceBaseType = _sourceType.isByteArray() ? &uint256 : &(*_sourceType.baseType());
 
-	// TODO unroll loop for small sizes
-
 	bool sourceIsStorage = _sourceType.location() == DataLocation::Storage;
 	bool fromCalldata = _sourceType.location() == DataLocation::CallData;
 	bool directCopy = sourceIsStorage && sourceBaseType->isValueType() && *sourceBaseType == *targetBaseType;
@@ -53,6 +51,46 @@ void ArrayUtils::copyArrayToStorage(ArrayType const& _targetType, ArrayType cons
 	bool haveByteOffsetTarget = !directCopy && targetBaseType->storageBytes() <= 16;
 	unsigned byteOffsetSize = (haveByteOffsetSource ? 1 : 0) + (haveByteOffsetTarget ? 1 : 0);
 
+	// Number of elements up to which statically-sized copies are fully unrolled
+	// instead of going through the generic loop below.
+	u256 const c_unrolledCopyLimit = 8;
+	if (
+		!_targetType.isDynamicallySized() && !_sourceType.isDynamicallySized() &&
+		_targetType.length() == _sourceType.length() &&
+		_sourceType.length() <= c_unrolledCopyLimit &&
+		sourceBaseType->isValueType() && *sourceBaseType == *targetBaseType &&
+		sourceBaseType->storageBytes() == 32 &&
+		(sourceIsStorage || _sourceType.location() == DataLocation::Memory)
+	)
+	{
+		// Each element occupies exactly one storage slot (or memory word), so the copy
+		// is a straight sequence of loads and stores without any loop machinery.
+		// stack: source_ref target_ref
+		for (u256 i = 0; i < _sourceType.length(); ++i)
+		{
+			m_context << eth::Instruction::DUP2;
+			if (sourceIsStorage)
+			{
+				if (i > 0)
+					m_context << i << eth::Instruction::ADD;
+				m_context << eth::Instruction::SLOAD;
+			}
+			else
+			{
+				if (i > 0)
+					m_context << u256(i * 32) << eth::Instruction::ADD;
+				m_context << eth::Instruction::MLOAD;
+			}
+			m_context << eth::Instruction::DUP2;
+			if (i > 0)
+				m_context << i << eth::Instruction::ADD;
+			m_context << eth::Instruction::SSTORE;
+		}
+		// stack: source_ref target_ref
+		m_context << eth::Instruction::SWAP1 << eth::Instruction::POP;
+		return;
+	}
+
 	// stack: source_ref [source_length] target_ref
 	// store target_ref
 	for (unsigned i = _sourceType.sizeOnStack(); i > 0; --i)
@@ -395,6 +433,34 @@ void ArrayUtils::copyArrayToMemory(ArrayType const& _sourceType, bool _padToWord
 		u256 storageSize = _sourceType.baseType()->storageSize();
 		solAssert(storageSize > 1 || (storageSize == 1 && storageBytes > 0), "");
 
+		// Fully unrolled word-wise copy for small statically-sized arrays of full-slot
+		// value types, mirroring the unrolled case in copyArrayToStorage. The elements
+		// are word-aligned, so no padding is needed either way.
+		u256 const c_unrolledCopyLimit = 8;
+		if (
+			!_sourceType.isByteArray() && !_sourceType.isDynamicallySized() &&
+			_sourceType.baseType()->isValueType() && storageBytes == 32 &&
+			_sourceType.length() <= c_unrolledCopyLimit
+		)
+		{
+			// stack: memory_offset storage_ref
+			for (u256 i = 0; i < _sourceType.length(); ++i)
+			{
+				m_context << eth::Instruction::DUP1;
+				if (i > 0)
+					m_context << i << eth::Instruction::ADD;
+				m_context << eth::Instruction::SLOAD;
+				m_context << eth::Instruction::DUP3;
+				if (i > 0)
+					m_context << u256(i * 32) << eth::Instruction::ADD;
+				m_context << eth::Instruction::MSTORE;
+			}
+			m_context << eth::Instruction::POP;
+			m_context << u256(_sourceType.length() * 32) << eth::Instruction::ADD;
+			// stack: updated_memory_offset
+			return;
+		}
+
 		retrieveLength(_sourceType);
 		// stack here: memory_offset storage_offset length
 		// jump to end if length is zero
@@ -509,14 +575,17 @@ void ArrayUtils::clearArray(ArrayType const& _type) const
 	if (_type.baseType()->isValueType())
 		solAssert(_type.baseType()->storageSize() <= 1, "Invalid size for value type.");
 
+	// Unrolling the clearing loop avoids its jump and counter overhead for small arrays.
+	u256 const c_unrolledClearSlotLimit = 8;
+	u256 const c_unrolledClearItemLimit = 4;
+
 	m_context << eth::Instruction::POP; // remove byte offset
 	if (_type.isDynamicallySized())
 		clearDynamicArray(_type);
 	else if (_type.length() == 0 || _type.baseType()->category() == Type::Category::Mapping)
 		m_context << eth::Instruction::POP;
-	else if (_type.baseType()->isValueType() && _type.storageSize() <= 5)
+	else if (_type.baseType()->isValueType() && _type.storageSize() <= c_unrolledClearSlotLimit)
 	{
-		// unroll loop for small arrays @todo choose a good value
 		// Note that we loop over storage slots here, not elements.
 		for (unsigned i = 1; i < _type.storageSize(); ++i)
 			m_context
@@ -524,9 +593,8 @@ void ArrayUtils::clearArray(ArrayType const& _type) const
 				<< u256(1) << eth::Instruction::ADD;
 		m_context << u256(0) << eth::Instruction::SWAP1 << eth::Instruction::SSTORE;
 	}
-	else if (!_type.baseType()->isValueType() && _type.length() <= 4)
+	else if (!_type.baseType()->isValueType() && _type.length() <= c_unrolledClearItemLimit)
 	{
-		// unroll loop for small arrays @todo choose a good value
 		solAssert(_type.baseType()->storageBytes() >= 32, "Invalid storage size.");
 		for (unsigned i = 1; i < _type.length(); ++i)
 		{
@@ -558,6 +626,14 @@ void ArrayUtils::clearDynamicArray(ArrayType const& _type) const
 	solAssert(_type.location() == DataLocation::Storage, "");
 	solAssert(_type.isDynamicallySized(), "");
 
+	if (_type.baseType()->category() == Type::Category::Mapping)
+	{
+		// Mappings cannot be zeroed anyway, so resetting the length is all that is needed
+		// and the data area is left alone.
+		m_context << u256(0) << eth::Instruction::SWAP1 << eth::Instruction::SSTORE;
+		return;
+	}
+
 	// fetch length
 	retrieveLength(_type);
 	// set length to zero
@@ -702,29 +778,33 @@ void ArrayUtils::resizeDynamicArray(ArrayType const& _type) const
 		// For a "long" byte array, store length as 2*length+1
 		m_context << eth::Instruction::DUP1 << eth::Instruction::ADD << u256(1) << eth::Instruction::ADD;
 	m_context<< eth::Instruction::DUP4 << eth::Instruction::SSTORE;
-	// skip if size is not reduced
-	m_context << eth::Instruction::DUP2 << eth::Instruction::DUP2
-		<< eth::Instruction::ISZERO << eth::Instruction::GT;
-	m_context.appendConditionalJumpTo(resizeEnd);
+	// Mappings cannot be zeroed, so a truncated tail is left alone.
+	if (_type.baseType()->category() != Type::Category::Mapping)
+	{
+		// skip if size is not reduced
+		m_context << eth::Instruction::DUP2 << eth::Instruction::DUP2
+			<< eth::Instruction::ISZERO << eth::Instruction::GT;
+		m_context.appendConditionalJumpTo(resizeEnd);
 
-	// size reduced, clear the end of the array
-	// stack: ref new_length old_length
-	convertLengthToSize(_type);
-	m_context << eth::Instruction::DUP2;
-	convertLengthToSize(_type);
-	// stack: ref new_length old_size new_size
-	// compute data positions
-	m_context << eth::Instruction::DUP4;
-	CompilerUtils(m_context).computeHashStatic();
-	// stack: ref new_length old_size new_size data_pos
-	m_context << eth::Instruction::SWAP2 << eth::Instruction::DUP3 << eth::Instruction::ADD;
-	// stack: ref new_length data_pos new_size delete_end
-	m_context << eth::Instruction::SWAP2 << eth::Instruction::ADD;
-	// stack: ref new_length delete_end delete_start
-	if (_type.isByteArray() || _type.baseType()->storageBytes() < 32)
-		clearStorageLoop(IntegerType(256));
-	else
-		clearStorageLoop(*_type.baseType());
+		// size reduced, clear the end of the array
+		// stack: ref new_length old_length
+		convertLengthToSize(_type);
+		m_context << eth::Instruction::DUP2;
+		convertLengthToSize(_type);
+		// stack: ref new_length old_size new_size
+		// compute data positions
+		m_context << eth::Instruction::DUP4;
+		CompilerUtils(m_context).computeHashStatic();
+		// stack: ref new_length old_size new_size data_pos
+		m_context << eth::Instruction::SWAP2 << eth::Instruction::DUP3 << eth::Instruction::ADD;
+		// stack: ref new_length data_pos new_size delete_end
+		m_context << eth::Instruction::SWAP2 << eth::Instruction::ADD;
+		// stack: ref new_length delete_end delete_start
+		if (_type.isByteArray() || _type.baseType()->storageBytes() < 32)
+			clearStorageLoop(IntegerType(256));
+		else
+			clearStorageLoop(*_type.baseType());
+	}
 
 	m_context << resizeEnd;
 	// cleanup
@@ -0,0 +1,106 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Content-addressed on-disk cache of compilation artifacts.
+ */
+
+#include <libsolidity/ArtifactCache.h>
+#include <fstream>
+#include <stdexcept>
+#include <boost/filesystem.hpp>
+#include <json/json.h>
+#include <libdevcore/CommonData.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::solidity;
+
+namespace
+{
+
+Json::Value linkerObjectToJson(eth::LinkerObject const& _object)
+{
+	Json::Value json(Json::objectValue);
+	json["bytecode"] = toHex(_object.bytecode);
+	Json::Value references(Json::objectValue);
+	for (auto const& reference: _object.linkReferences)
+		references[to_string(reference.first)] = reference.second;
+	json["linkReferences"] = references;
+	return json;
+}
+
+bool linkerObjectFromJson(Json::Value const& _json, eth::LinkerObject& _object)
+{
+	if (!_json.isObject() || !_json["bytecode"].isString())
+		return false;
+	_object.bytecode = fromHex(_json["bytecode"].asString());
+	_object.linkReferences.clear();
+	Json::Value const& references = _json["linkReferences"];
+	if (references.isObject())
+		for (string const& offset: references.getMemberNames())
+		{
+			// A corrupt or hand-edited entry degrades to a cache miss instead
+			// of letting stoul abort the compilation.
+			if (offset.empty() || offset.find_first_not_of("0123456789") != string::npos)
+				return false;
+			try
+			{
+				_object.linkReferences[size_t(stoul(offset))] = references[offset].asString();
+			}
+			catch (std::out_of_range const&)
+			{
+				return false;
+			}
+		}
+	return true;
+}
+
+}
+
+bool ArtifactCache::load(h256 const& _key, Entry& _entry) const
+{
+	ifstream file(entryPath(_key));
+	if (!file.is_open())
+		return false;
+	Json::Value json;
+	if (!Json::Reader().parse(file, json) || !json.isObject())
+		return false;
+	return
+		linkerObjectFromJson(json["object"], _entry.object) &&
+		linkerObjectFromJson(json["runtimeObject"], _entry.runtimeObject) &&
+		linkerObjectFromJson(json["cloneObject"], _entry.cloneObject);
+}
+
+void ArtifactCache::store(h256 const& _key, Entry const& _entry) const
+{
+	boost::system::error_code error;
+	boost::filesystem::create_directories(m_directory, error);
+	ofstream file(entryPath(_key), ios::trunc);
+	if (!file.is_open())
+		return;
+	Json::Value json(Json::objectValue);
+	json["object"] = linkerObjectToJson(_entry.object);
+	json["runtimeObject"] = linkerObjectToJson(_entry.runtimeObject);
+	json["cloneObject"] = linkerObjectToJson(_entry.cloneObject);
+	file << Json::FastWriter().write(json);
+}
+
+string ArtifactCache::entryPath(h256 const& _key) const
+{
+	return m_directory + "/" + _key.hex() + ".json";
+}
@@ -0,0 +1,67 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Content-addressed on-disk cache of compilation artifacts.
+ */
+
+#pragma once
+
+#include <string>
+#include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libevmasm/LinkerObject.h>
+
+namespace dev
+{
+namespace solidity
+{
+
+/**
+ * Content-addressed on-disk cache of per-contract compilation artifacts. Entries are
+ * keyed by a hash covering the contract sources, the compiler version and the code
+ * generation settings (see CompilerStack::artifactCacheKey), so a hit is always safe
+ * to reuse and a changed input simply misses. Entries are stored as one JSON file per
+ * key; all file system failures are treated as misses, the cache is best-effort.
+ */
+class ArtifactCache
+{
+public:
+	struct Entry
+	{
+		eth::LinkerObject object;
+		eth::LinkerObject runtimeObject;
+		eth::LinkerObject cloneObject;
+	};
+
+	/// @param _directory the cache directory, created on the first store if absent.
+	explicit ArtifactCache(std::string _directory): m_directory(std::move(_directory)) {}
+
+	/// Tries to read the entry stored for @a _key into @a _entry.
+	/// @returns false if there is none or it cannot be read.
+	bool load(h256 const& _key, Entry& _entry) const;
+	/// Writes the entry for @a _key, silently doing nothing on failure.
+	void store(h256 const& _key, Entry const& _entry) const;
+
+private:
+	std::string entryPath(h256 const& _key) const;
+
+	std::string m_directory;
+};
+
+}
+}
@@ -27,6 +27,7 @@
 #include <libevmasm/Assembly.h>
 #include <libevmcore/Params.h>
 #include <libsolidity/AST.h>
+#include <libsolidity/ConstantEvaluator.h>
 #include <libsolidity/ExpressionCompiler.h>
 #include <libsolidity/CompilerUtils.h>
 
@@ -113,6 +114,8 @@ void Compiler::initializeContext(
 {
 	m_context.setCompiledContracts(_compiledContracts);
 	m_context.setInheritanceHierarchy(_contract.annotation().linearizedBaseContracts);
+	m_context.setFunctionCodeCache(m_codeCache);
+	m_context.setSharedRoutines(m_sharedConversionRoutines);
 	CompilerUtils(m_context).initialiseFreeMemoryPointer();
 	registerStateVariables(_contract);
 	m_context.resetVisitedNodes(&_contract);
@@ -224,9 +227,49 @@ void Compiler::appendConstructor(FunctionDefinition const& _constructor)
 	_constructor.accept(*this);
 }
 
+namespace
+{
+
+/**
+ * Collects how the declarations of a contract hierarchy are used, to decide whether a
+ * function's arguments may stay in calldata until their first use: parameters written to
+ * need a stack slot and functions that are (possibly) entered from inside the contract
+ * have to use the regular stack-based calling convention.
+ */
+class CalldataUseScanner: public ASTConstVisitor
+{
+public:
+	void scan(ASTNode const& _node) { _node.accept(*this); }
+	bool isWritten(Declaration const* _declaration) const { return m_written.count(_declaration) != 0; }
+	/// Conservative by name so that calls resolved to an overriding function also count
+	/// against the function they override.
+	bool referencesName(std::string const& _name) const { return m_referencedNames.count(_name) != 0; }
+
+private:
+	virtual void endVisit(Identifier const& _identifier) override
+	{
+		if (Declaration const* declaration = _identifier.annotation().referencedDeclaration)
+		{
+			m_referencedNames.insert(declaration->name());
+			if (_identifier.annotation().lValueRequested)
+				m_written.insert(declaration);
+		}
+	}
+	virtual void endVisit(MemberAccess const& _memberAccess) override
+	{
+		// Covers internal calls through members, e.g. "super.f()" or "Base.f()".
+		m_referencedNames.insert(_memberAccess.memberName());
+	}
+
+	std::set<Declaration const*> m_written;
+	std::set<std::string> m_referencedNames;
+};
+
+}
+
 void Compiler::appendFunctionSelector(ContractDefinition const& _contract)
 {
-	map<FixedHash<4>, FunctionTypePointer> interfaceFunctions = _contract.interfaceFunctions();
+	map<FixedHash<4>, FunctionTypePointer> const& interfaceFunctions = _contract.interfaceFunctions();
 	map<FixedHash<4>, const eth::AssemblyItem> callDataUnpackerEntryPoints;
 
 	FunctionDefinition const* fallback = _contract.fallbackFunction();
@@ -243,14 +286,32 @@ void Compiler::appendFunctionSelector(ContractDefinition const& _contract)
 	if (!interfaceFunctions.empty())
 		CompilerUtils(m_context).loadFromMemory(0, IntegerType(CompilerUtils::dataStartOffset * 8), true);
 
-	// stack now is: 1 0 <funhash>
+	// Number of interface functions from which on dispatch switches from a linear sequence of
+	// comparisons to a binary search over the sorted selectors, turning the worst case from
+	// O(n) to O(log n) comparisons.
+	size_t const c_binarySearchDispatchThreshold = 8;
+
+	// The map is ordered by FixedHash's byte-wise comparison, which coincides with the
+	// numeric order of the big-endian selector values the comparisons work on.
+	vector<FixedHash<4>> sortedSelectors;
 	for (auto const& it: interfaceFunctions)
 	{
 		callDataUnpackerEntryPoints.insert(std::make_pair(it.first, m_context.newTag()));
-		m_context << eth::dupInstruction(1) << u256(FixedHash<4>::Arith(it.first)) << eth::Instruction::EQ;
-		m_context.appendConditionalJumpTo(callDataUnpackerEntryPoints.at(it.first));
+		sortedSelectors.push_back(it.first);
+	}
+
+	// stack now is: 1 0 <funhash>
+	if (interfaceFunctions.size() >= c_binarySearchDispatchThreshold)
+		appendSelectorSearch(sortedSelectors, 0, sortedSelectors.size(), callDataUnpackerEntryPoints, notFound);
+	else
+	{
+		for (auto const& it: interfaceFunctions)
+		{
+			m_context << eth::dupInstruction(1) << u256(FixedHash<4>::Arith(it.first)) << eth::Instruction::EQ;
+			m_context.appendConditionalJumpTo(callDataUnpackerEntryPoints.at(it.first));
+		}
+		m_context.appendJumpTo(notFound);
 	}
-	m_context.appendJumpTo(notFound);
 
 	m_context << notFound;
 	if (fallback)
@@ -266,6 +327,33 @@ void Compiler::appendFunctionSelector(ContractDefinition const& _contract)
 	else
 		m_context << eth::Instruction::STOP; // function not found
 
+	// In shared subroutine mode, functions with the same parameter or return type
+	// signature share a single calldata unpacker or return value packer.
+	auto signatureKey = [](TypePointers const& _types) -> string
+	{
+		string key;
+		for (TypePointer const& type: _types)
+			key += " " + type->toString(false);
+		return key;
+	};
+	map<string, unsigned> parameterSignatureCount;
+	map<string, unsigned> returnSignatureCount;
+	if (m_context.sharedRoutinesEnabled())
+		for (auto const& it: interfaceFunctions)
+		{
+			parameterSignatureCount[signatureKey(it.second->parameterTypes())]++;
+			returnSignatureCount[signatureKey(it.second->returnParameterTypes())]++;
+		}
+	bool const isLibrary = _contract.isLibrary();
+
+	// In lazy calldata decoding mode, the dispatch leaves the arguments in calldata and the
+	// function body loads each of them at its first use. This is only sound for functions
+	// that cannot be entered from inside the contract and never write to their parameters.
+	CalldataUseScanner lazyUseScanner;
+	if (m_lazyCalldataDecoding)
+		for (ContractDefinition const* contract: _contract.annotation().linearizedBaseContracts)
+			lazyUseScanner.scan(*contract);
+
 	for (auto const& it: interfaceFunctions)
 	{
 		FunctionTypePointer const& functionType = it.second;
@@ -273,12 +361,110 @@ void Compiler::appendFunctionSelector(ContractDefinition const& _contract)
 		CompilerContext::LocationSetter locationSetter(m_context, functionType->declaration());
 		m_context << callDataUnpackerEntryPoints.at(it.first);
 		eth::AssemblyItem returnTag = m_context.pushNewTag();
-		m_context << CompilerUtils::dataStartOffset;
-		appendCalldataUnpacker(functionType->parameterTypes());
-		m_context.appendJumpTo(m_context.functionEntryLabel(functionType->declaration()));
+		TypePointers const& parameterTypes = functionType->parameterTypes();
+		unsigned const parameterSize = CompilerUtils::sizeOnStack(parameterTypes);
+		auto const* functionDefinition = dynamic_cast<FunctionDefinition const*>(&functionType->declaration());
+		bool lazyDecoding =
+			m_lazyCalldataDecoding &&
+			functionDefinition &&
+			functionDefinition->modifiers().empty() &&
+			!parameterTypes.empty() &&
+			!lazyUseScanner.referencesName(functionDefinition->name());
+		if (lazyDecoding)
+			for (TypePointer const& parameterType: parameterTypes)
+				if (!parameterType->isValueType())
+					lazyDecoding = false;
+		if (lazyDecoding)
+			for (ASTPointer<VariableDeclaration> const& variable: functionDefinition->parameters())
+				if (lazyUseScanner.isWritten(variable.get()))
+					lazyDecoding = false;
+		if (lazyDecoding)
+		{
+			// The parameters are registered as calldata variables when the body is compiled.
+			m_context.markLazyCalldataFunction(functionType->declaration());
+			m_context.appendJumpTo(m_context.functionEntryLabel(functionType->declaration()));
+		}
+		else if (
+			m_context.sharedRoutinesEnabled() &&
+			!parameterTypes.empty() &&
+			parameterSize <= 15 &&
+			parameterSignatureCount[signatureKey(parameterTypes)] > 1
+		)
+		{
+			// The shared unpacker receives the entry tag of the concrete function on the
+			// stack and jumps to it once the arguments have been decoded.
+			m_context << m_context.functionEntryLabel(functionType->declaration()).pushTag();
+			m_context.appendJumpTo(m_context.sharedRoutineTag(
+				"abidecode" + signatureKey(parameterTypes),
+				[this, parameterTypes, parameterSize](CompilerContext& _context)
+				{
+					solAssert(&_context == &m_context, "");
+					// Stack: [returnTag functionEntry]
+					m_context.setStackOffset(2);
+					m_context << CompilerUtils::dataStartOffset;
+					appendCalldataUnpacker(parameterTypes);
+					// Stack: [returnTag functionEntry v1 ... vn]
+					CompilerUtils(m_context).moveToStackTop(parameterSize);
+					m_context.appendJump(eth::AssemblyItem::JumpType::IntoFunction);
+				}
+			));
+		}
+		else
+		{
+			m_context << CompilerUtils::dataStartOffset;
+			appendCalldataUnpacker(parameterTypes);
+			m_context.appendJumpTo(m_context.functionEntryLabel(functionType->declaration()));
+		}
 		m_context << returnTag;
-		appendReturnValuePacker(functionType->returnParameterTypes(), _contract.isLibrary());
+		TypePointers const& returnTypes = functionType->returnParameterTypes();
+		if (
+			m_context.sharedRoutinesEnabled() &&
+			!returnTypes.empty() &&
+			returnSignatureCount[signatureKey(returnTypes)] > 1
+		)
+			// The packer ends in RETURN, so a plain jump into it suffices.
+			m_context.appendJumpTo(m_context.sharedRoutineTag(
+				"abireturn" + signatureKey(returnTypes),
+				[this, returnTypes, isLibrary](CompilerContext& _context)
+				{
+					solAssert(&_context == &m_context, "");
+					m_context.setStackOffset(static_cast<int>(CompilerUtils::sizeOnStack(returnTypes)));
+					appendReturnValuePacker(returnTypes, isLibrary);
+				}
+			));
+		else
+			appendReturnValuePacker(returnTypes, isLibrary);
+	}
+}
+
+void Compiler::appendSelectorSearch(
+	vector<FixedHash<4>> const& _selectors,
+	size_t _begin,
+	size_t _end,
+	map<FixedHash<4>, eth::AssemblyItem const> const& _entryPoints,
+	eth::AssemblyItem const& _notFound
+)
+{
+	size_t const size = _end - _begin;
+	// A short range is cheaper as a plain sequence of comparisons than as further splits.
+	if (size <= 3)
+	{
+		for (size_t i = _begin; i < _end; ++i)
+		{
+			m_context << eth::dupInstruction(1) << u256(FixedHash<4>::Arith(_selectors[i])) << eth::Instruction::EQ;
+			m_context.appendConditionalJumpTo(_entryPoints.at(_selectors[i]));
+		}
+		m_context.appendJumpTo(_notFound);
+		return;
 	}
+	size_t const mid = _begin + size / 2;
+	eth::AssemblyItem lowerHalf = m_context.newTag();
+	// GT computes selector > funhash, i.e. the hash can only be in the lower half.
+	m_context << eth::dupInstruction(1) << u256(FixedHash<4>::Arith(_selectors[mid])) << eth::Instruction::GT;
+	m_context.appendConditionalJumpTo(lowerHalf);
+	appendSelectorSearch(_selectors, mid, _end, _entryPoints, _notFound);
+	m_context << lowerHalf;
+	appendSelectorSearch(_selectors, _begin, mid, _entryPoints, _notFound);
 }
 
 void Compiler::appendCalldataUnpacker(TypePointers const& _typeParameters, bool _fromMemory)
@@ -417,15 +603,28 @@ bool Compiler::visit(FunctionDefinition const& _function)
 	// stack upon entry: [return address] [arg0] [arg1] ... [argn]
 	// reserve additional slots: [retarg0] ... [retargm] [localvar0] ... [localvarp]
 
-	unsigned parametersSize = CompilerUtils::sizeOnStack(_function.parameters());
+	bool const lazyParameters = m_context.isLazyCalldataFunction(&_function);
+	unsigned parametersSize = lazyParameters ? 0 : CompilerUtils::sizeOnStack(_function.parameters());
 	if (!_function.isConstructor())
 		// adding 1 for return address.
 		m_context.adjustStackOffset(parametersSize + 1);
-	for (ASTPointer<VariableDeclaration const> const& variable: _function.parameters())
+	if (lazyParameters)
 	{
-		m_context.addVariable(*variable, parametersSize);
-		parametersSize -= variable->annotation().type->sizeOnStack();
+		// The selector jumped here without decoding, so the arguments occupy no stack slots
+		// and are loaded from their (word-padded) calldata positions at their use sites.
+		unsigned calldataOffset = CompilerUtils::dataStartOffset;
+		for (ASTPointer<VariableDeclaration const> const& variable: _function.parameters())
+		{
+			m_context.addCalldataVariable(*variable, calldataOffset);
+			calldataOffset += 32;
+		}
 	}
+	else
+		for (ASTPointer<VariableDeclaration const> const& variable: _function.parameters())
+		{
+			m_context.addVariable(*variable, parametersSize);
+			parametersSize -= variable->annotation().type->sizeOnStack();
+		}
 
 	for (ASTPointer<VariableDeclaration const> const& variable: _function.returnParameters())
 		appendStackVariableInitialisation(*variable);
@@ -453,7 +652,7 @@ bool Compiler::visit(FunctionDefinition const& _function)
 	// Note that the fact that the return arguments are of increasing index is vital for this
 	// algorithm to work.
 
-	unsigned const c_argumentsSize = CompilerUtils::sizeOnStack(_function.parameters());
+	unsigned const c_argumentsSize = lazyParameters ? 0 : CompilerUtils::sizeOnStack(_function.parameters());
 	unsigned const c_returnValuesSize = CompilerUtils::sizeOnStack(_function.returnParameters());
 	unsigned const c_localVariablesSize = CompilerUtils::sizeOnStack(_function.localVariables());
 
@@ -494,6 +693,17 @@ bool Compiler::visit(IfStatement const& _ifStatement)
 {
 	StackHeightChecker checker(m_context);
 	CompilerContext::LocationSetter locationSetter(m_context, _ifStatement);
+	// Constant conditions (e.g. feature flags) need neither a runtime test nor the dead
+	// branch. Folded expressions are side-effect free, so the condition is skipped too.
+	if (auto constantCondition = ConstantFolder::fold(_ifStatement.condition()))
+	{
+		if (*constantCondition != 0)
+			_ifStatement.trueStatement().accept(*this);
+		else if (_ifStatement.falseStatement())
+			_ifStatement.falseStatement()->accept(*this);
+		checker.check();
+		return false;
+	}
 	compileExpression(_ifStatement.condition());
 	m_context << eth::Instruction::ISZERO;
 	eth::AssemblyItem falseTag = m_context.appendConditionalJump();
@@ -511,19 +721,202 @@ bool Compiler::visit(IfStatement const& _ifStatement)
 	return false;
 }
 
+namespace
+{
+
+/**
+ * Collects expressions inside a loop that provably evaluate to the same value on every
+ * iteration and have no side effects, so that the loop header can evaluate them once
+ * into a stack slot: reads of value-type state variables and lengths of storage arrays
+ * that are never assigned to in the loop. Gives up entirely as soon as the loop contains
+ * anything that could modify storage behind our back, in particular any function call or
+ * a write through a storage pointer.
+ */
+class LoopInvariantFinder: public ASTConstVisitor
+{
+public:
+	/// Identifies equivalent invariant expressions: the variable read or, for the second
+	/// component set to true, the array whose length is read.
+	using Key = std::pair<Declaration const*, bool>;
+
+	void scan(ASTNode const& _node) { _node.accept(*this); }
+	/// @returns the invariant expressions found together with their keys, in scanning order.
+	std::vector<std::pair<Expression const*, Key>> invariants() const
+	{
+		std::vector<std::pair<Expression const*, Key>> result;
+		if (!m_safe)
+			return result;
+		for (auto const& candidate: m_candidates)
+			if (!m_written.count(candidate.second.first))
+				result.push_back(candidate);
+		return result;
+	}
+
+private:
+	virtual bool visit(FunctionCall const&) override { m_safe = false; return false; }
+	virtual bool visit(NewExpression const&) override { m_safe = false; return false; }
+	virtual bool visit(Assignment const& _assignment) override
+	{
+		recordWrite(_assignment.leftHandSide());
+		return true;
+	}
+	virtual bool visit(UnaryOperation const& _unaryOperation) override
+	{
+		Token::Value op = _unaryOperation.getOperator();
+		if (op == Token::Delete || op == Token::Inc || op == Token::Dec)
+			recordWrite(_unaryOperation.subExpression());
+		return true;
+	}
+	virtual bool visit(Identifier const& _identifier) override
+	{
+		auto variable = dynamic_cast<VariableDeclaration const*>(_identifier.annotation().referencedDeclaration);
+		if (
+			variable &&
+			variable->isStateVariable() &&
+			!variable->isConstant() &&
+			!_identifier.annotation().lValueRequested &&
+			variable->annotation().type->isValueType()
+		)
+			m_candidates.push_back(make_pair(&_identifier, Key(variable, false)));
+		return true;
+	}
+	virtual bool visit(MemberAccess const& _memberAccess) override
+	{
+		if (_memberAccess.memberName() != "length" || _memberAccess.annotation().lValueRequested)
+			return true;
+		auto arrayType = dynamic_cast<ArrayType const*>(_memberAccess.expression().annotation().type.get());
+		auto identifier = dynamic_cast<Identifier const*>(&_memberAccess.expression());
+		if (
+			!arrayType ||
+			!identifier ||
+			arrayType->location() != DataLocation::Storage ||
+			!arrayType->isDynamicallySized()
+		)
+			return true;
+		auto variable = dynamic_cast<VariableDeclaration const*>(identifier->annotation().referencedDeclaration);
+		if (variable && variable->isStateVariable())
+		{
+			m_candidates.push_back(make_pair(&_memberAccess, Key(variable, true)));
+			// The array reference itself is not evaluated when the length is hoisted.
+			return false;
+		}
+		return true;
+	}
+
+	void recordWrite(Expression const& _expression)
+	{
+		if (auto tuple = dynamic_cast<TupleExpression const*>(&_expression))
+		{
+			for (ASTPointer<Expression> const& component: tuple->components())
+				if (component)
+					recordWrite(*component);
+			return;
+		}
+		Expression const* base = &_expression;
+		while (true)
+		{
+			if (auto indexAccess = dynamic_cast<IndexAccess const*>(base))
+				base = &indexAccess->baseExpression();
+			else if (auto memberAccess = dynamic_cast<MemberAccess const*>(base))
+				base = &memberAccess->expression();
+			else
+				break;
+		}
+		auto identifier = dynamic_cast<Identifier const*>(base);
+		auto variable = identifier ?
+			dynamic_cast<VariableDeclaration const*>(identifier->annotation().referencedDeclaration) :
+			nullptr;
+		// A write through anything but a named variable - or through a local storage
+		// reference, which can alias arbitrary state variables - poisons the whole loop.
+		if (
+			!variable ||
+			(!variable->isStateVariable() && variable->annotation().type->dataStoredIn(DataLocation::Storage))
+		)
+			m_safe = false;
+		else
+			m_written.insert(variable);
+	}
+
+	bool m_safe = true;
+	std::set<Declaration const*> m_written;
+	std::vector<std::pair<Expression const*, Key>> m_candidates;
+};
+
+/// Upper bound on the stack slots a single loop reserves for hoisted invariants, to keep
+/// the pressure on the sixteen reachable stack slots low.
+size_t const c_maxHoistedLoopInvariants = 4;
+
+}
+
+Compiler::HoistedInvariants Compiler::hoistLoopInvariants(vector<ASTNode const*> const& _loopParts)
+{
+	LoopInvariantFinder finder;
+	for (ASTNode const* part: _loopParts)
+		if (part)
+			finder.scan(*part);
+	HoistedInvariants hoisted;
+	map<LoopInvariantFinder::Key, Expression const*> slotHolders;
+	for (auto const& invariant: finder.invariants())
+	{
+		if (m_context.isHoistedExpression(*invariant.first))
+		{
+			// Already hoisted by an enclosing loop; equivalent reads can share its slot.
+			slotHolders.insert(make_pair(invariant.second, invariant.first));
+			continue;
+		}
+		auto holder = slotHolders.find(invariant.second);
+		if (holder != slotHolders.end())
+		{
+			m_context.addHoistedExpressionAlias(*invariant.first, *holder->second);
+			hoisted.registered.push_back(invariant.first);
+		}
+		else if (hoisted.slots.size() < c_maxHoistedLoopInvariants)
+		{
+			compileExpression(*invariant.first);
+			m_context.addHoistedExpression(*invariant.first);
+			slotHolders.insert(make_pair(invariant.second, invariant.first));
+			hoisted.slots.push_back(invariant.first);
+			hoisted.registered.push_back(invariant.first);
+		}
+	}
+	return hoisted;
+}
+
+void Compiler::unhoistLoopInvariants(HoistedInvariants const& _hoisted)
+{
+	for (Expression const* expression: _hoisted.registered)
+		m_context.removeHoistedExpression(*expression);
+	for (size_t i = 0; i < _hoisted.slots.size(); ++i)
+		m_context << eth::Instruction::POP;
+}
+
 bool Compiler::visit(WhileStatement const& _whileStatement)
 {
 	StackHeightChecker checker(m_context);
 	CompilerContext::LocationSetter locationSetter(m_context, _whileStatement);
+	shared_ptr<u256 const> constantCondition = ConstantFolder::fold(_whileStatement.condition());
+	if (constantCondition && *constantCondition == 0)
+	{
+		// The body is never entered, drop the whole loop.
+		checker.check();
+		return false;
+	}
+	HoistedInvariants hoisted = hoistLoopInvariants({&_whileStatement.condition(), &_whileStatement.body()});
+	m_stackCleanupForReturn += hoisted.slots.size();
+
 	eth::AssemblyItem loopStart = m_context.newTag();
 	eth::AssemblyItem loopEnd = m_context.newTag();
 	m_continueTags.push_back(loopStart);
 	m_breakTags.push_back(loopEnd);
 
 	m_context << loopStart;
-	compileExpression(_whileStatement.condition());
-	m_context << eth::Instruction::ISZERO;
-	m_context.appendConditionalJumpTo(loopEnd);
+	if (!constantCondition)
+	{
+		compileExpression(_whileStatement.condition());
+		m_context << eth::Instruction::ISZERO;
+		m_context.appendConditionalJumpTo(loopEnd);
+	}
+	// else: constant true, the loop is only left via break, return or throw
 
 	_whileStatement.body().accept(*this);
 
@@ -533,6 +926,9 @@ bool Compiler::visit(WhileStatement const& _whileStatement)
 	m_continueTags.pop_back();
 	m_breakTags.pop_back();
 
+	m_stackCleanupForReturn -= hoisted.slots.size();
+	unhoistLoopInvariants(hoisted);
+
 	checker.check();
 	return false;
 }
@@ -541,19 +937,37 @@ bool Compiler::visit(ForStatement const& _forStatement)
 {
 	StackHeightChecker checker(m_context);
 	CompilerContext::LocationSetter locationSetter(m_context, _forStatement);
+
+	if (_forStatement.initializationExpression())
+		_forStatement.initializationExpression()->accept(*this);
+
+	shared_ptr<u256 const> constantCondition;
+	if (_forStatement.condition())
+		constantCondition = ConstantFolder::fold(*_forStatement.condition());
+	if (constantCondition && *constantCondition == 0)
+	{
+		// Only the initialization is ever executed, drop the rest of the loop.
+		checker.check();
+		return false;
+	}
+
+	HoistedInvariants hoisted = hoistLoopInvariants({
+		_forStatement.condition(),
+		&_forStatement.body(),
+		_forStatement.loopExpression()
+	});
+	m_stackCleanupForReturn += hoisted.slots.size();
+
 	eth::AssemblyItem loopStart = m_context.newTag();
 	eth::AssemblyItem loopEnd = m_context.newTag();
 	eth::AssemblyItem loopNext = m_context.newTag();
 	m_continueTags.push_back(loopNext);
 	m_breakTags.push_back(loopEnd);
 
-	if (_forStatement.initializationExpression())
-		_forStatement.initializationExpression()->accept(*this);
-
 	m_context << loopStart;
 
 	// if there is no terminating condition in for, default is to always be true
-	if (_forStatement.condition())
+	if (_forStatement.condition() && !constantCondition)
 	{
 		compileExpression(*_forStatement.condition());
 		m_context << eth::Instruction::ISZERO;
@@ -574,6 +988,9 @@ bool Compiler::visit(ForStatement const& _forStatement)
 	m_continueTags.pop_back();
 	m_breakTags.pop_back();
 
+	m_stackCleanupForReturn -= hoisted.slots.size();
+	unhoistLoopInvariants(hoisted);
+
 	checker.check();
 	return false;
 }
@@ -681,17 +1098,120 @@ bool Compiler::visit(PlaceholderStatement const& _placeholderStatement)
 	return true;
 }
 
+namespace
+{
+
+/**
+ * Checks that a modifier body section can be compiled independently of the function it
+ * adorns, i.e. contains neither a placeholder nor a return statement.
+ */
+class ModifierPrefixChecker: public ASTConstVisitor
+{
+public:
+	bool check(Statement const& _statement) { _statement.accept(*this); return m_independent; }
+
+private:
+	virtual bool visit(PlaceholderStatement const&) override { m_independent = false; return false; }
+	virtual bool visit(Return const&) override { m_independent = false; return false; }
+
+	bool m_independent = true;
+};
+
+/**
+ * Collects what the code generated for a function body depends on besides the body itself,
+ * to decide whether the generated items may be shared across contracts and to record the
+ * fingerprint the cached code has to be validated against before reuse.
+ */
+class FunctionCodeDependencyCollector: public ASTConstVisitor
+{
+public:
+	bool cacheable = true;
+	std::vector<FunctionDefinition const*> calledFunctions;
+	std::vector<Declaration const*> stateVariables;
+
+private:
+	virtual void endVisit(Identifier const& _identifier) override
+	{
+		Declaration const* declaration = _identifier.annotation().referencedDeclaration;
+		if (auto function = dynamic_cast<FunctionDefinition const*>(declaration))
+			calledFunctions.push_back(function);
+		else if (auto variable = dynamic_cast<VariableDeclaration const*>(declaration))
+		{
+			if (variable->isStateVariable() && !variable->isConstant())
+				stateVariables.push_back(variable);
+		}
+		else if (dynamic_cast<MagicVariableDeclaration const*>(declaration))
+		{
+			// "super" resolution depends on the inheritance hierarchy of the compiled contract.
+			if (declaration->name() == "super")
+				cacheable = false;
+		}
+	}
+};
+
+}
+
 void Compiler::appendFunctionsWithoutCode()
 {
-	set<Declaration const*> functions = m_context.functionsWithoutCode();
-	while (!functions.empty())
+	// The queue only ever contains functions that are reachable - transitively via the
+	// entry label references - from the function selector, the constructors and the
+	// fallback function, so unreferenced internal functions never make it into the code.
+	while (true)
 	{
-		for (Declaration const* function: functions)
+		Declaration const* function = m_context.nextFunctionToCompile();
+		if (!function)
+		{
+			// Bodies of shared conversion subroutines are emitted next to the functions.
+			// Function bodies can request new routines and vice versa, so drain both.
+			if (m_context.appendPendingSharedRoutine())
+				continue;
+			break;
+		}
+		m_context.setStackOffset(0);
+		// Lazily decoded functions use a calldata-based argument convention whose choice
+		// depends on the whole contract, so they do not participate in the code cache.
+		bool const lazyParameters = m_context.isLazyCalldataFunction(function);
+		if (!lazyParameters && m_context.replayCachedFunction(*function))
+			continue;
+
+		auto functionDefinition = dynamic_cast<FunctionDefinition const*>(function);
+		// Constructors depend on the base argument context and modifiers on name lookup
+		// in the hierarchy, so only plain function bodies are cached.
+		bool tryCache =
+			m_context.functionCodeCache() &&
+			functionDefinition &&
+			!functionDefinition->isConstructor() &&
+			!lazyParameters &&
+			functionDefinition->modifiers().empty();
+		size_t firstItem = 0;
+		u256 firstLocalTag = 0;
+		vector<pair<FunctionDefinition const*, FunctionDefinition const*>> virtualResolutions;
+		vector<pair<Declaration const*, pair<u256, unsigned>>> stateVariables;
+		if (tryCache)
 		{
-			m_context.setStackOffset(0);
-			function->accept(*this);
+			FunctionCodeDependencyCollector dependencies;
+			functionDefinition->accept(dependencies);
+			tryCache = dependencies.cacheable;
+			if (tryCache)
+			{
+				for (FunctionDefinition const* called: dependencies.calledFunctions)
+					virtualResolutions.push_back(make_pair(called, m_context.resolveVirtualFunction(*called)));
+				for (Declaration const* variable: dependencies.stateVariables)
+					stateVariables.push_back(make_pair(variable, m_context.storageLocationOfVariable(*variable)));
+				firstItem = m_context.assembly().items().size();
+				firstLocalTag = m_context.newTag().data();
+			}
 		}
-		functions = m_context.functionsWithoutCode();
+
+		function->accept(*this);
+		if (tryCache)
+			m_context.cacheFunctionCode(
+				*function,
+				firstItem,
+				firstLocalTag,
+				move(virtualResolutions),
+				move(stateVariables)
+			);
 	}
 }
 
@@ -715,6 +1235,54 @@ void Compiler::appendModifierOrFunctionCode()
 
 		ModifierDefinition const& modifier = m_context.functionModifier(modifierInvocation->name()->name());
 		CompilerContext::LocationSetter locationSetter(m_context, modifier);
+
+		// If requested, modifiers that consist of checks followed by a trailing placeholder
+		// (the common access control shape) are compiled once per contract as a subroutine
+		// instead of being inlined into every function that uses them.
+		vector<ASTPointer<Statement>> const& statements = modifier.body().statements();
+		bool shareBody =
+			m_sharedModifierBodies &&
+			modifier.parameters().empty() &&
+			modifier.localVariables().empty() &&
+			!statements.empty() &&
+			dynamic_cast<PlaceholderStatement const*>(statements.back().get());
+		if (shareBody)
+		{
+			ModifierPrefixChecker checker;
+			for (size_t i = 0; i + 1 < statements.size(); ++i)
+				if (!checker.check(*statements[i]))
+				{
+					shareBody = false;
+					break;
+				}
+		}
+		if (shareBody)
+		{
+			ModifierDefinition const* modifierDefinition = &modifier;
+			eth::AssemblyItem returnTag = m_context.pushNewTag();
+			m_context.appendJumpTo(m_context.sharedRoutineTag(
+				"modifier " + modifier.name(),
+				[this, modifierDefinition](CompilerContext& _context)
+				{
+					solAssert(&_context == &m_context, "");
+					// Stack: [returnTag] - the checks have no net stack effect.
+					m_context.setStackOffset(1);
+					vector<ASTPointer<Statement>> const& statements = modifierDefinition->body().statements();
+					for (size_t i = 0; i + 1 < statements.size(); ++i)
+						statements[i]->accept(*this);
+					m_context.appendJump(eth::AssemblyItem::JumpType::OutOfFunction);
+				}
+			));
+			// The return tag is consumed by the subroutine.
+			m_context.adjustStackOffset(-1);
+			m_context << returnTag;
+			// Continue behind the placeholder.
+			++m_modifierDepth;
+			appendModifierOrFunctionCode();
+			--m_modifierDepth;
+			return;
+		}
+
 		solAssert(modifier.parameters().size() == modifierInvocation->arguments().size(), "");
 		for (unsigned i = 0; i < modifier.parameters().size(); ++i)
 		{
@@ -34,9 +34,20 @@ namespace solidity {
 class Compiler: private ASTConstVisitor
 {
 public:
-	explicit Compiler(bool _optimize = false, unsigned _runs = 200):
+	explicit Compiler(
+		bool _optimize = false,
+		unsigned _runs = 200,
+		FunctionCodeCache* _codeCache = nullptr,
+		bool _sharedConversionRoutines = false,
+		bool _lazyCalldataDecoding = false,
+		bool _sharedModifierBodies = false
+	):
 		m_optimize(_optimize),
 		m_optimizeRuns(_runs),
+		m_codeCache(_codeCache),
+		m_sharedConversionRoutines(_sharedConversionRoutines),
+		m_lazyCalldataDecoding(_lazyCalldataDecoding),
+		m_sharedModifierBodies(_sharedModifierBodies),
 		m_returnTag(m_context.newTag())
 	{ }
 
@@ -83,6 +94,16 @@ private:
 	void appendBaseConstructor(FunctionDefinition const& _constructor);
 	void appendConstructor(FunctionDefinition const& _constructor);
 	void appendFunctionSelector(ContractDefinition const& _contract);
+	/// Appends dispatch code for the sorted selector range [@a _begin, @a _end) of @a _selectors
+	/// using binary search, expecting the function hash on the stack. Small ranges are emitted
+	/// as a linear sequence of comparisons ending in a jump to @a _notFound.
+	void appendSelectorSearch(
+		std::vector<FixedHash<4>> const& _selectors,
+		size_t _begin,
+		size_t _end,
+		std::map<FixedHash<4>, eth::AssemblyItem const> const& _entryPoints,
+		eth::AssemblyItem const& _notFound
+	);
 	/// Creates code that unpacks the arguments for the given function represented by a vector of TypePointers.
 	/// From memory if @a _fromMemory is true, otherwise from call data.
 	/// Expects source offset on the stack, which is removed.
@@ -122,11 +143,35 @@ private:
 	void appendStackVariableInitialisation(VariableDeclaration const& _variable);
 	void compileExpression(Expression const& _expression, TypePointer const& _targetType = TypePointer());
 
+	/// Loop-invariant expressions evaluated into stack slots before a loop.
+	struct HoistedInvariants
+	{
+		/// Expressions owning a stack slot, in the order their slots were pushed.
+		std::vector<Expression const*> slots;
+		/// All registered expressions, including those that share the slot of an equivalent one.
+		std::vector<Expression const*> registered;
+	};
+	/// Scans the given parts of a loop (null entries are ignored) for expressions that
+	/// evaluate to the same value on every iteration, evaluates them into fresh stack
+	/// slots and registers them with the compiler context so that their uses inside the
+	/// loop duplicate the slot instead of re-evaluating the expression.
+	HoistedInvariants hoistLoopInvariants(std::vector<ASTNode const*> const& _loopParts);
+	/// Removes the registrations of the given hoisted expressions and pops their slots.
+	void unhoistLoopInvariants(HoistedInvariants const& _hoisted);
+
 	/// @returns the runtime assembly for clone contracts.
 	static eth::Assembly cloneRuntime();
 
 	bool const m_optimize;
 	unsigned const m_optimizeRuns;
+	/// Cache of generated function code shared across contracts, not owned. Can be nullptr.
+	FunctionCodeCache* m_codeCache = nullptr;
+	/// Whether large type conversions are emitted as shared subroutines.
+	bool const m_sharedConversionRoutines = false;
+	/// Whether external functions may leave their arguments in calldata until first use.
+	bool const m_lazyCalldataDecoding = false;
+	/// Whether eligible modifier bodies are compiled once per contract as subroutines.
+	bool const m_sharedModifierBodies = false;
 	CompilerContext m_context;
 	size_t m_runtimeSub = size_t(-1); ///< Identifier of the runtime sub-assembly
 	CompilerContext m_runtimeContext;
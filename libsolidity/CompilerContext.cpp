@@ -34,6 +34,34 @@ namespace dev
 namespace solidity
 {
 
+namespace
+{
+
+bool isSwap(eth::AssemblyItem const& _item)
+{
+	if (_item.type() != eth::Operation)
+		return false;
+	eth::Instruction instruction = eth::Instruction(static_cast<unsigned>(_item.data()));
+	return eth::Instruction::SWAP1 <= instruction && instruction <= eth::Instruction::SWAP16;
+}
+
+bool isDup(eth::AssemblyItem const& _item)
+{
+	if (_item.type() != eth::Operation)
+		return false;
+	eth::Instruction instruction = eth::Instruction(static_cast<unsigned>(_item.data()));
+	return eth::Instruction::DUP1 <= instruction && instruction <= eth::Instruction::DUP16;
+}
+
+bool isInstruction(eth::AssemblyItem const& _item, eth::Instruction _instruction)
+{
+	return
+		_item.type() == eth::Operation &&
+		eth::Instruction(static_cast<unsigned>(_item.data())) == _instruction;
+}
+
+}
+
 void CompilerContext::addMagicGlobal(MagicVariableDeclaration const& _declaration)
 {
 	m_magicGlobals.insert(&_declaration);
@@ -61,12 +89,55 @@ void CompilerContext::addVariable(VariableDeclaration const& _declaration,
 	m_localVariables[&_declaration] = unsigned(m_asm.deposit()) - _offsetToCurrent;
 }
 
+void CompilerContext::addCalldataVariable(VariableDeclaration const& _declaration, unsigned _calldataOffset)
+{
+	m_calldataVariables[&_declaration] = _calldataOffset;
+}
+
 void CompilerContext::removeVariable(VariableDeclaration const& _declaration)
 {
+	if (m_calldataVariables.count(&_declaration))
+	{
+		m_calldataVariables.erase(&_declaration);
+		return;
+	}
 	solAssert(!!m_localVariables.count(&_declaration), "");
 	m_localVariables.erase(&_declaration);
 }
 
+void CompilerContext::addHoistedExpression(Expression const& _expression)
+{
+	solAssert(m_asm.deposit() > 0, "");
+	m_hoistedExpressions[&_expression] = unsigned(m_asm.deposit()) - 1;
+}
+
+void CompilerContext::addHoistedExpressionAlias(Expression const& _expression, Expression const& _existing)
+{
+	auto existing = m_hoistedExpressions.find(&_existing);
+	solAssert(existing != m_hoistedExpressions.end(), "Alias of expression that was not hoisted.");
+	m_hoistedExpressions[&_expression] = existing->second;
+}
+
+void CompilerContext::removeHoistedExpression(Expression const& _expression)
+{
+	solAssert(!!m_hoistedExpressions.count(&_expression), "");
+	m_hoistedExpressions.erase(&_expression);
+}
+
+void CompilerContext::appendHoistedValue(Expression const& _expression)
+{
+	auto res = m_hoistedExpressions.find(&_expression);
+	solAssert(res != m_hoistedExpressions.end(), "Expression was not hoisted.");
+	unsigned stackPos = baseToCurrentStackOffset(res->second);
+	if (stackPos + 1 > 16) //@todo correct this by fetching earlier or moving to memory
+		BOOST_THROW_EXCEPTION(
+			CompilerError() <<
+			errinfo_sourceLocation(_expression.location()) <<
+			errinfo_comment("Stack too deep, try removing local variables.")
+		);
+	*this << eth::dupInstruction(stackPos + 1);
+}
+
 eth::Assembly const& CompilerContext::compiledContract(const ContractDefinition& _contract) const
 {
 	auto ret = m_compiledContracts.find(&_contract);
@@ -86,6 +157,9 @@ eth::AssemblyItem CompilerContext::functionEntryLabel(Declaration const& _declar
 	{
 		eth::AssemblyItem tag(m_asm.newTag());
 		m_functionEntryLabels.insert(make_pair(&_declaration, tag));
+		// Requesting a label amounts to referencing the function from reachable code,
+		// so this is the only place where functions are queued for compilation.
+		m_functionCompilationQueue.push(&_declaration);
 		return tag.tag();
 	}
 	else
@@ -98,6 +172,26 @@ eth::AssemblyItem CompilerContext::functionEntryLabelIfExists(Declaration const&
 	return res == m_functionEntryLabels.end() ? eth::AssemblyItem(eth::UndefinedItem) : res->second.tag();
 }
 
+void CompilerContext::setInheritanceHierarchy(vector<ContractDefinition const*> const& _hierarchy)
+{
+	m_inheritanceHierarchy = _hierarchy;
+	// Precompute the resolution table for every linearization point, so that virtual
+	// function and super lookups are a single map access per call site instead of a walk
+	// over the hierarchy with argument type comparisons against every defined function.
+	// Building from the base towards the derived end lets each contract overlay - and
+	// thereby override - the resolutions of the contracts above it.
+	m_virtualResolutionTables.assign(_hierarchy.size(), map<string, FunctionDefinition const*>());
+	for (size_t i = _hierarchy.size(); i > 0; --i)
+	{
+		map<string, FunctionDefinition const*>& table = m_virtualResolutionTables[i - 1];
+		if (i < _hierarchy.size())
+			table = m_virtualResolutionTables[i];
+		for (ASTPointer<FunctionDefinition> const& function: _hierarchy[i - 1]->definedFunctions())
+			if (!function->isConstructor())
+				table[virtualFunctionSignature(*function)] = function.get();
+	}
+}
+
 eth::AssemblyItem CompilerContext::virtualFunctionEntryLabel(FunctionDefinition const& _function)
 {
 	solAssert(!m_inheritanceHierarchy.empty(), "No inheritance hierarchy set.");
@@ -120,13 +214,205 @@ FunctionDefinition const* CompilerContext::nextConstructor(ContractDefinition co
 	return nullptr;
 }
 
-set<Declaration const*> CompilerContext::functionsWithoutCode()
+Declaration const* CompilerContext::nextFunctionToCompile()
+{
+	while (!m_functionCompilationQueue.empty() && m_functionsWithCode.count(m_functionCompilationQueue.front()))
+		m_functionCompilationQueue.pop();
+	return m_functionCompilationQueue.empty() ? nullptr : m_functionCompilationQueue.front();
+}
+
+bool CompilerContext::replayCachedFunction(Declaration const& _function)
+{
+	if (!m_functionCodeCache)
+		return false;
+	lock_guard<mutex> guard(m_functionCodeCache->mutex);
+	auto it = m_functionCodeCache->entries.find(&_function);
+	if (it == m_functionCodeCache->entries.end())
+		return false;
+	CachedFunctionCode const& code = it->second;
+	// The cached items are only valid if the parts of the context they were generated
+	// against look the same in this assembly.
+	for (auto const& resolution: code.virtualResolutions)
+		if (resolveVirtualFunction(*resolution.first) != resolution.second)
+			return false;
+	for (auto const& variable: code.stateVariables)
+	{
+		auto position = m_stateVariables.find(variable.first);
+		if (position == m_stateVariables.end() || position->second != variable.second)
+			return false;
+	}
+
+	m_functionsWithCode.insert(&_function);
+	map<u256, eth::AssemblyItem> localTags;
+	for (u256 const& tag: code.localTags)
+		localTags.insert(make_pair(tag, m_asm.newTag()));
+	for (eth::AssemblyItem const& item: code.items)
+		if (item.type() == eth::Tag || item.type() == eth::PushTag)
+		{
+			eth::AssemblyItem target(eth::UndefinedItem);
+			auto entryLabel = code.entryLabels.find(item.data());
+			if (entryLabel != code.entryLabels.end())
+				// This also queues the referenced function for compilation in this assembly.
+				target = functionEntryLabel(*entryLabel->second);
+			else if (item.data() == code.errorTag)
+				target = errorTag();
+			else
+				target = localTags.at(item.data());
+			m_asm.append(item.type() == eth::Tag ? target.tag() : target.pushTag());
+		}
+		else
+			m_asm.append(item);
+	return true;
+}
+
+void CompilerContext::cacheFunctionCode(
+	Declaration const& _function,
+	size_t _firstItem,
+	u256 const& _firstLocalTag,
+	vector<pair<FunctionDefinition const*, FunctionDefinition const*>> _virtualResolutions,
+	vector<pair<Declaration const*, pair<u256, unsigned>>> _stateVariables
+)
+{
+	if (!m_functionCodeCache)
+		return;
+	lock_guard<mutex> guard(m_functionCodeCache->mutex);
+	if (m_functionCodeCache->entries.count(&_function))
+		return;
+	map<u256, Declaration const*> labelIds;
+	for (auto const& label: m_functionEntryLabels)
+		labelIds[label.second.data()] = label.first;
+	u256 const errorTagId = errorTag().data();
+	set<u256> routineTagIds;
+	for (auto const& routine: m_sharedRoutineTags)
+		routineTagIds.insert(routine.second.data());
+
+	CachedFunctionCode code;
+	eth::AssemblyItems const& items = m_asm.items();
+	for (size_t i = _firstItem; i < items.size(); ++i)
+	{
+		eth::AssemblyItem const& item = items[i];
+		switch (item.type())
+		{
+		case eth::Operation:
+		case eth::Push:
+			break;
+		case eth::Tag:
+		case eth::PushTag:
+		{
+			auto label = labelIds.find(item.data());
+			if (label != labelIds.end())
+				code.entryLabels[item.data()] = label->second;
+			else if (item.data() == errorTagId)
+				break; // translated to the target assembly's error tag on replay
+			else if (routineTagIds.count(item.data()))
+				return; // shared routine entries are local to this assembly, cannot relocate
+			else if (item.data() >= _firstLocalTag)
+				code.localTags.insert(item.data());
+			else
+				return; // reference to an unrelated tag of this assembly, cannot relocate
+			break;
+		}
+		default:
+			// data, string, subassembly and library references are local to this assembly
+			return;
+		}
+		code.items.push_back(item);
+	}
+	code.errorTag = errorTagId;
+	code.virtualResolutions = move(_virtualResolutions);
+	code.stateVariables = move(_stateVariables);
+	m_functionCodeCache->entries[&_function] = move(code);
+}
+
+CompilerContext::SharedRoutineState CompilerContext::sharedRoutineState(string const& _name) const
+{
+	if (m_sharedRoutineTags.count(_name))
+		return SharedRoutineState::Shared;
+	if (m_inlineRoutines.count(_name))
+		return SharedRoutineState::Inline;
+	return SharedRoutineState::Unknown;
+}
+
+void CompilerContext::recordSharedRoutine(
+	string const& _name,
+	size_t _items,
+	function<void(CompilerContext&)> const& _generator
+)
+{
+	// Below this size, the call sequence plus the routine epilogue cost more
+	// bytes than inlining the code at every call site would.
+	size_t const c_sharedRoutineMinItems = 5;
+	if (_items < c_sharedRoutineMinItems)
+		m_inlineRoutines.insert(_name);
+	else
+	{
+		m_sharedRoutineTags.insert(make_pair(_name, m_asm.newTag()));
+		m_pendingSharedRoutines.push(make_pair(_name, _generator));
+	}
+}
+
+eth::AssemblyItem CompilerContext::sharedRoutineTag(
+	string const& _name,
+	function<void(CompilerContext&)> const& _generator
+)
+{
+	auto tag = m_sharedRoutineTags.find(_name);
+	if (tag == m_sharedRoutineTags.end())
+	{
+		tag = m_sharedRoutineTags.insert(make_pair(_name, m_asm.newTag())).first;
+		m_pendingSharedRoutines.push(make_pair(_name, _generator));
+	}
+	return tag->second;
+}
+
+void CompilerContext::callSharedRoutine(string const& _name)
+{
+	// Stack at the call site: [... x], inside the routine: [... returnTag x].
+	eth::AssemblyItem returnTag = pushNewTag();
+	*this << eth::Instruction::SWAP1;
+	appendJumpTo(m_sharedRoutineTags.at(_name));
+	*this << returnTag;
+}
+
+bool CompilerContext::appendPendingSharedRoutine()
+{
+	if (m_pendingSharedRoutines.empty())
+		return false;
+	auto routine = m_pendingSharedRoutines.front();
+	m_pendingSharedRoutines.pop();
+	*this << m_sharedRoutineTags.at(routine.first);
+	m_suppressSharedRoutines = true;
+	routine.second(*this);
+	m_suppressSharedRoutines = false;
+	return true;
+}
+
+int CompilerContext::cachedSlotHashOffset(string const& _fingerprint) const
+{
+	auto it = m_slotHashCache.find(_fingerprint);
+	if (it != m_slotHashCache.end() && it->second.valid)
+		return int(it->second.offset);
+	return -1;
+}
+
+int CompilerContext::assignSlotHashCache(string const& _fingerprint)
+{
+	auto it = m_slotHashCache.find(_fingerprint);
+	if (it == m_slotHashCache.end())
+	{
+		if (m_slotHashCache.size() >= slotHashCacheSlots)
+			return -1;
+		SlotHashCacheEntry entry{unsigned(m_slotHashCache.size()), false};
+		it = m_slotHashCache.insert(make_pair(_fingerprint, entry)).first;
+	}
+	it->second.valid = true;
+	return int(it->second.offset);
+}
+
+void CompilerContext::invalidateSlotHashCache()
 {
-	set<Declaration const*> functions;
-	for (auto const& it: m_functionEntryLabels)
-		if (m_functionsWithCode.count(it.first) == 0)
-			functions.insert(it.first);
-	return functions;
+	for (auto& entry: m_slotHashCache)
+		entry.second.valid = false;
 }
 
 ModifierDefinition const& CompilerContext::functionModifier(string const& _name) const
@@ -142,8 +428,14 @@ ModifierDefinition const& CompilerContext::functionModifier(string const& _name)
 
 unsigned CompilerContext::baseStackOffsetOfVariable(Declaration const& _declaration) const
 {
-	auto res = m_localVariables.find(&_declaration);
-	solAssert(res != m_localVariables.end(), "Variable not found on stack.");
+	solAssert(m_localVariables.count(&_declaration), "Variable not found on stack.");
+	return m_localVariables.at(&_declaration);
+}
+
+unsigned CompilerContext::calldataOffsetOfVariable(Declaration const& _declaration) const
+{
+	auto res = m_calldataVariables.find(&_declaration);
+	solAssert(res != m_calldataVariables.end(), "Variable not found in calldata.");
 	return res->second;
 }
 
@@ -164,6 +456,17 @@ pair<u256, unsigned> CompilerContext::storageLocationOfVariable(const Declaratio
 	return it->second;
 }
 
+CompilerContext& CompilerContext::appendItems(eth::AssemblyItems const& _items)
+{
+	flushPendingStackOps();
+	for (eth::AssemblyItem const& item: _items)
+	{
+		solAssert(item.type() != eth::Tag, "Tags cannot be bulk-appended.");
+		m_asm.append(item);
+	}
+	return *this;
+}
+
 CompilerContext& CompilerContext::appendJump(eth::AssemblyItem::JumpType _jumpType)
 {
 	eth::AssemblyItem item(eth::Instruction::JUMP);
@@ -191,19 +494,44 @@ eth::AssemblyItem CompilerContext::virtualFunctionEntryLabel(
 	vector<ContractDefinition const*>::const_iterator _searchStart
 )
 {
-	string name = _function.name();
-	FunctionType functionType(_function);
-	auto it = _searchStart;
-	for (; it != m_inheritanceHierarchy.end(); ++it)
-		for (ASTPointer<FunctionDefinition> const& function: (*it)->definedFunctions())
-			if (
-				function->name() == name &&
-				!function->isConstructor() &&
-				FunctionType(*function).hasEqualArgumentTypes(functionType)
-			)
-				return functionEntryLabel(*function);
-	solAssert(false, "Super function " + name + " not found.");
-	return m_asm.newTag(); // not reached
+	return functionEntryLabel(*resolveVirtualFunction(_function, _searchStart));
+}
+
+FunctionDefinition const* CompilerContext::resolveVirtualFunction(FunctionDefinition const& _function)
+{
+	solAssert(!m_inheritanceHierarchy.empty(), "No inheritance hierarchy set.");
+	return resolveVirtualFunction(_function, m_inheritanceHierarchy.begin());
+}
+
+FunctionDefinition const* CompilerContext::resolveVirtualFunction(
+	FunctionDefinition const& _function,
+	vector<ContractDefinition const*>::const_iterator _searchStart
+)
+{
+	size_t const index = size_t(_searchStart - m_inheritanceHierarchy.begin());
+	if (index < m_virtualResolutionTables.size())
+	{
+		auto const& table = m_virtualResolutionTables[index];
+		auto res = table.find(virtualFunctionSignature(_function));
+		if (res != table.end())
+			return res->second;
+	}
+	solAssert(false, "Super function " + _function.name() + " not found.");
+	return nullptr; // not reached
+}
+
+string const& CompilerContext::virtualFunctionSignature(FunctionDefinition const& _function)
+{
+	auto res = m_virtualFunctionSignatures.find(&_function);
+	if (res == m_virtualFunctionSignatures.end())
+	{
+		// The same key as hasEqualArgumentTypes would compare: name plus argument types.
+		string signature = _function.name();
+		for (TypePointer const& type: FunctionType(_function).parameterTypes())
+			signature += " " + type->toString(false);
+		res = m_virtualFunctionSignatures.insert(make_pair(&_function, signature)).first;
+	}
+	return res->second;
 }
 
 vector<ContractDefinition const*>::const_iterator CompilerContext::superContract(ContractDefinition const& _contract) const
@@ -214,6 +542,56 @@ vector<ContractDefinition const*>::const_iterator CompilerContext::superContract
 	return ++it;
 }
 
+bool CompilerContext::bufferStackOp(eth::AssemblyItem const& _item)
+{
+	if (!m_pendingStackOps.empty())
+	{
+		eth::AssemblyItem const pending = m_pendingStackOps.back();
+		// Two identical SWAPs restore the original stack.
+		if (isSwap(pending) && isSwap(_item) && pending.data() == _item.data())
+		{
+			m_pendingStackOps.pop_back();
+			return true;
+		}
+		// A value duplicated or pushed just to be popped again.
+		if (
+			(isDup(pending) || pending.type() == eth::Push) &&
+			isInstruction(_item, eth::Instruction::POP)
+		)
+		{
+			m_pendingStackOps.pop_back();
+			m_asm.adjustDeposit(-1);
+			return true;
+		}
+		// Swapping two copies of the same value has no effect.
+		if (isInstruction(pending, eth::Instruction::DUP1) && isInstruction(_item, eth::Instruction::SWAP1))
+			return true;
+		flushPendingStackOps();
+	}
+	if (isSwap(_item) || isDup(_item) || _item.type() == eth::Push)
+	{
+		// Account for the stack effect already now so that the tracked stack height
+		// stays exact while the item is buffered.
+		m_pendingStackOps.push_back(_item);
+		m_asm.adjustDeposit(isSwap(_item) ? 0 : 1);
+		return true;
+	}
+	return false;
+}
+
+void CompilerContext::flushPendingStackOps()
+{
+	for (eth::AssemblyItem const& item: m_pendingStackOps)
+	{
+		// The deposit change was accounted for when the item was buffered; cancel it
+		// before the append applies it again.
+		if (!isSwap(item))
+			m_asm.adjustDeposit(-1);
+		m_asm.append(item);
+	}
+	m_pendingStackOps.clear();
+}
+
 void CompilerContext::updateSourceLocation()
 {
 	m_asm.setSourceLocation(m_visitedNodes.empty() ? SourceLocation() : m_visitedNodes.top()->location());
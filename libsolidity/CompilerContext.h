@@ -22,12 +22,16 @@
 
 #pragma once
 
+#include <functional>
+#include <mutex>
 #include <ostream>
+#include <queue>
 #include <stack>
 #include <utility>
 #include <libevmcore/Instruction.h>
 #include <libevmasm/Assembly.h>
 #include <libsolidity/ASTForward.h>
+#include <libsolidity/ASTNodeMap.h>
 #include <libsolidity/Types.h>
 #include <libsolidity/ASTAnnotations.h>
 #include <libdevcore/Common.h>
@@ -36,6 +40,38 @@ namespace dev {
 namespace solidity {
 
 
+/**
+ * Assembly items cached for one function body together with the fingerprint of the parts
+ * of the compilation context the code was generated against. Tags are recorded by their
+ * id in the source assembly and translated on replay.
+ */
+struct CachedFunctionCode
+{
+	eth::AssemblyItems items;
+	/// Ids of tags created while compiling the body; they receive fresh tags when replayed.
+	std::set<u256> localTags;
+	/// Ids of tags that are the entry labels of the given declarations.
+	std::map<u256, Declaration const*> entryLabels;
+	/// Id of the error tag of the source assembly.
+	u256 errorTag;
+	/// Virtual function resolution the code was generated with: references to @a first
+	/// resolved to @a second. Reuse requires the same resolution.
+	std::vector<std::pair<FunctionDefinition const*, FunctionDefinition const*>> virtualResolutions;
+	/// Storage locations of the state variables referenced by the body.
+	std::vector<std::pair<Declaration const*, std::pair<u256, unsigned>>> stateVariables;
+};
+
+/**
+ * Cache of the code generated for function bodies, shared between the compilation of several
+ * contracts of one source unit so that the body of an inherited function is only lowered once.
+ */
+struct FunctionCodeCache
+{
+	std::map<Declaration const*, CachedFunctionCode> entries;
+	/// Serializes access when contracts are compiled in parallel.
+	std::mutex mutex;
+};
+
 /**
  * Context to be shared by all units that compile the same contract.
  * It stores the generated bytecode and the position of identifiers in memory and on the stack.
@@ -46,8 +82,22 @@ public:
 	void addMagicGlobal(MagicVariableDeclaration const& _declaration);
 	void addStateVariable(VariableDeclaration const& _declaration, u256 const& _storageOffset, unsigned _byteOffset);
 	void addVariable(VariableDeclaration const& _declaration, unsigned _offsetToCurrent = 0);
+	/// Registers @a _declaration as a function argument that stays in calldata at the given
+	/// (padded) offset and is only loaded at its use sites (see markLazyCalldataFunction).
+	void addCalldataVariable(VariableDeclaration const& _declaration, unsigned _calldataOffset);
 	void removeVariable(VariableDeclaration const& _declaration);
 
+	/// Records that the value of @a _expression is held by the stack slot currently on top,
+	/// so that uses of the expression duplicate the slot instead of re-evaluating it
+	/// (see Compiler::hoistLoopInvariants).
+	void addHoistedExpression(Expression const& _expression);
+	/// Records that @a _expression shares the stack slot of the already hoisted @a _existing.
+	void addHoistedExpressionAlias(Expression const& _expression, Expression const& _existing);
+	void removeHoistedExpression(Expression const& _expression);
+	bool isHoistedExpression(Expression const& _expression) const { return m_hoistedExpressions.count(&_expression) != 0; }
+	/// Appends a DUP retrieving the hoisted value of @a _expression.
+	void appendHoistedValue(Expression const& _expression);
+
 	void setCompiledContracts(std::map<ContractDefinition const*, eth::Assembly const*> const& _contracts) { m_compiledContracts = _contracts; }
 	eth::Assembly const& compiledContract(ContractDefinition const& _contract) const;
 
@@ -58,13 +108,21 @@ public:
 	bool isMagicGlobal(Declaration const* _declaration) const { return m_magicGlobals.count(_declaration) != 0; }
 	bool isLocalVariable(Declaration const* _declaration) const;
 	bool isStateVariable(Declaration const* _declaration) const { return m_stateVariables.count(_declaration) != 0; }
+	bool isCalldataVariable(Declaration const* _declaration) const { return m_calldataVariables.count(_declaration) != 0; }
+
+	/// Marks @a _function as entered from the function selector without decoding its arguments,
+	/// i.e. its parameters stay in calldata and are loaded at their first use.
+	void markLazyCalldataFunction(Declaration const& _function) { m_lazyCalldataFunctions.insert(&_function); }
+	bool isLazyCalldataFunction(Declaration const* _function) const { return m_lazyCalldataFunctions.count(_function) != 0; }
 
 	/// @returns the entry label of the given function and creates it if it does not exist yet.
 	eth::AssemblyItem functionEntryLabel(Declaration const& _declaration);
 	/// @returns the entry label of the given function. Might return an AssemblyItem of type
 	/// UndefinedItem if it does not exist yet.
 	eth::AssemblyItem functionEntryLabelIfExists(Declaration const& _declaration) const;
-	void setInheritanceHierarchy(std::vector<ContractDefinition const*> const& _hierarchy) { m_inheritanceHierarchy = _hierarchy; }
+	/// Sets the inheritance hierarchy and precomputes the virtual function resolution
+	/// tables used by resolveVirtualFunction.
+	void setInheritanceHierarchy(std::vector<ContractDefinition const*> const& _hierarchy);
 	/// @returns the entry label of the given function and takes overrides into account.
 	eth::AssemblyItem virtualFunctionEntryLabel(FunctionDefinition const& _function);
 	/// @returns the entry label of a function that overrides the given declaration from the most derived class just
@@ -72,15 +130,88 @@ public:
 	eth::AssemblyItem superFunctionEntryLabel(FunctionDefinition const& _function, ContractDefinition const& _base);
 	FunctionDefinition const* nextConstructor(ContractDefinition const& _contract) const;
 
-	/// @returns the set of functions for which we still need to generate code
-	std::set<Declaration const*> functionsWithoutCode();
+	/// @returns the next function in the queue of functions that are still to be compiled
+	/// (i.e. that were referenced during code generation but where we did not yet generate
+	/// code for them). Returns nullptr if the queue is empty. Does not remove the function
+	/// from the queue, that will only be done by startFunction below.
+	/// Only functions that are reachable this way - transitively from the external interface,
+	/// the constructors and the fallback function - end up in the assembly at all.
+	Declaration const* nextFunctionToCompile();
 	/// Resets function specific members, inserts the function entry label and marks the function
 	/// as "having code".
 	void startFunction(Declaration const& _function);
 
+	/// Sets the cache used to share generated function code between contracts, can be nullptr.
+	void setFunctionCodeCache(FunctionCodeCache* _cache) { m_functionCodeCache = _cache; }
+	FunctionCodeCache* functionCodeCache() const { return m_functionCodeCache; }
+	/// @returns the function that a reference to @a _function resolves to in the current
+	/// inheritance hierarchy, taking overrides into account.
+	FunctionDefinition const* resolveVirtualFunction(FunctionDefinition const& _function);
+	/// Appends the cached code for @a _function if there is any and the fingerprint it was
+	/// generated against still matches this context. @returns false otherwise.
+	bool replayCachedFunction(Declaration const& _function);
+	/// Stores the items generated for @a _function, starting at item index @a _firstItem, in
+	/// the code cache. Tags with ids from @a _firstLocalTag on count as created by the body.
+	/// Does nothing if the items reference parts of the assembly that cannot be relocated.
+	void cacheFunctionCode(
+		Declaration const& _function,
+		size_t _firstItem,
+		u256 const& _firstLocalTag,
+		std::vector<std::pair<FunctionDefinition const*, FunctionDefinition const*>> _virtualResolutions,
+		std::vector<std::pair<Declaration const*, std::pair<u256, unsigned>>> _stateVariables
+	);
+
+	///@{
+	///@name Shared subroutines
+	/// Enables emitting large type conversion sequences once as internal subroutines that
+	/// call sites jump to, instead of inlining them at every occurrence.
+	void setSharedRoutines(bool _enabled) { m_sharedRoutinesEnabled = _enabled; }
+	/// @returns true if shared subroutines may currently be used.
+	bool sharedRoutinesEnabled() const { return m_sharedRoutinesEnabled && !m_suppressSharedRoutines; }
+	/// Suppresses shared subroutine usage, e.g. while measuring or generating a routine body.
+	void setSuppressSharedRoutines(bool _suppress) { m_suppressSharedRoutines = _suppress; }
+	/// State of the routine @a _name: not measured yet, always inlined, or shared.
+	enum class SharedRoutineState { Unknown, Inline, Shared };
+	SharedRoutineState sharedRoutineState(std::string const& _name) const;
+	/// Records the measured item count of the code for @a _name. Bodies that are large
+	/// enough to amortize the call sequence become subroutines for subsequent call sites.
+	void recordSharedRoutine(
+		std::string const& _name,
+		size_t _items,
+		std::function<void(CompilerContext&)> const& _generator
+	);
+	/// Unconditionally registers @a _name as a shared routine (if it is not one already)
+	/// and @returns its entry tag. The generator has to set the stack offset it expects,
+	/// emit the full body and end with the jump that leaves the routine.
+	eth::AssemblyItem sharedRoutineTag(
+		std::string const& _name,
+		std::function<void(CompilerContext&)> const& _generator
+	);
+	/// Appends a call to the shared routine @a _name, which transforms the top stack element.
+	void callSharedRoutine(std::string const& _name);
+	/// Generates the body of one pending shared routine, @returns false if there is none left.
+	bool appendPendingSharedRoutine();
+	///@}
+
+	///@{
+	///@name Storage slot hash cache
+	/// Memory words directly after the free memory pointer that cache mapping slot hashes
+	/// of execution-stable keys within straight-line code, so repeated accesses skip the
+	/// SHA3. Entries become invalid at every tag, i.e. at control flow merge points.
+	/// Number of memory words reserved for the slot hash cache.
+	static size_t const slotHashCacheSlots = 4;
+	/// @returns the cache word index holding a still-valid hash for @a _fingerprint, or -1.
+	int cachedSlotHashOffset(std::string const& _fingerprint) const;
+	/// Marks the hash for @a _fingerprint as cached (assigning a reserved word on first
+	/// use) and @returns its cache word index, or -1 if all words are taken.
+	int assignSlotHashCache(std::string const& _fingerprint);
+	///@}
+
 	ModifierDefinition const& functionModifier(std::string const& _name) const;
 	/// Returns the distance of the given local variable from the bottom of the stack (of the current function).
 	unsigned baseStackOffsetOfVariable(Declaration const& _declaration) const;
+	/// Returns the calldata offset of a variable registered via addCalldataVariable.
+	unsigned calldataOffsetOfVariable(Declaration const& _declaration) const;
 	/// If supplied by a value returned by @ref baseStackOffsetOfVariable(variable), returns
 	/// the distance of that variable from the current top of the stack.
 	unsigned baseToCurrentStackOffset(unsigned _baseOffset) const;
@@ -91,30 +222,34 @@ public:
 	std::pair<u256, unsigned> storageLocationOfVariable(Declaration const& _declaration) const;
 
 	/// Appends a JUMPI instruction to a new tag and @returns the tag
-	eth::AssemblyItem appendConditionalJump() { return m_asm.appendJumpI().tag(); }
+	eth::AssemblyItem appendConditionalJump() { flushPendingStackOps(); return m_asm.appendJumpI().tag(); }
 	/// Appends a JUMPI instruction to @a _tag
-	CompilerContext& appendConditionalJumpTo(eth::AssemblyItem const& _tag) { m_asm.appendJumpI(_tag); return *this; }
+	CompilerContext& appendConditionalJumpTo(eth::AssemblyItem const& _tag) { flushPendingStackOps(); m_asm.appendJumpI(_tag); return *this; }
 	/// Appends a JUMP to a new tag and @returns the tag
-	eth::AssemblyItem appendJumpToNew() { return m_asm.appendJump().tag(); }
+	eth::AssemblyItem appendJumpToNew() { flushPendingStackOps(); return m_asm.appendJump().tag(); }
 	/// Appends a JUMP to a tag already on the stack
 	CompilerContext&  appendJump(eth::AssemblyItem::JumpType _jumpType = eth::AssemblyItem::JumpType::Ordinary);
 	/// Returns an "ErrorTag"
 	eth::AssemblyItem errorTag() { return m_asm.errorTag(); }
 	/// Appends a JUMP to a specific tag
-	CompilerContext& appendJumpTo(eth::AssemblyItem const& _tag) { m_asm.appendJump(_tag); return *this; }
+	CompilerContext& appendJumpTo(eth::AssemblyItem const& _tag) { flushPendingStackOps(); m_asm.appendJump(_tag); return *this; }
 	/// Appends pushing of a new tag and @returns the new tag.
-	eth::AssemblyItem pushNewTag() { return m_asm.append(m_asm.newPushTag()).tag(); }
+	eth::AssemblyItem pushNewTag() { flushPendingStackOps(); return m_asm.append(m_asm.newPushTag()).tag(); }
 	/// @returns a new tag without pushing any opcodes or data
 	eth::AssemblyItem newTag() { return m_asm.newTag(); }
 	/// Adds a subroutine to the code (in the data section) and pushes its size (via a tag)
 	/// on the stack. @returns the assembly item corresponding to the pushed subroutine, i.e. its offset.
-	eth::AssemblyItem addSubroutine(eth::Assembly const& _assembly) { return m_asm.appendSubSize(_assembly); }
+	eth::AssemblyItem addSubroutine(eth::Assembly const& _assembly) { flushPendingStackOps(); return m_asm.appendSubSize(_assembly); }
 	/// Pushes the size of the final program
-	void appendProgramSize() { return m_asm.appendProgramSize(); }
+	void appendProgramSize() { flushPendingStackOps(); return m_asm.appendProgramSize(); }
 	/// Adds data to the data section, pushes a reference to the stack
-	eth::AssemblyItem appendData(bytes const& _data) { return m_asm.append(_data); }
+	eth::AssemblyItem appendData(bytes const& _data) { flushPendingStackOps(); return m_asm.append(_data); }
+	/// Records a use of the given constant data and @returns true if it was used before,
+	/// i.e. routing this use through the data section (appendData stores identical blobs
+	/// only once) deduplicates it instead of emitting the data inline again.
+	bool constantDataSeen(bytes const& _data) { return !m_seenConstants.insert(_data).second; }
 	/// Appends the address (virtual, will be filled in by linker) of a library.
-	void appendLibraryAddress(std::string const& _identifier) { m_asm.appendLibraryAddress(_identifier); }
+	void appendLibraryAddress(std::string const& _identifier) { flushPendingStackOps(); m_asm.appendLibraryAddress(_identifier); }
 	/// Resets the stack of visited nodes with a new stack having only @c _node
 	void resetVisitedNodes(ASTNode const* _node);
 	/// Pops the stack of visited nodes
@@ -123,15 +258,37 @@ public:
 	void pushVisitedNodes(ASTNode const* _node) { m_visitedNodes.push(_node); updateSourceLocation(); }
 
 	/// Append elements to the current instruction list and adjust @a m_stackOffset.
-	CompilerContext& operator<<(eth::AssemblyItem const& _item) { m_asm.append(_item); return *this; }
-	CompilerContext& operator<<(eth::Instruction _instruction) { m_asm.append(_instruction); return *this; }
-	CompilerContext& operator<<(u256 const& _value) { m_asm.append(_value); return *this; }
-	CompilerContext& operator<<(bytes const& _data) { m_asm.append(_data); return *this; }
+	CompilerContext& operator<<(eth::AssemblyItem const& _item)
+	{
+		// Plain stack shuffles are buffered briefly so that sequences that cancel out
+		// (e.g. SWAP1 SWAP1 or DUP1 POP) never reach the assembly.
+		if (bufferStackOp(_item))
+			return *this;
+		// A tag is a potential control flow merge point, where cached slot hashes
+		// might not have been computed on all incoming paths.
+		if (_item.type() == eth::Tag && !m_slotHashCache.empty())
+			invalidateSlotHashCache();
+		m_asm.append(_item);
+		return *this;
+	}
+	CompilerContext& operator<<(eth::Instruction _instruction) { return *this << eth::AssemblyItem(_instruction); }
+	CompilerContext& operator<<(u256 const& _value) { return *this << eth::AssemblyItem(_value); }
+	CompilerContext& operator<<(bytes const& _data) { flushPendingStackOps(); m_asm.append(_data); return *this; }
+
+	/// Appends a precomposed sequence of items in one call, so that recurring fixed
+	/// instruction patterns do not pay the per-item bookkeeping of operator<<. The
+	/// sequence must consist of instructions and pushes only (no tags).
+	CompilerContext& appendItems(eth::AssemblyItems const& _items);
+
+	/// Emits the buffered stack operations, see bufferStackOp. Anything that appends to or
+	/// inspects the assembly without going through operator<< has to flush first to
+	/// preserve ordering and exact item counts.
+	void flushPendingStackOps();
 
 	/// Prepends "PUSH <compiler version number> POP"
 	void injectVersionStampIntoSub(size_t _subIndex);
 
-	void optimise(unsigned _runs = 200) { m_asm.optimise(true, true, _runs); }
+	void optimise(unsigned _runs = 200) { flushPendingStackOps(); m_asm.optimise(true, true, _runs); }
 
 	eth::Assembly const& assembly() const { return m_asm; }
 	/// @arg _sourceCodes is the map of input files to source code strings
@@ -141,8 +298,8 @@ public:
 		return m_asm.stream(_stream, "", _sourceCodes, _inJsonFormat);
 	}
 
-	eth::LinkerObject const& assembledObject() { return m_asm.assemble(); }
-	eth::LinkerObject const& assembledRuntimeObject(size_t _subIndex) { return m_asm.sub(_subIndex).assemble(); }
+	eth::LinkerObject const& assembledObject() { flushPendingStackOps(); return m_asm.assemble(); }
+	eth::LinkerObject const& assembledRuntimeObject(size_t _subIndex) { flushPendingStackOps(); return m_asm.sub(_subIndex).assemble(); }
 
 	/**
 	 * Helper class to pop the visited nodes stack when a scope closes
@@ -161,8 +318,21 @@ private:
 		FunctionDefinition const& _function,
 		std::vector<ContractDefinition const*>::const_iterator _searchStart
 	);
+	/// @returns the function overriding the given declaration - searches the inheritance
+	/// hierarchy starting from the given point towards the base.
+	FunctionDefinition const* resolveVirtualFunction(
+		FunctionDefinition const& _function,
+		std::vector<ContractDefinition const*>::const_iterator _searchStart
+	);
 	/// @returns an iterator to the contract directly above the given contract.
 	std::vector<ContractDefinition const*>::const_iterator superContract(const ContractDefinition &_contract) const;
+	/// @returns a key identifying the name and argument types of @a _function, cached per
+	/// declaration since building it requires constructing the function's type.
+	std::string const& virtualFunctionSignature(FunctionDefinition const& _function);
+	/// Buffers @a _item if it is a plain stack shuffle or cancels it against the buffered
+	/// one, modelling the symbolic stack effect. @returns true if the item was consumed;
+	/// otherwise the buffer was flushed and the caller has to append the item itself.
+	bool bufferStackOp(eth::AssemblyItem const& _item);
 	/// Updates source location set in the assembly.
 	void updateSourceLocation();
 
@@ -173,14 +343,54 @@ private:
 	std::map<ContractDefinition const*, eth::Assembly const*> m_compiledContracts;
 	/// Storage offsets of state variables
 	std::map<Declaration const*, std::pair<u256, unsigned>> m_stateVariables;
-	/// Offsets of local variables on the stack (relative to stack base).
-	std::map<Declaration const*, unsigned> m_localVariables;
+	/// Offsets of local variables on the stack (relative to stack base). Backed by a flat
+	/// vector indexed by node ID, since this is queried for every variable access emitted.
+	ASTNodeMap<unsigned> m_localVariables;
+	/// Calldata offsets of function arguments that stay in calldata until their first use.
+	std::map<Declaration const*, unsigned> m_calldataVariables;
+	/// Stack offsets (relative to stack base) of loop-invariant expressions hoisted out of
+	/// the loop they appear in.
+	std::map<Expression const*, unsigned> m_hoistedExpressions;
+	/// Functions whose external entry point leaves the arguments in calldata.
+	std::set<Declaration const*> m_lazyCalldataFunctions;
 	/// Labels pointing to the entry points of functions.
 	std::map<Declaration const*, eth::AssemblyItem> m_functionEntryLabels;
-	/// Set of functions for which we did not yet generate code.
+	/// Set of functions for which we already generated code.
 	std::set<Declaration const*> m_functionsWithCode;
+	/// Functions that received an entry label (i.e. are referenced from reachable code) in the
+	/// order of the first reference, to be compiled by @a nextFunctionToCompile. May contain
+	/// functions that were compiled in the meantime.
+	std::queue<Declaration const*> m_functionCompilationQueue;
 	/// List of current inheritance hierarchy from derived to base.
 	std::vector<ContractDefinition const*> m_inheritanceHierarchy;
+	/// Virtual function resolution per linearization point: entry i maps the signature key
+	/// of a function to its resolution when the lookup starts at contract i of the hierarchy.
+	std::vector<std::map<std::string, FunctionDefinition const*>> m_virtualResolutionTables;
+	/// Cached signature keys of function declarations, see virtualFunctionSignature.
+	std::map<FunctionDefinition const*, std::string> m_virtualFunctionSignatures;
+	/// Cache of generated function code shared across contracts, not owned. Can be nullptr.
+	FunctionCodeCache* m_functionCodeCache = nullptr;
+	/// Whether large type conversions are emitted as shared subroutines.
+	bool m_sharedRoutinesEnabled = false;
+	/// Set while a routine body is measured or generated to prevent recursive sharing.
+	bool m_suppressSharedRoutines = false;
+	/// Entry tags of the shared routines by name.
+	std::map<std::string, eth::AssemblyItem> m_sharedRoutineTags;
+	/// Routines that were measured to be too small to be worth sharing.
+	std::set<std::string> m_inlineRoutines;
+	/// Shared routines whose bodies still have to be generated.
+	std::queue<std::pair<std::string, std::function<void(CompilerContext&)>>> m_pendingSharedRoutines;
+	/// Marks all slot hash cache entries as not computed on the current code path.
+	void invalidateSlotHashCache();
+	/// Reserved cache word and path-validity per mapping access fingerprint.
+	struct SlotHashCacheEntry { unsigned offset; bool valid; };
+	std::map<std::string, SlotHashCacheEntry> m_slotHashCache;
+	/// Constant data (string literals etc.) that was already emitted once; repeated uses
+	/// are loaded from the shared data section instead.
+	std::set<bytes> m_seenConstants;
+	/// Not yet emitted stack shuffle items that may still cancel against following
+	/// operations, see bufferStackOp. Holds at most one item.
+	std::vector<eth::AssemblyItem> m_pendingStackOps;
 	/// Stack of current visited AST nodes, used for location attachment
 	std::stack<ASTNode const*> m_visitedNodes;
 };
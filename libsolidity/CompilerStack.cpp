@@ -21,16 +21,26 @@
  * Full-stack compiler that converts a source code string to bytecode.
  */
 
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <mutex>
+#include <thread>
 #include <boost/algorithm/string.hpp>
 #include <libsolidity/AST.h>
+#include <libsolidity/ASTMemoryCounter.h>
+#include <libsolidity/ASTStringPool.h>
 #include <libsolidity/Scanner.h>
 #include <libsolidity/Parser.h>
 #include <libsolidity/GlobalContext.h>
 #include <libsolidity/NameAndTypeResolver.h>
+#include <libsolidity/ASTStaticVisitor.h>
 #include <libsolidity/TypeChecker.h>
+#include <libsolidity/ArtifactCache.h>
 #include <libsolidity/Compiler.h>
 #include <libsolidity/CompilerStack.h>
 #include <libsolidity/InterfaceHandler.h>
+#include <libsolidity/Version.h>
 
 #include <libdevcore/SHA3.h>
 
@@ -55,37 +65,194 @@ const map<string, string> StandardSources = map<string, string>{
 	{"std", R"(import "owned";import "mortal";import "Config";import "configUser";import "NameReg";import "named";)"}
 };
 
+namespace
+{
+
+double wallTimeNow()
+{
+	return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#if defined(_WIN32)
+// No per-thread CPU clock available portably; fall back to the process clock.
+double processCpuTimeNow() { return double(clock()) / CLOCKS_PER_SEC; }
+double threadCpuTimeNow() { return double(clock()) / CLOCKS_PER_SEC; }
+#else
+double cpuTimeOf(clockid_t _clock)
+{
+	timespec time;
+	if (clock_gettime(_clock, &time) != 0)
+		return 0;
+	return double(time.tv_sec) + double(time.tv_nsec) * 1e-9;
+}
+double processCpuTimeNow() { return cpuTimeOf(CLOCK_PROCESS_CPUTIME_ID); }
+double threadCpuTimeNow() { return cpuTimeOf(CLOCK_THREAD_CPUTIME_ID); }
+#endif
+
+/**
+ * Adds the wall and CPU time of its own lifetime to a timing entry. Phase
+ * brackets on the main thread use the process CPU clock (so worker threads are
+ * included); timers inside workers use the thread CPU clock.
+ */
+class PhaseTimer
+{
+public:
+	enum CpuClock { ProcessCpu, ThreadCpu };
+
+	explicit PhaseTimer(CompilerStack::PhaseTiming& _target, CpuClock _clock = ProcessCpu):
+		m_target(_target),
+		m_clock(_clock),
+		m_wallStart(wallTimeNow()),
+		m_cpuStart(_clock == ProcessCpu ? processCpuTimeNow() : threadCpuTimeNow())
+	{}
+	~PhaseTimer()
+	{
+		m_target.wallSeconds += wallTimeNow() - m_wallStart;
+		m_target.cpuSeconds += (m_clock == ProcessCpu ? processCpuTimeNow() : threadCpuTimeNow()) - m_cpuStart;
+	}
+
+private:
+	CompilerStack::PhaseTiming& m_target;
+	CpuClock m_clock;
+	double m_wallStart;
+	double m_cpuStart;
+};
+
+/**
+ * Collects the contracts a freshly resolved contract refers to (through bases,
+ * type names and identifiers). Used to decide whether the contract's type check
+ * can be fused into the resolution pass or has to wait for a forward reference.
+ */
+class ReferencedContractsCollector: private ASTStaticVisitor<ReferencedContractsCollector>
+{
+public:
+	explicit ReferencedContractsCollector(ContractDefinition const& _contract) { walk(_contract); }
+	std::set<ContractDefinition const*> const& referencedContracts() const { return m_referenced; }
+
+	using ASTStaticVisitor<ReferencedContractsCollector>::visit;
+	using ASTStaticVisitor<ReferencedContractsCollector>::endVisit;
+	bool visit(Identifier const& _identifier)
+	{
+		add(_identifier.annotation().referencedDeclaration);
+		for (Declaration const* declaration: _identifier.annotation().overloadedDeclarations)
+			add(declaration);
+		return true;
+	}
+	bool visit(UserDefinedTypeName const& _typeName)
+	{
+		add(_typeName.annotation().referencedDeclaration);
+		return true;
+	}
+
+private:
+	friend class ASTStaticVisitor<ReferencedContractsCollector>;
+
+	/// Records the contract that owns @a _declaration (or the declaration itself
+	/// if it is a contract).
+	void add(Declaration const* _declaration)
+	{
+		while (_declaration)
+		{
+			if (auto contract = dynamic_cast<ContractDefinition const*>(_declaration))
+			{
+				m_referenced.insert(contract);
+				return;
+			}
+			_declaration = _declaration->scope();
+		}
+	}
+
+	std::set<ContractDefinition const*> m_referenced;
+};
+
+}
+
 CompilerStack::CompilerStack(bool _addStandardSources):
 	m_parseSuccessful(false)
 {
 	if (_addStandardSources)
-		addSources(StandardSources, true); // add them as libraries
+		installStandardSources(); // add them as libraries
+}
+
+void CompilerStack::installStandardSources()
+{
+	// The standard sources never change within a process, so they are scanned and
+	// parsed exactly once and every stack shares the snapshot's scanners and ASTs.
+	// Sharing is safe because the sources only reference themselves and the global
+	// context, so each compilation re-annotates them with identical results.
+	static mutex snapshotMutex;
+	static map<string, Source> snapshot;
+	lock_guard<mutex> guard(snapshotMutex);
+	if (snapshot.empty())
+		for (auto const& standardSource: StandardSources)
+		{
+			Source source;
+			source.scanner = make_shared<Scanner>(CharStream(standardSource.second), standardSource.first, true);
+			source.isLibrary = true;
+			source.contentHash = dev::sha3(standardSource.second);
+			source.ast = Parser(source.parserErrors).parse(source.scanner);
+			solAssert(!!source.ast, "Failed to parse standard source.");
+			source.dirty = false;
+			snapshot[standardSource.first] = move(source);
+		}
+	for (auto const& entry: snapshot)
+		m_sources[entry.first] = entry.second;
 }
 
 void CompilerStack::reset(bool _keepSources, bool _addStandardSources)
 {
 	m_parseSuccessful = false;
 	if (_keepSources)
-		for (auto sourcePair: m_sources)
-			sourcePair.second.reset();
+	{
+		// The sources keep their cached ASTs; parse() decides via the content
+		// hash whether a source actually has to be rescanned and reparsed.
+	}
 	else
 	{
 		m_sources.clear();
 		if (_addStandardSources)
-			addSources(StandardSources, true);
+			installStandardSources();
 	}
 	m_globalContext.reset();
 	m_sourceOrder.clear();
 	m_contracts.clear();
+	m_pendingBodyChecks.clear();
+	m_timings = CompilationTimings();
 	m_errors.clear();
 }
 
 bool CompilerStack::addSource(string const& _name, string const& _content, bool _isLibrary)
+{
+	return addSourceStream(_name, CharStream(_content), dev::sha3(_content), _isLibrary);
+}
+
+bool CompilerStack::addSource(string const& _name, char const* _data, size_t _size, bool _isLibrary)
+{
+	return addSourceStream(
+		_name,
+		CharStream(_data, _size),
+		dev::sha3(bytesConstRef(reinterpret_cast<byte const*>(_data), _size)),
+		_isLibrary
+	);
+}
+
+bool CompilerStack::addSourceStream(string const& _name, CharStream const& _stream, h256 const& _contentHash, bool _isLibrary)
 {
 	bool existed = m_sources.count(_name) != 0;
 	reset(true);
-	m_sources[_name].scanner = make_shared<Scanner>(CharStream(_content), _name);
-	m_sources[_name].isLibrary = _isLibrary;
+	Source& source = m_sources[_name];
+	if (existed && source.contentHash == _contentHash && source.isLibrary == _isLibrary && source.ast)
+		// Unchanged content: keep the scanner and the cached AST, only the
+		// analysis state (cleared by reset above) has to be rebuilt.
+		return existed;
+	// Pre-tokenize whole sources so that the parser walks a contiguous token
+	// buffer instead of interleaving with the scanning state machine.
+	source.scanner = make_shared<Scanner>(_stream, _name, true);
+	source.isLibrary = _isLibrary;
+	source.contentHash = _contentHash;
+	source.ast.reset();
+	source.dirty = true;
+	source.parserErrors.clear();
 	return existed;
 }
 
@@ -96,23 +263,133 @@ void CompilerStack::setSource(string const& _sourceCode)
 }
 
 bool CompilerStack::parse()
+{
+	return parseInternal(false);
+}
+
+bool CompilerStack::parseSignatures()
+{
+	return parseInternal(true);
+}
+
+bool CompilerStack::parseInternal(bool _signaturesOnly)
 {
 	//reset
 	m_errors.clear();
 	m_parseSuccessful = false;
+	m_timings = CompilationTimings();
+
+	// Applied before any type is constructed, since storage offsets are cached
+	// inside the member lists built during type checking.
+	StorageOffsets::setLayoutOptimization(m_optimizeStorageLayout);
+
+	// Thread-safe wrapper around the diagnostics sink: the workers below report
+	// errors concurrently, and a false return from the consumer cancels the
+	// whole parse.
+	atomic<bool> sinkCancelled(false);
+	mutex sinkMutex;
+	ErrorSink sink;
+	if (m_diagnosticsSink)
+		sink = [&](Error const& _error)
+		{
+			lock_guard<mutex> guard(sinkMutex);
+			if (sinkCancelled)
+				return false;
+			if (m_diagnosticsSink(_error))
+				return true;
+			sinkCancelled = true;
+			return false;
+		};
 
+	// Parsing is independent per source unit (imports are only resolved
+	// afterwards in resolveImports), so the sources are distributed over a
+	// pool of threads. Each worker appends to its own error list; the lists
+	// are merged in source order below, so the reported errors are identical
+	// to those of a sequential parse.
+	vector<Source*> sources;
+	vector<string> sourceNames;
 	for (auto& sourcePair: m_sources)
 	{
-		sourcePair.second.scanner->reset();
-		sourcePair.second.ast = Parser(m_errors).parse(sourcePair.second.scanner);
-		if (!sourcePair.second.ast)
+		sources.push_back(&sourcePair.second);
+		sourceNames.push_back(sourcePair.first);
+	}
+	vector<ErrorList> errorLists(sources.size());
+	vector<PhaseTiming> sourceTimings(sources.size());
+	vector<exception_ptr> workerExceptions(sources.size());
+	atomic<size_t> nextSource(0);
+	auto parseWorker = [&]()
+	{
+		for (size_t i = nextSource++; i < sources.size(); i = nextSource++)
+			try
+			{
+				// A cached full AST can serve a signature-only request, but a
+				// cached signature-only AST is not sufficient for a full parse.
+				bool cacheUsable =
+					sources[i]->ast &&
+					!sources[i]->dirty &&
+					(_signaturesOnly || !sources[i]->signaturesOnly);
+				if (cacheUsable)
+				{
+					// Unchanged source with a cached AST: skip scanning and
+					// parsing, but replay the messages of the original parse.
+					errorLists[i] = sources[i]->parserErrors;
+					if (sink)
+						for (auto const& error: errorLists[i])
+							if (!sink(*error))
+								break;
+					continue;
+				}
+				PhaseTimer sourceTimer(sourceTimings[i], PhaseTimer::ThreadCpu);
+				sources[i]->scanner->reset();
+				sources[i]->ast = Parser(errorLists[i], _signaturesOnly, sink).parse(sources[i]->scanner);
+				sources[i]->parserErrors = errorLists[i];
+				sources[i]->signaturesOnly = _signaturesOnly;
+				if (sources[i]->ast)
+					sources[i]->dirty = false;
+			}
+			catch (...)
+			{
+				workerExceptions[i] = current_exception();
+			}
+	};
+	{
+		PhaseTimer parseTimer(m_timings.phases["parse"]);
+		size_t threadCount = min(sources.size(), size_t(max(1u, thread::hardware_concurrency())));
+		if (threadCount <= 1)
+			parseWorker();
+		else
+		{
+			vector<thread> workers;
+			for (size_t i = 0; i < threadCount; ++i)
+				workers.emplace_back(parseWorker);
+			for (thread& worker: workers)
+				worker.join();
+		}
+	}
+	for (size_t i = 0; i < sources.size(); ++i)
+	{
+		if (sourceTimings[i].wallSeconds > 0)
+			m_timings.sources[sourceNames[i]] = sourceTimings[i];
+		m_errors.insert(m_errors.end(), errorLists[i].begin(), errorLists[i].end());
+		if (workerExceptions[i])
+			rethrow_exception(workerExceptions[i]);
+		if (!sources[i]->ast)
 			solAssert(!Error::containsOnlyWarnings(m_errors), "Parser returned null but did not report error.");
 	}
+	if (sinkCancelled)
+		return false;
 	if (!Error::containsOnlyWarnings(m_errors))
 		// errors while parsing. sould stop before type checking
 		return false;
 
-	resolveImports();
+	{
+		PhaseTimer importsTimer(m_timings.phases["resolveImports"]);
+		resolveImports();
+	}
+
+	// Runs until the function returns: name resolution and type checking are
+	// interleaved by the fused pipeline below and reported as one phase.
+	PhaseTimer analysisTimer(m_timings.phases["analysis"]);
 
 	m_globalContext = make_shared<GlobalContext>();
 	NameAndTypeResolver resolver(m_globalContext->declarations(), m_errors);
@@ -120,6 +397,21 @@ bool CompilerStack::parse()
 		if (!resolver.registerDeclarations(*source->ast))
 			return false;
 
+	// Fused pipeline: a contract whose references all point to already resolved
+	// contracts is type checked directly after its resolution, while its nodes
+	// are still hot in cache. Contracts with forward references (and everything
+	// still unchecked afterwards) go through the staged phase below.
+	set<ContractDefinition const*> resolvedContracts;
+	set<ContractDefinition const*> fusedContracts;
+	InterfaceHandler fusedInterfaceHandler;
+	bool fusedTypesFine = true;
+	m_pendingBodyChecks.clear();
+	// Sources whose contract bodies are checked eagerly; bodies elsewhere are
+	// deferred until checkContractBodies() asks for them.
+	set<Source const*> bodyCheckSources;
+	for (auto const& sourcePair: m_sources)
+		if (m_bodyCheckFocus.empty() || m_bodyCheckFocus.count(sourcePair.first))
+			bodyCheckSources.insert(&sourcePair.second);
 	for (Source const* source: m_sourceOrder)
 		for (ASTPointer<ASTNode> const& node: source->ast->nodes())
 			if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
@@ -129,27 +421,164 @@ bool CompilerStack::parse()
 				if (!resolver.updateDeclaration(*m_globalContext->currentSuper())) return false;
 				if (!resolver.resolveNamesAndTypes(*contract)) return false;
 				m_contracts[contract->name()].contract = contract;
+				resolvedContracts.insert(contract);
+				if (_signaturesOnly)
+					continue;
+				bool forwardReference = false;
+				for (ContractDefinition const* referenced: ReferencedContractsCollector(*contract).referencedContracts())
+					if (!resolvedContracts.count(referenced))
+					{
+						forwardReference = true;
+						break;
+					}
+				if (forwardReference)
+					continue;
+				bool checkBodies = bodyCheckSources.count(source);
+				if (!checkBodies)
+					m_pendingBodyChecks.insert(contract->name());
+				TypeChecker typeChecker(m_errors, checkBodies ? TypeChecker::Mode::Full : TypeChecker::Mode::SkipBodies, sink);
+				if (typeChecker.checkTypeRequirements(*contract))
+				{
+					contract->setDevDocumentation(fusedInterfaceHandler.devDocumentation(*contract));
+					contract->setUserDocumentation(fusedInterfaceHandler.userDocumentation(*contract));
+				}
+				else
+					fusedTypesFine = false;
+				fusedContracts.insert(contract);
+				if (sinkCancelled)
+					return false;
 			}
 
-	InterfaceHandler interfaceHandler;
-	bool typesFine = true;
+	if (_signaturesOnly)
+	{
+		// Bodies were not parsed, so type checking (and compilation) is not
+		// possible; imports and external interfaces are fully resolved though.
+		m_parseSuccessful = true;
+		return true;
+	}
+
+	// Type checking only writes into the annotations of the checked contract
+	// and into the lazily built type caches (which are guarded by the type
+	// cache mutex), so unrelated contracts can be checked concurrently.
+	// Contracts connected through inheritance or references (base contracts,
+	// "new" targets) stay on the same worker, in source order, because
+	// checking a contract reads the annotations of its bases and of every
+	// contract it creates or references. Name bindings were fully established
+	// by resolveNamesAndTypes above; the type checker does not consult the
+	// global scope any more.
+	vector<ContractDefinition*> contracts;
+	set<ContractDefinition const*> deferredBodies;
 	for (Source const* source: m_sourceOrder)
 		for (ASTPointer<ASTNode> const& node: source->ast->nodes())
 			if (ContractDefinition* contract = dynamic_cast<ContractDefinition*>(node.get()))
-			{
-				m_globalContext->setCurrentContract(*contract);
-				resolver.updateDeclaration(*m_globalContext->currentThis());
-				TypeChecker typeChecker(m_errors);
-				if (typeChecker.checkTypeRequirements(*contract))
+				if (!fusedContracts.count(contract))
 				{
-					contract->setDevDocumentation(interfaceHandler.devDocumentation(*contract));
-					contract->setUserDocumentation(interfaceHandler.userDocumentation(*contract));
+					contracts.push_back(contract);
+					if (!bodyCheckSources.count(source))
+					{
+						deferredBodies.insert(contract);
+						m_pendingBodyChecks.insert(contract->name());
+					}
 				}
-				else
-					typesFine = false;
 
-				m_contracts[contract->name()].contract = contract;
+	// Union-find over the inheritance and reference edges to group contracts
+	// into independently checkable components.
+	map<ContractDefinition const*, size_t> contractIndex;
+	for (size_t i = 0; i < contracts.size(); ++i)
+		contractIndex[contracts[i]] = i;
+	vector<size_t> unionParent(contracts.size());
+	for (size_t i = 0; i < unionParent.size(); ++i)
+		unionParent[i] = i;
+	auto findRoot = [&](size_t _index)
+	{
+		while (unionParent[_index] != _index)
+			_index = unionParent[_index] = unionParent[unionParent[_index]];
+		return _index;
+	};
+	for (size_t i = 0; i < contracts.size(); ++i)
+	{
+		for (ContractDefinition const* base: contracts[i]->annotation().linearizedBaseContracts)
+		{
+			auto it = contractIndex.find(base);
+			if (it != contractIndex.end())
+				unionParent[findRoot(i)] = findRoot(it->second);
+		}
+		// Checking a contract also reads and writes annotations across creation
+		// and reference dependencies: "new B()" reads B's isFullyImplemented
+		// flag and traverses contractDependencies sets that B's own check
+		// fills, so every referenced contract has to stay on the same worker.
+		for (ContractDefinition const* referenced: ReferencedContractsCollector(*contracts[i]).referencedContracts())
+		{
+			auto it = contractIndex.find(referenced);
+			if (it != contractIndex.end())
+				unionParent[findRoot(i)] = findRoot(it->second);
+		}
+	}
+	map<size_t, size_t> componentOfRoot;
+	vector<vector<ContractDefinition*>> components;
+	for (size_t i = 0; i < contracts.size(); ++i)
+	{
+		size_t root = findRoot(i);
+		if (!componentOfRoot.count(root))
+		{
+			componentOfRoot[root] = components.size();
+			components.emplace_back();
+		}
+		components[componentOfRoot[root]].push_back(contracts[i]);
+	}
+
+	vector<ErrorList> checkerErrors(components.size());
+	vector<exception_ptr> checkerExceptions(components.size());
+	atomic<bool> typesFine(fusedTypesFine);
+	atomic<size_t> nextComponent(0);
+	auto checkWorker = [&]()
+	{
+		for (size_t i = nextComponent++; i < components.size(); i = nextComponent++)
+			try
+			{
+				InterfaceHandler interfaceHandler;
+				for (ContractDefinition* contract: components[i])
+				{
+					TypeChecker typeChecker(
+						checkerErrors[i],
+						deferredBodies.count(contract) ? TypeChecker::Mode::SkipBodies : TypeChecker::Mode::Full,
+						sink
+					);
+					if (typeChecker.checkTypeRequirements(*contract))
+					{
+						contract->setDevDocumentation(interfaceHandler.devDocumentation(*contract));
+						contract->setUserDocumentation(interfaceHandler.userDocumentation(*contract));
+					}
+					else
+						typesFine = false;
+				}
 			}
+			catch (...)
+			{
+				checkerExceptions[i] = current_exception();
+			}
+	};
+	size_t threadCount = min(components.size(), size_t(max(1u, thread::hardware_concurrency())));
+	if (threadCount <= 1)
+		checkWorker();
+	else
+	{
+		vector<thread> workers;
+		for (size_t i = 0; i < threadCount; ++i)
+			workers.emplace_back(checkWorker);
+		for (thread& worker: workers)
+			worker.join();
+	}
+	// Merge in component order (components are ordered by their first contract
+	// in source order), so the reported errors are deterministic.
+	for (size_t i = 0; i < components.size(); ++i)
+	{
+		m_errors.insert(m_errors.end(), checkerErrors[i].begin(), checkerErrors[i].end());
+		if (checkerExceptions[i])
+			rethrow_exception(checkerExceptions[i]);
+	}
+	if (sinkCancelled)
+		return false;
 	m_parseSuccessful = typesFine;
 	return m_parseSuccessful;
 }
@@ -171,17 +600,226 @@ vector<string> CompilerStack::contractNames() const
 }
 
 
+bool CompilerStack::checkContractBodies(string const& _contractName)
+{
+	ContractDefinition const& contractDefinition = this->contractDefinition(_contractName);
+	if (!m_pendingBodyChecks.count(contractDefinition.name()))
+		return true;
+	ErrorList bodyErrors;
+	TypeChecker typeChecker(bodyErrors, TypeChecker::Mode::OnlyBodies, m_diagnosticsSink);
+	bool success = typeChecker.checkTypeRequirements(contractDefinition);
+	m_errors.insert(m_errors.end(), bodyErrors.begin(), bodyErrors.end());
+	m_pendingBodyChecks.erase(contractDefinition.name());
+	if (!success)
+		m_parseSuccessful = false;
+	return success;
+}
+
+bool CompilerStack::typeCheck()
+{
+	if (!m_parseSuccessful)
+		if (!parse())
+			return false;
+
+	// Interfaces and documentation only need fully checked bodies, not code
+	// generation; run the checks a focused parse deferred.
+	PhaseTimer bodyCheckTimer(m_timings.phases["analysis"]);
+	vector<string> pendingBodyChecks(m_pendingBodyChecks.begin(), m_pendingBodyChecks.end());
+	for (string const& contractName: pendingBodyChecks)
+		if (!checkContractBodies(contractName))
+			return false;
+	return true;
+}
+
 bool CompilerStack::compile(bool _optimize, unsigned _runs)
 {
 	if (!m_parseSuccessful)
 		if (!parse())
 			return false;
 
+	m_timings.phases.erase("codegen");
+	m_timings.contracts.clear();
+
+	// Code generation needs fully checked bodies; run the checks a focused
+	// parse deferred.
+	{
+		PhaseTimer bodyCheckTimer(m_timings.phases["analysis"]);
+		vector<string> pendingBodyChecks(m_pendingBodyChecks.begin(), m_pendingBodyChecks.end());
+		for (string const& contractName: pendingBodyChecks)
+			if (!checkContractBodies(contractName))
+				return false;
+	}
+
+	// Runs until the function returns and covers optimization, which happens
+	// inside the assembler and cannot be split out.
+	PhaseTimer codegenTimer(m_timings.phases["codegen"]);
+
 	map<ContractDefinition const*, eth::Assembly const*> compiledContracts;
+	// Shares lowered function bodies between the contracts of this run, so inherited
+	// functions are only compiled once per build. Tied to this compilation because the
+	// entries reference the current AST.
+	FunctionCodeCache codeCache;
+	// Fingerprints of the contracts compiled so far; byte-identical duplicates alias the
+	// objects of the first instance instead of being compiled again.
+	map<h256, string> fingerprints;
+
+	// Contracts are independent at code generation time except for creation
+	// dependencies ("new C"), whose assemblies have to be present in compiledContracts
+	// before the creating contract is compiled. The contracts are therefore compiled
+	// in waves: each wave consists of the contracts whose dependencies were satisfied
+	// by earlier waves, and the contracts of one wave are distributed over a pool of
+	// threads. The results are merged on this thread in source order, so m_contracts
+	// and the duplicate detection are filled exactly as by a sequential compilation.
+	vector<ContractDefinition const*> pending;
 	for (Source const* source: m_sourceOrder)
 		for (ASTPointer<ASTNode> const& node: source->ast->nodes())
 			if (auto contract = dynamic_cast<ContractDefinition const*>(node.get()))
-				compileContract(_optimize, _runs, *contract, compiledContracts);
+				if (contract->annotation().isFullyImplemented)
+					pending.push_back(contract);
+
+	map<ContractDefinition const*, h256> cacheKeys;
+	if (m_artifactCache)
+	{
+		map<ContractDefinition const*, ArtifactCache::Entry> cacheHits;
+		for (ContractDefinition const* contract: pending)
+		{
+			cacheKeys[contract] = artifactCacheKey(*contract, _optimize, _runs);
+			ArtifactCache::Entry entry;
+			if (m_artifactCache->load(cacheKeys[contract], entry))
+				cacheHits[contract] = move(entry);
+		}
+		// Creation ("new C") inlines the full assembly of the created contract, which
+		// the cached objects cannot provide. A cache miss therefore pulls its
+		// transitive creation dependencies back into the compilation even if they hit.
+		set<ContractDefinition const*> mustCompile;
+		vector<ContractDefinition const*> worklist;
+		for (ContractDefinition const* contract: pending)
+			if (!cacheHits.count(contract))
+				worklist.push_back(contract);
+		while (!worklist.empty())
+		{
+			ContractDefinition const* contract = worklist.back();
+			worklist.pop_back();
+			if (!mustCompile.insert(contract).second)
+				continue;
+			for (auto const* dependency: contract->annotation().contractDependencies)
+				worklist.push_back(dependency);
+		}
+		vector<ContractDefinition const*> toCompile;
+		for (ContractDefinition const* contract: pending)
+			if (cacheHits.count(contract) && !mustCompile.count(contract))
+			{
+				// Restored contracts keep a null compiler; the assembly inspection
+				// interfaces already treat that as unavailable.
+				Contract& compiledContract = m_contracts.at(contract->name());
+				ArtifactCache::Entry const& entry = cacheHits.at(contract);
+				compiledContract.object = entry.object;
+				compiledContract.runtimeObject = entry.runtimeObject;
+				compiledContract.cloneObject = entry.cloneObject;
+			}
+			else
+				toCompile.push_back(contract);
+		pending = move(toCompile);
+	}
+
+	while (!pending.empty())
+	{
+		vector<ContractDefinition const*> wave;
+		vector<ContractDefinition const*> blocked;
+		for (ContractDefinition const* contract: pending)
+		{
+			bool ready = true;
+			for (auto const* dependency: contract->annotation().contractDependencies)
+				if (dependency->annotation().isFullyImplemented && !compiledContracts.count(dependency))
+					ready = false;
+			(ready ? wave : blocked).push_back(contract);
+		}
+		solAssert(!wave.empty(), "Cycle in contract creation dependencies.");
+		pending = move(blocked);
+
+		// Byte-identical duplicates alias the objects of their first instance, so only
+		// that instance is handed to the pool. Within a wave the first instance is the
+		// one earliest in source order.
+		vector<h256> waveFingerprints(wave.size());
+		vector<bool> duplicate(wave.size(), false);
+		set<h256> seenInWave;
+		for (size_t i = 0; i < wave.size(); ++i)
+		{
+			waveFingerprints[i] = contractFingerprint(*wave[i]);
+			duplicate[i] =
+				fingerprints.count(waveFingerprints[i]) ||
+				!seenInWave.insert(waveFingerprints[i]).second;
+		}
+
+		vector<shared_ptr<Compiler>> compilers(wave.size());
+		vector<shared_ptr<Compiler>> cloneCompilers(wave.size());
+		vector<PhaseTiming> waveTimings(wave.size());
+		vector<exception_ptr> workerExceptions(wave.size());
+		atomic<size_t> nextContract(0);
+		auto compileWorker = [&]()
+		{
+			for (size_t i = nextContract++; i < wave.size(); i = nextContract++)
+			{
+				if (duplicate[i])
+					continue;
+				try
+				{
+					PhaseTimer contractTimer(waveTimings[i], PhaseTimer::ThreadCpu);
+					compilers[i] = make_shared<Compiler>(_optimize, _runs, &codeCache, m_sharedConversionRoutines, m_lazyCalldataDecoding, m_sharedModifierBodies);
+					compilers[i]->compileContract(*wave[i], compiledContracts);
+					cloneCompilers[i] = make_shared<Compiler>(_optimize, _runs, &codeCache, m_sharedConversionRoutines, m_lazyCalldataDecoding, m_sharedModifierBodies);
+					cloneCompilers[i]->compileClone(*wave[i], compiledContracts);
+				}
+				catch (...)
+				{
+					workerExceptions[i] = current_exception();
+				}
+			}
+		};
+		size_t threadCount = min(wave.size(), size_t(max(1u, thread::hardware_concurrency())));
+		if (threadCount <= 1)
+			compileWorker();
+		else
+		{
+			vector<thread> workers;
+			for (size_t i = 0; i < threadCount; ++i)
+				workers.emplace_back(compileWorker);
+			for (thread& worker: workers)
+				worker.join();
+		}
+
+		for (size_t i = 0; i < wave.size(); ++i)
+		{
+			if (workerExceptions[i])
+				rethrow_exception(workerExceptions[i]);
+			Contract& compiledContract = m_contracts.at(wave[i]->name());
+			if (duplicate[i])
+			{
+				Contract const& original = m_contracts.at(fingerprints.at(waveFingerprints[i]));
+				compiledContract.compiler = original.compiler;
+				compiledContract.object = original.object;
+				compiledContract.runtimeObject = original.runtimeObject;
+				compiledContract.cloneObject = original.cloneObject;
+				compiledContracts[compiledContract.contract] = &original.compiler->assembly();
+				continue;
+			}
+			compiledContract.compiler = compilers[i];
+			compiledContract.object = compilers[i]->assembledObject();
+			compiledContract.runtimeObject = compilers[i]->runtimeObject();
+			compiledContracts[compiledContract.contract] = &compilers[i]->assembly();
+			compiledContract.cloneObject = cloneCompilers[i]->assembledObject();
+			fingerprints[waveFingerprints[i]] = wave[i]->name();
+			m_timings.contracts[wave[i]->name()] = waveTimings[i];
+			if (m_artifactCache)
+			{
+				ArtifactCache::Entry entry;
+				entry.object = compiledContract.object;
+				entry.runtimeObject = compiledContract.runtimeObject;
+				entry.cloneObject = compiledContract.cloneObject;
+				m_artifactCache->store(cacheKeys.at(wave[i]), entry);
+			}
+		}
+	}
 	return true;
 }
 
@@ -190,6 +828,83 @@ bool CompilerStack::compile(string const& _sourceCode, bool _optimize)
 	return parse(_sourceCode) && compile(_optimize);
 }
 
+Json::Value CompilerStack::memoryAccounting() const
+{
+	Json::Value result(Json::objectValue);
+
+	// AST figures: aggregate per node kind plus a per-source summary with the
+	// exact arena allocation.
+	ASTMemoryCounter totalCounter;
+	Json::Value sources(Json::objectValue);
+	for (auto const& sourcePair: m_sources)
+		if (sourcePair.second.ast)
+		{
+			totalCounter.add(*sourcePair.second.ast);
+			ASTMemoryCounter sourceCounter;
+			sourceCounter.add(*sourcePair.second.ast);
+			Json::Value source(Json::objectValue);
+			source["nodeCount"] = Json::UInt(sourceCounter.nodeCount());
+			source["arenaBytes"] = Json::UInt(sourceCounter.arenaBytes());
+			sources[sourcePair.first] = source;
+		}
+	result["ast"] = totalCounter.toJson();
+	result["ast"]["sources"] = sources;
+
+	TypePool::Statistics typeStatistics = TypePool::statistics();
+	Json::Value typeCaches(Json::objectValue);
+	typeCaches["integerTypes"] = Json::UInt(typeStatistics.integerTypes);
+	typeCaches["fixedBytesTypes"] = Json::UInt(typeStatistics.fixedBytesTypes);
+	typeCaches["binaryOperatorResults"] = Json::UInt(typeStatistics.binaryOperatorResults);
+	typeCaches["internedStrings"] = Json::UInt(ASTStringPool::global().size());
+	result["typeCaches"] = typeCaches;
+
+	Json::Value contracts(Json::objectValue);
+	// Byte-identical duplicates share their original's compiler; the assembly
+	// is only attributed to the first contract reporting it.
+	set<Compiler const*> seenCompilers;
+	for (auto const& contractPair: m_contracts)
+	{
+		Contract const& contract = contractPair.second;
+		Json::Value entry(Json::objectValue);
+		entry["bytecodeBytes"] = Json::UInt(contract.object.bytecode.size());
+		entry["runtimeBytecodeBytes"] = Json::UInt(contract.runtimeObject.bytecode.size());
+		entry["cloneBytecodeBytes"] = Json::UInt(contract.cloneObject.bytecode.size());
+		if (contract.compiler && seenCompilers.insert(contract.compiler.get()).second)
+		{
+			size_t items =
+				contract.compiler->assemblyItems().size() +
+				contract.compiler->runtimeAssemblyItems().size();
+			entry["assemblyItems"] = Json::UInt(items);
+			entry["assemblyItemBytes"] = Json::UInt(items * sizeof(eth::AssemblyItem));
+		}
+		contracts[contractPair.first] = entry;
+	}
+	result["contracts"] = contracts;
+
+	return result;
+}
+
+Json::Value CompilerStack::CompilationTimings::toJson() const
+{
+	auto convert = [](map<string, PhaseTiming> const& _entries)
+	{
+		Json::Value result(Json::objectValue);
+		for (auto const& entry: _entries)
+		{
+			Json::Value timing(Json::objectValue);
+			timing["wall"] = entry.second.wallSeconds;
+			timing["cpu"] = entry.second.cpuSeconds;
+			result[entry.first] = timing;
+		}
+		return result;
+	};
+	Json::Value result(Json::objectValue);
+	result["phases"] = convert(phases);
+	result["sources"] = convert(sources);
+	result["contracts"] = convert(contracts);
+	return result;
+}
+
 void CompilerStack::link(const std::map<string, h160>& _libraries)
 {
 	for (auto& contract: m_contracts)
@@ -281,6 +996,9 @@ string const& CompilerStack::metadata(string const& _contractName, Documentation
 	case DocumentationType::ABISolidityInterface:
 		doc = &currentContract.solidityInterface;
 		break;
+	case DocumentationType::ABIBinary:
+		doc = &currentContract.binaryInterface;
+		break;
 	default:
 		BOOST_THROW_EXCEPTION(InternalCompilerError() << errinfo_comment("Illegal documentation type."));
 	}
@@ -307,6 +1025,27 @@ ContractDefinition const& CompilerStack::contractDefinition(string const& _contr
 	return *contract(_contractName).contract;
 }
 
+map<FixedHash<4>, FunctionTypePointer> const& CompilerStack::interfaceFunctions(string const& _contractName) const
+{
+	return contractDefinition(_contractName).interfaceFunctions();
+}
+
+Json::Value CompilerStack::storageLayout(string const& _contractName) const
+{
+	ContractDefinition const& contract = contractDefinition(_contractName);
+	Json::Value layout(Json::arrayValue);
+	for (auto const& variable: ContractType(contract).stateVariables())
+	{
+		Json::Value entry;
+		entry["name"] = get<0>(variable)->name();
+		entry["type"] = get<0>(variable)->annotation().type->toString(false);
+		entry["slot"] = get<1>(variable).str();
+		entry["offset"] = Json::UInt(get<2>(variable));
+		layout.append(entry);
+	}
+	return layout;
+}
+
 size_t CompilerStack::functionEntryPoint(
 	std::string const& _contractName,
 	FunctionDefinition const& _function
@@ -342,12 +1081,18 @@ void CompilerStack::resolveImports()
 	// topological sorting (depth first search) of the import graph, cutting potential cycles
 	vector<Source const*> sourceOrder;
 	set<Source const*> sourcesSeen;
+	ImportGraph graph;
+
+	map<Source const*, string> sourceNames;
+	for (auto const& sourcePair: m_sources)
+		sourceNames[&sourcePair.second] = sourcePair.first;
 
 	function<void(Source const*)> toposort = [&](Source const* _source)
 	{
 		if (sourcesSeen.count(_source))
 			return;
 		sourcesSeen.insert(_source);
+		string const& sourceName = sourceNames[_source];
 		for (ASTPointer<ASTNode> const& node: _source->ast->nodes())
 			if (ImportDirective const* import = dynamic_cast<ImportDirective*>(node.get()))
 			{
@@ -359,8 +1104,11 @@ void CompilerStack::resolveImports()
 							<< errinfo_comment("Source not found.")
 					);
 
+				graph.imports[sourceName].push_back(id);
+				graph.importers[id].push_back(sourceName);
 				toposort(&m_sources[id]);
 			}
+		graph.topologicalOrder.push_back(sourceName);
 		sourceOrder.push_back(_source);
 	};
 
@@ -369,31 +1117,107 @@ void CompilerStack::resolveImports()
 			toposort(&sourcePair.second);
 
 	swap(m_sourceOrder, sourceOrder);
+	swap(m_importGraph, graph);
 }
 
-void CompilerStack::compileContract(
-	bool _optimize,
-	unsigned _runs,
+set<string> CompilerStack::sourcesAffectedBy(vector<string> const& _changedSources) const
+{
+	set<string> affected;
+	vector<string> workList(_changedSources);
+	while (!workList.empty())
+	{
+		string name = workList.back();
+		workList.pop_back();
+		if (!affected.insert(name).second)
+			continue;
+		auto it = m_importGraph.importers.find(name);
+		if (it != m_importGraph.importers.end())
+			for (string const& importer: it->second)
+				workList.push_back(importer);
+	}
+	return affected;
+}
+
+vector<string> CompilerStack::contractsAffectedBy(vector<string> const& _changedSources) const
+{
+	set<string> affectedSources = sourcesAffectedBy(_changedSources);
+	vector<string> contracts;
+	for (string const& sourceName: m_importGraph.topologicalOrder)
+	{
+		if (!affectedSources.count(sourceName))
+			continue;
+		auto it = m_sources.find(sourceName);
+		if (it == m_sources.end() || !it->second.ast)
+			continue;
+		for (ASTPointer<ASTNode> const& node: it->second.ast->nodes())
+			if (auto contract = dynamic_cast<ContractDefinition const*>(node.get()))
+				contracts.push_back(contract->name());
+	}
+	return contracts;
+}
+
+void CompilerStack::setArtifactCacheDirectory(string const& _directory)
+{
+	if (_directory.empty())
+		m_artifactCache.reset();
+	else
+		m_artifactCache = make_shared<ArtifactCache>(_directory);
+}
+
+h256 CompilerStack::artifactCacheKey(ContractDefinition const& _contract, bool _optimize, unsigned _runs) const
+{
+	// The fingerprint covers the source text of the contract and of everything it
+	// references, so together with the version and the code generation settings the
+	// key identifies the produced artifacts completely.
+	bytes data = contractFingerprint(_contract).asBytes();
+	data += bytes(VersionString.begin(), VersionString.end());
+	data.push_back(_optimize ? 1 : 0);
+	for (unsigned i = 0; i < 4; ++i)
+		data.push_back(uint8_t(_runs >> (8 * i)));
+	data.push_back(m_optimizeStorageLayout ? 1 : 0);
+	data.push_back(m_sharedConversionRoutines ? 1 : 0);
+	data.push_back(m_lazyCalldataDecoding ? 1 : 0);
+	data.push_back(m_sharedModifierBodies ? 1 : 0);
+	return dev::sha3(data);
+}
+
+h256 CompilerStack::contractFingerprint(ContractDefinition const& _contract) const
+{
+	map<ContractDefinition const*, h256> memo;
+	return contractFingerprint(_contract, memo);
+}
+
+h256 CompilerStack::contractFingerprint(
 	ContractDefinition const& _contract,
-	map<ContractDefinition const*, eth::Assembly const*>& _compiledContracts
-)
-{
-	if (_compiledContracts.count(&_contract) || !_contract.annotation().isFullyImplemented)
-		return;
-	for (auto const* dependency: _contract.annotation().contractDependencies)
-		compileContract(_optimize, _runs, *dependency, _compiledContracts);
-
-	shared_ptr<Compiler> compiler = make_shared<Compiler>(_optimize, _runs);
-	compiler->compileContract(_contract, _compiledContracts);
-	Contract& compiledContract = m_contracts.at(_contract.name());
-	compiledContract.compiler = compiler;
-	compiledContract.object = compiler->assembledObject();
-	compiledContract.runtimeObject = compiler->runtimeObject();
-	_compiledContracts[compiledContract.contract] = &compiler->assembly();
-
-	Compiler cloneCompiler(_optimize, _runs);
-	cloneCompiler.compileClone(_contract, _compiledContracts);
-	compiledContract.cloneObject = cloneCompiler.assembledObject();
+	map<ContractDefinition const*, h256>& _memo
+) const
+{
+	auto known = _memo.find(&_contract);
+	if (known != _memo.end())
+		return known->second;
+	// Break reference cycles between contracts; the participants of a cycle hash their
+	// names instead of each other, which can only prevent a deduplication, never cause
+	// a wrong one.
+	_memo[&_contract] = dev::sha3(_contract.name());
+
+	SourceLocation const& location = _contract.location();
+	CharStream const& text = source(*location.sourceName).scanner->charStream();
+	solAssert(
+		location.start >= 0 && location.end >= location.start && size_t(location.end) <= text.size(),
+		"Invalid contract source location."
+	);
+	bytes data(
+		reinterpret_cast<byte const*>(text.data()) + location.start,
+		reinterpret_cast<byte const*>(text.data()) + location.end
+	);
+	ReferencedContractsCollector references(_contract);
+	for (ContractDefinition const* contract: references.referencedContracts())
+		if (contract != &_contract)
+			data += contractFingerprint(*contract, _memo).asBytes();
+
+	h256 fingerprint = dev::sha3(data);
+	_memo[&_contract] = fingerprint;
+	return fingerprint;
 }
 
 std::string CompilerStack::defaultContractName() const
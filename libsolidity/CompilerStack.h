@@ -25,7 +25,9 @@
 
 #include <ostream>
 #include <string>
+#include <map>
 #include <memory>
+#include <set>
 #include <vector>
 #include <boost/noncopyable.hpp>
 #include <json/json.h>
@@ -50,10 +52,14 @@ namespace solidity
 
 // forward declarations
 class Scanner;
+class CharStream;
 class ContractDefinition;
 class FunctionDefinition;
+class FunctionType;
+using FunctionTypePointer = std::shared_ptr<FunctionType const>;
 class SourceUnit;
 class Compiler;
+class ArtifactCache;
 class GlobalContext;
 class InterfaceHandler;
 class Error;
@@ -63,7 +69,8 @@ enum class DocumentationType: uint8_t
 	NatspecUser = 1,
 	NatspecDev,
 	ABIInterface,
-	ABISolidityInterface
+	ABISolidityInterface,
+	ABIBinary
 };
 
 /**
@@ -87,17 +94,71 @@ public:
 		for (auto const& i: _nameContents) addSource(i.first, i.second, _isLibrary);
 	}
 	bool addSource(std::string const& _name, std::string const& _content, bool _isLibrary = false);
+	/// Adds a source object over an externally owned buffer (e.g. a memory-mapped
+	/// file) without copying the source bytes. The buffer has to stay alive and
+	/// unchanged until the source is replaced or the stack is reset without
+	/// keeping sources.
+	bool addSource(std::string const& _name, char const* _data, size_t _size, bool _isLibrary = false);
 	void setSource(std::string const& _sourceCode);
 	/// Parses all source units that were added
 	/// @returns false on error.
 	bool parse();
+	/// Parses all added source units in signature-only mode: function bodies are lexed
+	/// over without building statement ASTs. Considerably faster than parse() and
+	/// sufficient for importGraph(), contractNames() and interface extraction, but the
+	/// result cannot be type checked or compiled.
+	/// @returns false on error.
+	bool parseSignatures();
 	/// Sets the given source code as the only source unit apart from standard sources and parses it.
 	/// @returns false on error.
 	bool parse(std::string const& _sourceCode);
+	/// Restricts eager checking of executable bodies to the given source units: bodies of
+	/// contracts in other sources are only signature-checked during parse() and checked
+	/// lazily via checkContractBodies() (or before compilation). An empty set (the
+	/// default) checks all bodies eagerly.
+	void setBodyCheckFocus(std::set<std::string> const& _sourceNames) { m_bodyCheckFocus = _sourceNames; }
+	/// Runs the body checks parse() deferred for the given contract; a no-op if its
+	/// bodies were already checked. Errors are appended to errors().
+	/// @returns false iff the body checks produced an error.
+	bool checkContractBodies(std::string const& _contractName);
 	/// Returns a list of the contract names in the sources.
 	std::vector<std::string> contractNames() const;
 	std::string defaultContractName() const;
 
+	/// Enables reordering of struct members and state variables so that small members
+	/// share storage slots instead of being packed in strict declaration order. Opt-in
+	/// because it changes the storage layout; must be set before parsing. Use
+	/// storageLayout() to retrieve the chosen layout.
+	void setOptimizeStorageLayout(bool _enabled) { m_optimizeStorageLayout = _enabled; }
+	/// @returns the storage layout of the given contract as a JSON array with one entry
+	/// per state variable (name, type, slot and byte offset), reflecting a potential
+	/// layout optimization. Prerequisite: successful parse.
+	Json::Value storageLayout(std::string const& _contractName = "") const;
+	/// Enables emitting large type conversion sequences once per contract as internal
+	/// subroutines that call sites jump to. Trades one jump per conversion for a
+	/// bytecode size reduction; must be set before compiling.
+	void setSharedConversionRoutines(bool _enabled) { m_sharedConversionRoutines = _enabled; }
+	/// Enables loading external function arguments from calldata at their first use instead
+	/// of decoding all of them up front, where the compiler can prove this is equivalent.
+	/// Saves the decoding cost on paths that do not touch all arguments; must be set before
+	/// compiling.
+	void setLazyCalldataDecoding(bool _enabled) { m_lazyCalldataDecoding = _enabled; }
+	/// Enables compiling modifiers that consist of checks followed by a trailing placeholder
+	/// once per contract as internal subroutines instead of inlining them into every function
+	/// that uses them; must be set before compiling.
+	void setSharedModifierBodies(bool _enabled) { m_sharedModifierBodies = _enabled; }
+	/// Enables the on-disk artifact cache in the given directory: contracts whose sources,
+	/// compiler version and settings match a cached entry skip code generation and reuse
+	/// the stored objects. An empty path disables the cache.
+	void setArtifactCacheDirectory(std::string const& _directory);
+
+	/// Parses (if necessary) and finishes all semantic checks without generating any
+	/// code. After a successful call, contractNames(), interface(), metadata() and the
+	/// AST are available; bytecode and assembly accessors are not. Considerably faster
+	/// than compile() when only interfaces or documentation are needed.
+	/// @returns false on error.
+	bool typeCheck();
+
 	/// Compiles the source units that were previously added and parsed.
 	/// @returns false on error.
 	bool compile(bool _optimize = false, unsigned _runs = 200);
@@ -151,6 +212,10 @@ public:
 	/// @returns the parsed contract with the supplied name. Throws an exception if the contract
 	/// does not exist.
 	ContractDefinition const& contractDefinition(std::string const& _contractName) const;
+	/// @returns the sorted selector table (function selector -> external function type) of the
+	/// given contract; the same instance codegen and the interface handler use, so external
+	/// consumers do not re-derive signature hashes. Prerequisite: successful parse.
+	std::map<FixedHash<4>, FunctionTypePointer> const& interfaceFunctions(std::string const& _contractName = "") const;
 
 	/// @returns the offset of the entry point of the given function into the list of assembly items
 	/// or zero if it is not found or does not exist.
@@ -167,6 +232,80 @@ public:
 	/// @returns the list of errors that occured during parsing and type checking.
 	ErrorList const& errors() const { return m_errors; }
 
+	/// Sets a callback that is invoked for every error or warning as soon as the
+	/// parser or type checker records it, so consumers can render diagnostics
+	/// incrementally. Returning false from the callback cancels the running
+	/// parse, which then returns false. The callback may be invoked from
+	/// several threads, but never concurrently.
+	void setDiagnosticsSink(ErrorSink _sink) { m_diagnosticsSink = std::move(_sink); }
+
+	/**
+	 * Import dependency graph of the added sources, built while resolving imports.
+	 */
+	struct ImportGraph
+	{
+		/// Names of the sources reachable from the non-library sources, in topological
+		/// order (imported sources before their importers).
+		std::vector<std::string> topologicalOrder;
+		/// Maps each source name to the names of the sources it imports directly.
+		std::map<std::string, std::vector<std::string>> imports;
+		/// Reverse edges: maps each source name to the names of the sources importing it directly.
+		std::map<std::string, std::vector<std::string>> importers;
+	};
+
+	/// @returns the import dependency graph. Prerequisite: call to parse (the graph is
+	/// valid even if type checking failed afterwards).
+	ImportGraph const& importGraph() const { return m_importGraph; }
+
+	/**
+	 * Wall clock and CPU time consumed by one compilation phase or work item,
+	 * both in seconds.
+	 */
+	struct PhaseTiming
+	{
+		double wallSeconds = 0;
+		double cpuSeconds = 0;
+	};
+
+	/**
+	 * Timing breakdown of the most recent parse and compile run, see timings().
+	 */
+	struct CompilationTimings
+	{
+		/// Elapsed wall time and process CPU time per phase, keyed by "parse",
+		/// "resolveImports", "analysis" (name resolution and type checking,
+		/// which run interleaved) and "codegen" (including optimization). CPU
+		/// time exceeding wall time indicates parallelism within the phase.
+		std::map<std::string, PhaseTiming> phases;
+		/// Time spent parsing each source unit, with the CPU time of the thread
+		/// that parsed it. Sources served from the AST cache have no entry.
+		std::map<std::string, PhaseTiming> sources;
+		/// Time spent generating code for each contract, with the CPU time of
+		/// the thread that compiled it. Contracts restored from the artifact
+		/// cache or aliased as byte-identical duplicates have no entry.
+		std::map<std::string, PhaseTiming> contracts;
+
+		/// @returns the timings as a JSON object (used by solc --timings).
+		Json::Value toJson() const;
+	};
+
+	/// @returns the per-phase timings accumulated by the most recent parse and
+	/// compile run, for tracking compile time regressions.
+	CompilationTimings const& timings() const { return m_timings; }
+
+	/// @returns a JSON report of the memory consumed by the parsed ASTs (node
+	/// counts and byte estimates per node kind, exact arena bytes per source),
+	/// the process-wide type and string caches, and the assemblies and objects
+	/// of the compiled contracts. Usable after parse; the assembly figures are
+	/// filled in by compile.
+	Json::Value memoryAccounting() const;
+	/// @returns the minimal set of sources requiring recompilation when the given sources
+	/// change: the changed sources themselves plus everything that transitively imports them.
+	std::set<std::string> sourcesAffectedBy(std::vector<std::string> const& _changedSources) const;
+	/// @returns the names of the contracts defined in the sources affected by changes to
+	/// the given sources, in topological source order.
+	std::vector<std::string> contractsAffectedBy(std::vector<std::string> const& _changedSources) const;
+
 
 private:
 	/**
@@ -178,7 +317,16 @@ private:
 		std::shared_ptr<SourceUnit> ast;
 		std::string interface;
 		bool isLibrary = false;
-		void reset() { scanner.reset(); ast.reset(); interface.clear(); }
+		/// Hash of the source content, used to detect unchanged sources across addSource calls.
+		h256 contentHash;
+		/// Whether the content changed since the AST was last built successfully.
+		bool dirty = true;
+		/// Whether the cached AST was built in signature-only mode (function bodies skipped).
+		bool signaturesOnly = false;
+		/// Errors and warnings the parser reported for this source, replayed when the
+		/// cached AST is reused.
+		ErrorList parserErrors;
+		void reset() { scanner.reset(); ast.reset(); interface.clear(); dirty = true; signaturesOnly = false; parserErrors.clear(); }
 	};
 
 	struct Contract
@@ -191,20 +339,32 @@ private:
 		std::shared_ptr<InterfaceHandler> interfaceHandler;
 		mutable std::unique_ptr<std::string const> interface;
 		mutable std::unique_ptr<std::string const> solidityInterface;
+		mutable std::unique_ptr<std::string const> binaryInterface;
 		mutable std::unique_ptr<std::string const> userDocumentation;
 		mutable std::unique_ptr<std::string const> devDocumentation;
 
 		Contract();
 	};
 
+	/// Installs the standard sources from a process-wide snapshot that is scanned and
+	/// parsed only on first use; subsequent stacks share its scanners and ASTs.
+	void installStandardSources();
+	/// Shared implementation of parse() and parseSignatures().
+	bool parseInternal(bool _signaturesOnly);
+	/// Shared implementation of the addSource() overloads.
+	bool addSourceStream(std::string const& _name, CharStream const& _stream, h256 const& _contentHash, bool _isLibrary);
 	void resolveImports();
-	/// Compile a single contract and put the result in @a _compiledContracts.
-	void compileContract(
-		bool _optimize,
-		unsigned _runs,
+	/// @returns a fingerprint of @a _contract covering its own source text and the
+	/// fingerprints of every contract it references. Contracts with equal fingerprints
+	/// produce byte-identical code within one compilation run.
+	h256 contractFingerprint(ContractDefinition const& _contract) const;
+	h256 contractFingerprint(
 		ContractDefinition const& _contract,
-		std::map<ContractDefinition const*, eth::Assembly const*>& _compiledContracts
-	);
+		std::map<ContractDefinition const*, h256>& _memo
+	) const;
+	/// @returns the artifact cache key of @a _contract: a hash over its fingerprint, the
+	/// compiler version and every setting that influences the generated code.
+	h256 artifactCacheKey(ContractDefinition const& _contract, bool _optimize, unsigned _runs) const;
 
 	Contract const& contract(std::string const& _contractName = "") const;
 	Source const& source(std::string const& _sourceName = "") const;
@@ -213,7 +373,29 @@ private:
 	std::map<std::string const, Source> m_sources;
 	std::shared_ptr<GlobalContext> m_globalContext;
 	std::vector<Source const*> m_sourceOrder;
+	ImportGraph m_importGraph;
 	std::map<std::string const, Contract> m_contracts;
+	/// Sources whose contract bodies are checked eagerly; empty means all of them.
+	std::set<std::string> m_bodyCheckFocus;
+	/// Names of the contracts whose body checks were deferred and have not run yet.
+	std::set<std::string> m_pendingBodyChecks;
+	/// Callback notified of every recorded error, see setDiagnosticsSink().
+	ErrorSink m_diagnosticsSink;
+	/// Whether storage slots are assigned in size-sorted order, see setOptimizeStorageLayout().
+	bool m_optimizeStorageLayout = false;
+	/// Whether large type conversions are compiled to shared subroutines, see
+	/// setSharedConversionRoutines().
+	bool m_sharedConversionRoutines = false;
+	/// Whether external function arguments may stay in calldata until their first use, see
+	/// setLazyCalldataDecoding().
+	bool m_lazyCalldataDecoding = false;
+	/// Whether eligible modifier bodies are compiled as subroutines, see
+	/// setSharedModifierBodies().
+	bool m_sharedModifierBodies = false;
+	/// On-disk artifact cache, see setArtifactCacheDirectory(). Null when disabled.
+	std::shared_ptr<ArtifactCache> m_artifactCache;
+	/// Phase timings of the most recent run, see timings().
+	CompilationTimings m_timings;
 	ErrorList m_errors;
 };
 
@@ -40,32 +40,55 @@ const unsigned CompilerUtils::identityContractAddress = 4;
 
 void CompilerUtils::initialiseFreeMemoryPointer()
 {
-	m_context << u256(freeMemoryPointer + 32);
+	// The words between the free memory pointer and the initial free memory are
+	// reserved for the storage slot hash cache.
+	m_context << u256(freeMemoryPointer + 32 + 32 * CompilerContext::slotHashCacheSlots);
 	storeFreeMemoryPointer();
 }
 
 void CompilerUtils::fetchFreeMemoryPointer()
 {
-	m_context << u256(freeMemoryPointer) << eth::Instruction::MLOAD;
+	static eth::AssemblyItems const c_items{
+		u256(freeMemoryPointer),
+		eth::Instruction::MLOAD
+	};
+	m_context.appendItems(c_items);
 }
 
 void CompilerUtils::storeFreeMemoryPointer()
 {
-	m_context << u256(freeMemoryPointer) << eth::Instruction::MSTORE;
+	static eth::AssemblyItems const c_items{
+		u256(freeMemoryPointer),
+		eth::Instruction::MSTORE
+	};
+	m_context.appendItems(c_items);
 }
 
 void CompilerUtils::allocateMemory()
 {
-	fetchFreeMemoryPointer();
-	m_context << eth::Instruction::SWAP1 << eth::Instruction::DUP2 << eth::Instruction::ADD;
-	storeFreeMemoryPointer();
+	static eth::AssemblyItems const c_items{
+		u256(freeMemoryPointer),
+		eth::Instruction::MLOAD,
+		eth::Instruction::SWAP1,
+		eth::Instruction::DUP2,
+		eth::Instruction::ADD,
+		u256(freeMemoryPointer),
+		eth::Instruction::MSTORE
+	};
+	m_context.appendItems(c_items);
 }
 
 void CompilerUtils::toSizeAfterFreeMemoryPointer()
 {
-	fetchFreeMemoryPointer();
-	m_context << eth::Instruction::DUP1 << eth::Instruction::SWAP2 << eth::Instruction::SUB;
-	m_context << eth::Instruction::SWAP1;
+	static eth::AssemblyItems const c_items{
+		u256(freeMemoryPointer),
+		eth::Instruction::MLOAD,
+		eth::Instruction::DUP1,
+		eth::Instruction::SWAP2,
+		eth::Instruction::SUB,
+		eth::Instruction::SWAP1
+	};
+	m_context.appendItems(c_items);
 }
 
 unsigned CompilerUtils::loadFromMemory(
@@ -157,7 +180,126 @@ void CompilerUtils::encodeToMemory(
 	bool _encodeAsLibraryTypes
 )
 {
-	// stack: <v1> <v2> ... <vn> <mem>
+	if (m_context.sharedRoutinesEnabled())
+		if (encodeToMemoryViaSharedRoutine(
+			_givenTypes,
+			_targetTypes,
+			_padToWordBoundaries,
+			_copyDynamicDataInPlace,
+			_encodeAsLibraryTypes
+		))
+			return;
+	encodeToMemoryInline(
+		_givenTypes,
+		_targetTypes,
+		_padToWordBoundaries,
+		_copyDynamicDataInPlace,
+		_encodeAsLibraryTypes,
+		0
+	);
+}
+
+bool CompilerUtils::encodeToMemoryViaSharedRoutine(
+	TypePointers const& _givenTypes,
+	TypePointers const& _targetTypes,
+	bool _padToWordBoundaries,
+	bool _copyDynamicDataInPlace,
+	bool _encodeAsLibraryTypes
+)
+{
+	unsigned argSize = sizeOnStack(_givenTypes);
+	TypePointers targetTypes = _targetTypes.empty() ? _givenTypes : _targetTypes;
+	if (targetTypes.size() != _givenTypes.size())
+		return false;
+	// Count the dynamic head pointers the encoder will put on the stack, using the
+	// same target type resolution as the encoder itself.
+	unsigned dynPointers = 0;
+	for (TypePointer targetType: targetTypes)
+	{
+		if (targetType)
+			targetType = targetType->mobileType();
+		if (targetType)
+			targetType = targetType->interfaceType(_encodeAsLibraryTypes);
+		if (targetType)
+			targetType = targetType->encodingType();
+		if (!targetType)
+			return false;
+		if (targetType->isDynamicallySized() && !_copyDynamicDataInPlace)
+			dynPointers++;
+	}
+	// The routine's stack shuffling needs at least one value and reaches one slot
+	// deeper than the inline code because of the interposed return tag.
+	if (argSize < 1 || argSize + dynPointers + 2 > 16)
+		return false;
+
+	string name = "abiencode";
+	for (TypePointer const& type: _givenTypes)
+		name += " " + type->toString(false);
+	name += " ->";
+	for (TypePointer const& type: targetTypes)
+		name += " " + type->toString(false);
+	if (_padToWordBoundaries)
+		name += " padded";
+	if (_copyDynamicDataInPlace)
+		name += " inplace";
+	if (_encodeAsLibraryTypes)
+		name += " library";
+	switch (m_context.sharedRoutineState(name))
+	{
+	case CompilerContext::SharedRoutineState::Shared:
+		m_context.callSharedRoutine(name);
+		// The routine consumed the values below the memory pointer.
+		m_context.adjustStackOffset(-static_cast<int>(argSize));
+		return true;
+	case CompilerContext::SharedRoutineState::Inline:
+		return false;
+	case CompilerContext::SharedRoutineState::Unknown:
+	{
+		// First occurrence: generate inline and record the size.
+		m_context.setSuppressSharedRoutines(true);
+		m_context.flushPendingStackOps();
+		size_t itemsBefore = m_context.assembly().items().size();
+		encodeToMemoryInline(
+			_givenTypes,
+			_targetTypes,
+			_padToWordBoundaries,
+			_copyDynamicDataInPlace,
+			_encodeAsLibraryTypes,
+			0
+		);
+		m_context.flushPendingStackOps();
+		size_t items = m_context.assembly().items().size() - itemsBefore;
+		m_context.setSuppressSharedRoutines(false);
+		m_context.recordSharedRoutine(name, items, [=](CompilerContext& _context)
+		{
+			// Stack: [v1 ... vn returnTag mem] - encode and jump back with [end_of_mem].
+			_context.setStackOffset(static_cast<int>(argSize) + 2);
+			CompilerUtils(_context).encodeToMemoryInline(
+				_givenTypes,
+				_targetTypes,
+				_padToWordBoundaries,
+				_copyDynamicDataInPlace,
+				_encodeAsLibraryTypes,
+				1
+			);
+			_context.appendJump(eth::AssemblyItem::JumpType::OutOfFunction);
+		});
+		return true;
+	}
+	}
+	return false;
+}
+
+void CompilerUtils::encodeToMemoryInline(
+	TypePointers const& _givenTypes,
+	TypePointers const& _targetTypes,
+	bool _padToWordBoundaries,
+	bool _copyDynamicDataInPlace,
+	bool _encodeAsLibraryTypes,
+	unsigned _reservedStackSlots
+)
+{
+	// stack: <v1> <v2> ... <vn> [<reserved slots>] <mem>
 	TypePointers targetTypes = _targetTypes.empty() ? _givenTypes : _targetTypes;
 	solAssert(targetTypes.size() == _givenTypes.size(), "");
 	for (TypePointer& t: targetTypes)
@@ -186,7 +328,7 @@ void CompilerUtils::encodeToMemory(
 		}
 		else
 		{
-			copyToStackTop(argSize - stackPos + dynPointers + 2, _givenTypes[i]->sizeOnStack());
+			copyToStackTop(argSize - stackPos + dynPointers + 2 + _reservedStackSlots, _givenTypes[i]->sizeOnStack());
 			solAssert(!!targetType, "Externalable type expected.");
 			TypePointer type = targetType;
 			if (_givenTypes[i]->dataStoredIn(DataLocation::Storage) && targetType->isValueType())
@@ -241,7 +383,7 @@ void CompilerUtils::encodeToMemory(
 				solAssert(_givenTypes[i]->category() == Type::Category::Array, "Unknown dynamic type.");
 				auto const& arrayType = dynamic_cast<ArrayType const&>(*_givenTypes[i]);
 				// now copy the array
-				copyToStackTop(argSize - stackPos + dynPointers + 2, arrayType.sizeOnStack());
+				copyToStackTop(argSize - stackPos + dynPointers + 2 + _reservedStackSlots, arrayType.sizeOnStack());
 				// stack: ... <end_of_mem> <value...>
 				// copy length to memory
 				m_context << eth::dupInstruction(1 + arrayType.sizeOnStack());
@@ -263,8 +405,24 @@ void CompilerUtils::encodeToMemory(
 	}
 
 	// remove unneeded stack elements (and retain memory pointer)
-	m_context << eth::swapInstruction(argSize + dynPointers + 1);
-	popStackSlots(argSize + dynPointers + 1);
+	if (_reservedStackSlots == 0)
+	{
+		m_context << eth::swapInstruction(argSize + dynPointers + 1);
+		popStackSlots(argSize + dynPointers + 1);
+	}
+	else
+	{
+		// Stack: <v1> ... <vn> <reserved> <mem_start> <dyn_heads...> <end_of_mem>, where
+		// the reserved slot (the routine's return tag) has to end up on top of
+		// <end_of_mem> so that the caller can jump back through it.
+		solAssert(_reservedStackSlots == 1 && argSize > 0, "");
+		m_context << eth::swapInstruction(argSize + dynPointers + 2);
+		// Stack: <end_of_mem> <v2> ... <vn> <reserved> <mem_start> <dyn_heads...> <v1>
+		popStackSlots(dynPointers + 2);
+		// Stack: <end_of_mem> <v2> ... <vn> <reserved>
+		for (unsigned i = 1; i < argSize; ++i)
+			m_context << eth::Instruction::SWAP1 << eth::Instruction::POP;
+	}
 }
 
 void CompilerUtils::memoryCopy()
@@ -290,6 +448,9 @@ void CompilerUtils::convertType(Type const& _typeOnStack, Type const& _targetTyp
 
 	if (_typeOnStack == _targetType && !_cleanupNeeded)
 		return;
+	if (m_context.sharedRoutinesEnabled())
+		if (convertTypeViaSharedRoutine(_typeOnStack, _targetType, _cleanupNeeded))
+			return;
 	Type::Category stackTypeCategory = _typeOnStack.category();
 	Type::Category targetTypeCategory = _targetType.category();
 
@@ -612,6 +773,66 @@ void CompilerUtils::convertType(Type const& _typeOnStack, Type const& _targetTyp
 	}
 }
 
+bool CompilerUtils::convertTypeViaSharedRoutine(Type const& _typeOnStack, Type const& _targetType, bool _cleanupNeeded)
+{
+	// The routine bodies are generated after all function bodies, so the types have to
+	// outlive this call - only pooled integer and fixed bytes instances are captured.
+	auto pooled = [](Type const& _type) -> TypePointer
+	{
+		if (auto integerType = dynamic_cast<IntegerType const*>(&_type))
+			return TypePool::integer(
+				integerType->numBits(),
+				integerType->isAddress() ? IntegerType::Modifier::Address :
+				integerType->isSigned() ? IntegerType::Modifier::Signed :
+				IntegerType::Modifier::Unsigned
+			);
+		else if (auto fixedBytesType = dynamic_cast<FixedBytesType const*>(&_type))
+			return TypePool::fixedBytes(fixedBytesType->numBytes());
+		else
+			return TypePointer();
+	};
+	TypePointer stackType = pooled(_typeOnStack);
+	TypePointer targetType = pooled(_targetType);
+	if (!stackType || !targetType)
+		return false;
+
+	string name =
+		"convert " + stackType->toString(false) +
+		" to " + targetType->toString(false) +
+		(_cleanupNeeded ? " cleanup" : "");
+	switch (m_context.sharedRoutineState(name))
+	{
+	case CompilerContext::SharedRoutineState::Shared:
+		m_context.callSharedRoutine(name);
+		return true;
+	case CompilerContext::SharedRoutineState::Inline:
+		// Measured to be too small to amortize the call, keep inlining.
+		return false;
+	case CompilerContext::SharedRoutineState::Unknown:
+	{
+		// First occurrence: generate inline (suppressing nested sharing so that the
+		// measurement covers the full sequence) and record the size.
+		m_context.setSuppressSharedRoutines(true);
+		m_context.flushPendingStackOps();
+		size_t itemsBefore = m_context.assembly().items().size();
+		convertType(_typeOnStack, _targetType, _cleanupNeeded);
+		m_context.flushPendingStackOps();
+		size_t items = m_context.assembly().items().size() - itemsBefore;
+		m_context.setSuppressSharedRoutines(false);
+		m_context.recordSharedRoutine(name, items, [=](CompilerContext& _context)
+		{
+			// Stack: [returnTag x] - convert the top element and jump back.
+			_context.setStackOffset(2);
+			CompilerUtils(_context).convertType(*stackType, *targetType, _cleanupNeeded);
+			_context << eth::Instruction::SWAP1;
+			_context.appendJump(eth::AssemblyItem::JumpType::OutOfFunction);
+		});
+		return true;
+	}
+	}
+	return false;
+}
+
 void CompilerUtils::pushZeroValue(const Type& _type)
 {
 	auto const* referenceType = dynamic_cast<ReferenceType const*>(&_type);
@@ -731,7 +952,9 @@ void CompilerUtils::storeStringData(bytesConstRef _data)
 {
 	//@todo provide both alternatives to the optimiser
 	// stack: mempos
-	if (_data.size() <= 128)
+	// Repeated literals (e.g. a shared error message) are stored in the data section once
+	// and copied from there, so that only their first use pays for an inline copy.
+	if (_data.size() <= 128 && !m_context.constantDataSeen(_data.toBytes()))
 	{
 		for (unsigned i = 0; i < _data.size(); i += 32)
 		{
@@ -160,6 +160,34 @@ private:
 	/// Appends code that cleans higher-order bits for integer types.
 	void cleanHigherOrderBits(IntegerType const& _typeOnStack);
 
+	/// If the conversion qualifies for the shared subroutine mode (integer or fixed bytes
+	/// on both sides) and its code was measured to be worth sharing, appends a call to the
+	/// subroutine instead of the inline code and @returns true. The first occurrence of
+	/// each conversion is generated inline and measured.
+	bool convertTypeViaSharedRoutine(Type const& _typeOnStack, Type const& _targetType, bool _cleanupNeeded);
+
+	/// Implementation of encodeToMemory. If @a _reservedStackSlots is nonzero, that many
+	/// untouched slots (the enclosing routine's return tag) sit between the values and the
+	/// memory pointer and end up on top of <end_of_mem> instead of being removed.
+	void encodeToMemoryInline(
+		TypePointers const& _givenTypes,
+		TypePointers const& _targetTypes,
+		bool _padToWordBoundaries,
+		bool _copyDynamicDataInPlace,
+		bool _encodeAsLibraryTypes,
+		unsigned _reservedStackSlots
+	);
+	/// Shared subroutine version of encodeToMemory, keyed by the full type signature and
+	/// encoding flags. @returns true if a call replaced the inline code (or the first,
+	/// measured occurrence was generated).
+	bool encodeToMemoryViaSharedRoutine(
+		TypePointers const& _givenTypes,
+		TypePointers const& _targetTypes,
+		bool _padToWordBoundaries,
+		bool _copyDynamicDataInPlace,
+		bool _encodeAsLibraryTypes
+	);
+
 	/// Prepares the given type for storing in memory by shifting it if necessary.
 	unsigned prepareMemoryStore(Type const& _type, bool _padToWordBoundaries) const;
 	/// Loads type from memory assuming memory offset is on stack top.
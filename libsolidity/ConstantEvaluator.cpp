@@ -21,6 +21,8 @@
  */
 
 #include <libsolidity/ConstantEvaluator.h>
+#include <mutex>
+#include <libdevcore/Common.h>
 #include <libsolidity/AST.h>
 
 using namespace std;
@@ -47,7 +49,7 @@ void ConstantEvaluator::endVisit(BinaryOperation const& _operation)
 		BOOST_THROW_EXCEPTION(_operation.rightExpression().createTypeError("Invalid constant expression."));
 	TypePointer commonType = leftType->binaryOperatorResult(_operation.getOperator(), rightType);
 	if (Token::isCompareOp(_operation.getOperator()))
-		commonType = make_shared<BoolType>();
+		commonType = TypePool::boolean();
 	_operation.annotation().type = commonType;
 }
 
@@ -57,3 +59,226 @@ void ConstantEvaluator::endVisit(Literal const& _literal)
 	if (!_literal.annotation().type)
 		BOOST_THROW_EXCEPTION(_literal.createTypeError("Invalid literal value."));
 }
+
+namespace
+{
+
+// Folding runs lazily during code generation, where parallel contract compilation can
+// reach the same shared base-contract AST from several threads.
+mutex& foldMutex()
+{
+	static mutex foldMutex;
+	return foldMutex;
+}
+
+}
+
+shared_ptr<u256 const> ConstantFolder::fold(Expression const& _expression)
+{
+	lock_guard<mutex> guard(foldMutex());
+	if (!_expression.annotation().foldedValue)
+	{
+		ConstantFolder folder;
+		_expression.accept(folder);
+	}
+	return _expression.annotation().foldedValue;
+}
+
+void ConstantFolder::endVisit(TupleExpression const& _tuple)
+{
+	if (_tuple.components().size() == 1 && _tuple.components().front())
+		if (auto value = _tuple.components().front()->annotation().foldedValue)
+			setValue(_tuple, *value);
+}
+
+void ConstantFolder::endVisit(UnaryOperation const& _operation)
+{
+	TypePointer const& type = _operation.annotation().type;
+	if (!type)
+		return;
+	if (type->category() == Type::Category::IntegerConstant)
+	{
+		// The type checker already evaluated the operation on its constant operand.
+		setValue(_operation, type->literalValue(nullptr));
+		return;
+	}
+	shared_ptr<u256 const> sub = _operation.subExpression().annotation().foldedValue;
+	if (!sub)
+		return;
+	Token::Value const op = _operation.getOperator();
+	if (op == Token::Not)
+	{
+		if (type->category() == Type::Category::Bool)
+			setValue(_operation, *sub == 0 ? u256(1) : u256(0));
+	}
+	else if (auto intType = dynamic_cast<IntegerType const*>(type.get()))
+	{
+		bigint value = typedValue(*sub, *type);
+		if (op == Token::Sub)
+			value = -value;
+		else if (op == Token::BitNot)
+			value = -value - 1;
+		else if (op != Token::Add)
+			return; // increment, decrement and delete have side effects
+		setValue(_operation, representation(value, *intType));
+	}
+}
+
+void ConstantFolder::endVisit(BinaryOperation const& _operation)
+{
+	TypePointer const& type = _operation.annotation().type;
+	if (!type)
+		return;
+	if (type->category() == Type::Category::IntegerConstant)
+	{
+		setValue(_operation, type->literalValue(nullptr));
+		return;
+	}
+	Token::Value const op = _operation.getOperator();
+	shared_ptr<u256 const> left = _operation.leftExpression().annotation().foldedValue;
+	shared_ptr<u256 const> right = _operation.rightExpression().annotation().foldedValue;
+	if (op == Token::And || op == Token::Or)
+	{
+		// A constant left hand side alone can decide the result, because the right hand
+		// side would be short-circuited in exactly that case.
+		if (left && (*left != 0) == (op == Token::Or))
+			setValue(_operation, *left);
+		else if (left && right)
+			setValue(_operation, *right);
+		return;
+	}
+	if (!left || !right)
+		return;
+	if (Token::isCompareOp(op))
+	{
+		TypePointer const& commonType = _operation.annotation().commonType;
+		if (!commonType)
+			return;
+		bool result = false;
+		if (commonType->category() == Type::Category::Bool)
+		{
+			if (op == Token::Equal)
+				result = *left == *right;
+			else if (op == Token::NotEqual)
+				result = *left != *right;
+			else
+				return;
+		}
+		else if (dynamic_cast<IntegerType const*>(commonType.get()))
+		{
+			bigint a = typedValue(*left, *commonType);
+			bigint b = typedValue(*right, *commonType);
+			switch (op)
+			{
+			case Token::Equal: result = a == b; break;
+			case Token::NotEqual: result = a != b; break;
+			case Token::LessThan: result = a < b; break;
+			case Token::GreaterThan: result = a > b; break;
+			case Token::LessThanOrEqual: result = a <= b; break;
+			case Token::GreaterThanOrEqual: result = a >= b; break;
+			default: return;
+			}
+		}
+		else
+			return;
+		setValue(_operation, result ? u256(1) : u256(0));
+	}
+	else if (auto intType = dynamic_cast<IntegerType const*>(type.get()))
+	{
+		bigint a = typedValue(*left, *type);
+		bigint b = typedValue(*right, *type);
+		bigint value;
+		switch (op)
+		{
+		case Token::Add:
+			value = a + b;
+			break;
+		case Token::Sub:
+			value = a - b;
+			break;
+		case Token::Mul:
+			value = a * b;
+			break;
+		case Token::Div:
+			// Division by zero is left to the runtime error path.
+			if (b == 0)
+				return;
+			value = a / b;
+			break;
+		case Token::Mod:
+			if (b == 0)
+				return;
+			value = a % b;
+			break;
+		case Token::BitOr:
+		case Token::BitXor:
+		case Token::BitAnd:
+			// bigint is sign-magnitude, so restrict bit operations to non-negative values.
+			if (a < 0 || b < 0)
+				return;
+			value = op == Token::BitOr ? (a | b) : op == Token::BitXor ? (a ^ b) : (a & b);
+			break;
+		default:
+			return;
+		}
+		setValue(_operation, representation(value, *intType));
+	}
+}
+
+void ConstantFolder::endVisit(Identifier const& _identifier)
+{
+	auto variable = dynamic_cast<VariableDeclaration const*>(_identifier.annotation().referencedDeclaration);
+	if (!variable || !variable->isConstant() || !variable->value())
+		return;
+	TypePointer const& type = _identifier.annotation().type;
+	if (!type)
+		return;
+	if (!m_variablesBeingFolded.insert(variable).second)
+		return; // cyclic definition, will be rejected elsewhere
+	if (!variable->value()->annotation().foldedValue)
+		variable->value()->accept(*this);
+	m_variablesBeingFolded.erase(variable);
+	shared_ptr<u256 const> value = variable->value()->annotation().foldedValue;
+	TypePointer const& valueType = variable->value()->annotation().type;
+	if (!value || !valueType)
+		return;
+	if (auto intType = dynamic_cast<IntegerType const*>(type.get()))
+		setValue(_identifier, representation(typedValue(*value, *valueType), *intType));
+	else if (type->category() == Type::Category::Bool)
+		setValue(_identifier, *value);
+}
+
+void ConstantFolder::endVisit(Literal const& _literal)
+{
+	TypePointer const& type = _literal.annotation().type;
+	if (!type)
+		return;
+	if (type->category() == Type::Category::IntegerConstant || type->category() == Type::Category::Bool)
+		setValue(_literal, type->literalValue(&_literal));
+}
+
+void ConstantFolder::setValue(Expression const& _expression, u256 _value)
+{
+	_expression.annotation().foldedValue = make_shared<u256 const>(move(_value));
+}
+
+bigint ConstantFolder::typedValue(u256 const& _value, Type const& _type)
+{
+	if (auto constType = dynamic_cast<IntegerConstantType const*>(&_type))
+		return constType->value();
+	if (auto intType = dynamic_cast<IntegerType const*>(&_type))
+		if (intType->isSigned())
+			return bigint(u2s(_value));
+	return bigint(_value);
+}
+
+u256 ConstantFolder::representation(bigint _value, IntegerType const& _type)
+{
+	bigint const modulus = bigint(1) << _type.numBits();
+	_value %= modulus;
+	if (_value < 0)
+		_value += modulus;
+	if (_type.isSigned() && _value >= (modulus >> 1))
+		return s2u(s256(_value - modulus));
+	return u256(_value);
+}
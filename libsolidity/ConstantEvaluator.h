@@ -22,6 +22,9 @@
 
 #pragma once
 
+#include <memory>
+#include <set>
+#include <libdevcore/Common.h>
 #include <libsolidity/ASTVisitor.h>
 
 namespace dev
@@ -46,5 +49,41 @@ private:
 
 };
 
+/**
+ * Folding engine that runs after type checking. It walks an expression bottom-up and records
+ * the compile-time value of every subexpression that only depends on constants in the
+ * expression annotations, so that the code generator emits a single PUSH for the whole
+ * expression. Covers integer arithmetic, comparisons, boolean logic and references to
+ * constant state variables; anything it cannot fold is simply left without a value.
+ */
+class ConstantFolder: private ASTConstVisitor
+{
+public:
+	/// Folds @a _expression and its subexpressions, recording the values in the annotations.
+	/// @returns the value of the whole expression or an empty pointer if it is not a constant.
+	static std::shared_ptr<u256 const> fold(Expression const& _expression);
+
+private:
+	ConstantFolder() {}
+
+	virtual void endVisit(TupleExpression const& _tuple) override;
+	virtual void endVisit(UnaryOperation const& _operation) override;
+	virtual void endVisit(BinaryOperation const& _operation) override;
+	virtual void endVisit(Identifier const& _identifier) override;
+	virtual void endVisit(Literal const& _literal) override;
+
+	/// Records @a _value as the compile-time value of @a _expression.
+	static void setValue(Expression const& _expression, u256 _value);
+	/// @returns the numeric value of the representation @a _value according to @a _type.
+	static bigint typedValue(u256 const& _value, Type const& _type);
+	/// @returns the EVM representation of @a _value for @a _type, i.e. reduced modulo the
+	/// number of bits and sign-extended to 256 bits for signed types.
+	static u256 representation(bigint _value, IntegerType const& _type);
+
+	/// Constant variables whose initial values are currently being folded, used to bail
+	/// out on cyclic definitions.
+	std::set<VariableDeclaration const*> m_variablesBeingFolded;
+};
+
 }
 }
@@ -21,6 +21,7 @@
  */
 
 #include <libsolidity/DeclarationContainer.h>
+#include <libsolidity/ASTStringPool.h>
 #include <libsolidity/AST.h>
 #include <libsolidity/Types.h>
 
@@ -28,15 +29,104 @@ using namespace std;
 using namespace dev;
 using namespace dev::solidity;
 
+atomic<size_t> DeclarationContainer::s_registrationEpoch{0};
+
+size_t DeclarationContainer::SymbolTable::probeFor(ASTString const& _name, size_t _hash) const
+{
+	size_t mask = m_slots.size() - 1;
+	size_t firstReusable = c_emptySlot;
+	for (size_t slot = _hash & mask; ; slot = (slot + 1) & mask)
+	{
+		size_t index = m_slots[slot];
+		if (index == c_emptySlot)
+			return firstReusable == c_emptySlot ? slot : firstReusable;
+		if (index == c_tombstone)
+		{
+			if (firstReusable == c_emptySlot)
+				firstReusable = slot;
+			continue;
+		}
+		Entry const& entry = m_entries[index];
+		if (entry.hash == _hash && entry.name == _name)
+			return slot;
+	}
+}
+
+void DeclarationContainer::SymbolTable::rehash(size_t _minSlots)
+{
+	size_t slotCount = 8;
+	while (slotCount < _minSlots)
+		slotCount *= 2;
+	m_slots.assign(slotCount, c_emptySlot);
+	m_tombstones = 0;
+	size_t mask = slotCount - 1;
+	for (size_t index = 0; index < m_entries.size(); ++index)
+	{
+		size_t slot = m_entries[index].hash & mask;
+		while (m_slots[slot] != c_emptySlot)
+			slot = (slot + 1) & mask;
+		m_slots[slot] = index;
+	}
+}
+
+vector<Declaration const*> const* DeclarationContainer::SymbolTable::find(ASTString const& _name) const
+{
+	if (m_entries.empty())
+		return nullptr;
+	size_t slot = probeFor(_name, ASTStringPool::hash(_name));
+	size_t index = m_slots[slot];
+	if (index == c_emptySlot || index == c_tombstone)
+		return nullptr;
+	return &m_entries[index].declarations;
+}
+
+vector<Declaration const*>& DeclarationContainer::SymbolTable::operator[](ASTString const& _name)
+{
+	// Keep the load factor (including tombstones) below 3/4.
+	if (m_slots.empty() || (m_entries.size() + m_tombstones + 1) * 4 > m_slots.size() * 3)
+		rehash(m_slots.empty() ? 8 : m_slots.size() * 2);
+	size_t hash = ASTStringPool::hash(_name);
+	size_t slot = probeFor(_name, hash);
+	size_t index = m_slots[slot];
+	if (index != c_emptySlot && index != c_tombstone)
+		return m_entries[index].declarations;
+	m_slots[slot] = m_entries.size();
+	m_entries.push_back(Entry{hash, _name, {}});
+	return m_entries.back().declarations;
+}
+
+void DeclarationContainer::SymbolTable::erase(ASTString const& _name)
+{
+	if (m_entries.empty())
+		return;
+	size_t slot = probeFor(_name, ASTStringPool::hash(_name));
+	size_t index = m_slots[slot];
+	if (index == c_emptySlot || index == c_tombstone)
+		return;
+	// Move the last entry into the freed position to keep the entry vector
+	// dense, then redirect its slot (looked up before the move so that
+	// probing still sees the entry under its old index).
+	size_t lastIndex = m_entries.size() - 1;
+	if (index != lastIndex)
+	{
+		size_t movedSlot = probeFor(m_entries[lastIndex].name, m_entries[lastIndex].hash);
+		m_entries[index] = move(m_entries[lastIndex]);
+		m_slots[movedSlot] = index;
+	}
+	m_entries.pop_back();
+	m_slots[slot] = c_tombstone;
+	m_tombstones++;
+}
+
 Declaration const* DeclarationContainer::conflictingDeclaration(Declaration const& _declaration) const
 {
 	ASTString const& declarationName(_declaration.name());
 	solAssert(!declarationName.empty(), "");
 	vector<Declaration const*> declarations;
-	if (m_declarations.count(declarationName))
-		declarations += m_declarations.at(declarationName);
-	if (m_invisibleDeclarations.count(declarationName))
-		declarations += m_invisibleDeclarations.at(declarationName);
+	if (auto visible = m_declarations.find(declarationName))
+		declarations += *visible;
+	if (auto invisible = m_invisibleDeclarations.find(declarationName))
+		declarations += *invisible;
 
 	if (dynamic_cast<FunctionDefinition const*>(&_declaration))
 	{
@@ -70,16 +160,33 @@ bool DeclarationContainer::registerDeclaration(Declaration const& _declaration,
 		m_invisibleDeclarations[declarationName].push_back(&_declaration);
 	else
 		m_declarations[declarationName].push_back(&_declaration);
+	// Registrations invalidate the resolution caches of all containers, since
+	// a cached recursive lookup may have considered this scope.
+	++s_registrationEpoch;
 	return true;
 }
 
-std::vector<Declaration const*> DeclarationContainer::resolveName(ASTString const& _name, bool _recursive) const
+vector<Declaration const*> DeclarationContainer::resolveName(ASTString const& _name, bool _recursive) const
 {
 	solAssert(!_name.empty(), "Attempt to resolve empty name.");
-	auto result = m_declarations.find(_name);
-	if (result != m_declarations.end())
-		return result->second;
-	if (_recursive && m_enclosingContainer)
-		return m_enclosingContainer->resolveName(_name, true);
-	return vector<Declaration const*>({});
+	if (!_recursive)
+	{
+		if (auto declarations = m_declarations.find(_name))
+			return *declarations;
+		return vector<Declaration const*>({});
+	}
+	if (m_cacheEpoch != s_registrationEpoch)
+	{
+		m_resolutionCache = SymbolTable();
+		m_cacheEpoch = s_registrationEpoch;
+	}
+	if (auto cached = m_resolutionCache.find(_name))
+		return *cached;
+	vector<Declaration const*> result;
+	if (auto declarations = m_declarations.find(_name))
+		result = *declarations;
+	else if (m_enclosingContainer)
+		result = m_enclosingContainer->resolveName(_name, true);
+	m_resolutionCache[_name] = result;
+	return result;
 }
@@ -22,8 +22,8 @@
 
 #pragma once
 
-#include <map>
-#include <set>
+#include <atomic>
+#include <vector>
 #include <boost/noncopyable.hpp>
 
 #include <libsolidity/ASTForward.h>
@@ -40,6 +40,53 @@ namespace solidity
 class DeclarationContainer
 {
 public:
+	/// One name of a scope together with the declarations registered under it.
+	struct Entry
+	{
+		size_t hash = 0;
+		ASTString name;
+		std::vector<Declaration const*> declarations;
+	};
+
+	/**
+	 * Hash table from names to declaration lists: open addressing with linear
+	 * probing over a power-of-two slot array. The slots store indices into a
+	 * dense entry vector, so iteration is cache-linear and follows insertion
+	 * order. Hashes are precomputed once per lookup (the same function the
+	 * interning pool uses), avoiding the per-node string comparisons of a
+	 * tree-based map.
+	 */
+	class SymbolTable
+	{
+	public:
+		/// @returns the declarations registered for @a _name or nullptr if there are none.
+		std::vector<Declaration const*> const* find(ASTString const& _name) const;
+		/// @returns the declaration list for @a _name, inserting an empty one if not present.
+		std::vector<Declaration const*>& operator[](ASTString const& _name);
+		void erase(ASTString const& _name);
+		size_t count(ASTString const& _name) const { return find(_name) ? 1 : 0; }
+		/// The entries in insertion order (all entries are valid, there are no holes).
+		std::vector<Entry> const& entries() const { return m_entries; }
+
+	private:
+		/// Marker for a slot that never held an entry.
+		static size_t const c_emptySlot = ~size_t(0);
+		/// Marker for a slot whose entry was erased; probing continues across it.
+		static size_t const c_tombstone = ~size_t(0) - 1;
+
+		/// Grows the slot array to at least @a _minSlots (a power of two) and re-probes all entries.
+		void rehash(size_t _minSlots);
+		/// @returns the slot index for @a _name: either the slot holding it or the first
+		/// reusable slot where it would be inserted.
+		size_t probeFor(ASTString const& _name, size_t _hash) const;
+
+		std::vector<size_t> m_slots;
+		std::vector<Entry> m_entries;
+		/// Number of tombstoned slots; counted towards the load factor so that
+		/// probe chains always terminate at an empty slot.
+		size_t m_tombstones = 0;
+	};
+
 	explicit DeclarationContainer(
 		Declaration const* _enclosingDeclaration = nullptr,
 		DeclarationContainer const* _enclosingContainer = nullptr
@@ -52,15 +99,23 @@ public:
 	bool registerDeclaration(Declaration const& _declaration, bool _invisible = false, bool _update = false);
 	std::vector<Declaration const*> resolveName(ASTString const& _name, bool _recursive = false) const;
 	Declaration const* enclosingDeclaration() const { return m_enclosingDeclaration; }
-	std::map<ASTString, std::vector<Declaration const*>> const& declarations() const { return m_declarations; }
+	std::vector<Entry> const& declarations() const { return m_declarations.entries(); }
 	/// @returns whether declaration is valid, and if not also returns previous declaration.
 	Declaration const* conflictingDeclaration(Declaration const& _declaration) const;
 
 private:
 	Declaration const* m_enclosingDeclaration;
 	DeclarationContainer const* m_enclosingContainer;
-	std::map<ASTString, std::vector<Declaration const*>> m_declarations;
-	std::map<ASTString, std::vector<Declaration const*>> m_invisibleDeclarations;
+	SymbolTable m_declarations;
+	SymbolTable m_invisibleDeclarations;
+	/// Cache for recursive lookups: repeated references to the same name inside a
+	/// function body hit a single probe instead of walking the scope chain. Flushed
+	/// whenever any container registers a declaration (see s_registrationEpoch).
+	mutable SymbolTable m_resolutionCache;
+	/// Epoch at which m_resolutionCache was last valid.
+	mutable size_t m_cacheEpoch = 0;
+	/// Bumped by every registration in any container; invalidates all caches.
+	static std::atomic<size_t> s_registrationEpoch;
 };
 
 }
@@ -23,9 +23,22 @@
 #include <libsolidity/Exceptions.h>
 #include <libsolidity/Utils.h>
 
+using namespace std;
 using namespace dev;
 using namespace dev::solidity;
 
+string const* Error::description() const
+{
+	if (m_descriptionFormatter)
+	{
+		m_description = m_descriptionFormatter();
+		m_descriptionFormatter = DescriptionFormatter();
+	}
+	if (!m_description.empty())
+		return &m_description;
+	return boost::get_error_info<errinfo_comment>(*this);
+}
+
 Error::Error(Type _type): m_type(_type)
 {
 	switch(m_type)
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <utility>
 #include <libdevcore/Exceptions.h>
@@ -33,6 +34,10 @@ namespace solidity
 {
 class Error;
 using ErrorList = std::vector<std::shared_ptr<Error const>>;
+/// Callback invoked each time a component records an error or warning, directly
+/// after it was appended to the component's error list. Returning false requests
+/// cancellation of the surrounding compilation step.
+using ErrorSink = std::function<bool(Error const&)>;
 
 struct CompilerError: virtual Exception {};
 struct InternalCompilerError: virtual Exception {};
@@ -50,11 +55,25 @@ public:
 		Warning
 	};
 
+	/// Builds the description string of an error on demand so that errors
+	/// which are never rendered do not pay for string formatting.
+	using DescriptionFormatter = std::function<std::string()>;
+
 	explicit Error(Type _type);
 
 	Type type() const { return m_type; }
 	std::string const& typeName() const { return m_typeName; }
 
+	/// Records an already formatted description.
+	void setDescription(std::string _description) { m_description = std::move(_description); }
+	/// Defers building the description until @a description() is first called.
+	/// Anything the formatter captures has to stay valid until then.
+	void setDescriptionFormatter(DescriptionFormatter _formatter) { m_descriptionFormatter = std::move(_formatter); }
+	/// @returns the description, invoking and discarding a pending formatter on
+	/// first use, falling back to an eagerly attached errinfo_comment, or
+	/// nullptr if the error carries no description at all.
+	std::string const* description() const;
+
 	/// helper functions
 	static Error const* containsErrorOfType(ErrorList const& _list, Error::Type _type)
 	{
@@ -77,6 +96,9 @@ public:
 private:
 	Type m_type;
 	std::string m_typeName;
+	/// Builds m_description on demand; cleared after the first invocation.
+	mutable DescriptionFormatter m_descriptionFormatter;
+	mutable std::string m_description;
 };
 
 
@@ -22,11 +22,14 @@
 
 #include <utility>
 #include <numeric>
+#include <set>
+#include <sstream>
 #include <boost/range/adaptor/reversed.hpp>
 #include <libevmcore/Params.h>
 #include <libdevcore/Common.h>
 #include <libdevcore/SHA3.h>
 #include <libsolidity/AST.h>
+#include <libsolidity/ConstantEvaluator.h>
 #include <libsolidity/ExpressionCompiler.h>
 #include <libsolidity/CompilerContext.h>
 #include <libsolidity/CompilerUtils.h>
@@ -41,6 +44,7 @@ namespace solidity
 
 void ExpressionCompiler::compile(Expression const& _expression)
 {
+	ConstantFolder::fold(_expression);
 	_expression.accept(*this);
 }
 
@@ -51,6 +55,7 @@ void ExpressionCompiler::appendStateVariableInitialization(VariableDeclaration c
 	TypePointer type = _varDecl.value()->annotation().type;
 	solAssert(!!type, "Type information not available.");
 	CompilerContext::LocationSetter locationSetter(m_context, _varDecl);
+	ConstantFolder::fold(*_varDecl.value());
 	_varDecl.value()->accept(*this);
 
 	if (_varDecl.annotation().type->dataStoredIn(DataLocation::Storage))
@@ -70,6 +75,7 @@ void ExpressionCompiler::appendStateVariableInitialization(VariableDeclaration c
 void ExpressionCompiler::appendConstStateVariableAccessor(VariableDeclaration const& _varDecl)
 {
 	solAssert(_varDecl.isConstant(), "");
+	ConstantFolder::fold(*_varDecl.value());
 	_varDecl.value()->accept(*this);
 	utils().convertType(*_varDecl.value()->annotation().type, *_varDecl.annotation().type);
 
@@ -243,6 +249,8 @@ bool ExpressionCompiler::visit(UnaryOperation const& _unaryOperation)
 	// the operator should know how to convert itself and to which types it applies, so
 	// put this code together with "Type::acceptsBinary/UnaryOperator" into a class that
 	// represents the operator
+	if (pushFoldedConstant(_unaryOperation))
+		return false;
 	if (_unaryOperation.annotation().type->category() == Type::Category::IntegerConstant)
 	{
 		m_context << _unaryOperation.annotation().type->literalValue(nullptr);
@@ -316,6 +324,8 @@ bool ExpressionCompiler::visit(BinaryOperation const& _binaryOperation)
 	Type const& commonType = *_binaryOperation.annotation().commonType;
 	Token::Value const c_op = _binaryOperation.getOperator();
 
+	if (pushFoldedConstant(_binaryOperation))
+		return false;
 	if (c_op == Token::And || c_op == Token::Or) // special case: short-circuiting
 		appendAndOrOperatorCode(_binaryOperation);
 	else if (commonType.category() == Type::Category::IntegerConstant)
@@ -688,9 +698,20 @@ bool ExpressionCompiler::visit(NewExpression const&)
 	return false;
 }
 
+bool ExpressionCompiler::visit(MemberAccess const& _memberAccess)
+{
+	// A loop-invariant access hoisted into a stack slot does not evaluate its subexpression.
+	return !m_context.isHoistedExpression(_memberAccess);
+}
+
 void ExpressionCompiler::endVisit(MemberAccess const& _memberAccess)
 {
 	CompilerContext::LocationSetter locationSetter(m_context, _memberAccess);
+	if (m_context.isHoistedExpression(_memberAccess))
+	{
+		m_context.appendHoistedValue(_memberAccess);
+		return;
+	}
 	ASTString const& member = _memberAccess.memberName();
 	switch (_memberAccess.expression().annotation().type->category())
 	{
@@ -886,6 +907,24 @@ bool ExpressionCompiler::visit(IndexAccess const& _indexAccess)
 		// stack: storage_base_ref
 		TypePointer keyType = dynamic_cast<MappingType const&>(baseType).keyType();
 		solAssert(_indexAccess.indexExpression(), "Index expression expected.");
+		// Hashes of execution-stable keys are kept in reserved memory words and reused
+		// within straight-line code instead of being recomputed.
+		string fingerprint = slotHashCacheFingerprint(_indexAccess);
+		if (!fingerprint.empty())
+		{
+			int cacheSlot = m_context.cachedSlotHashOffset(fingerprint);
+			if (cacheSlot >= 0)
+			{
+				// drop the state variable's constant slot pushed by the base expression
+				m_context << eth::Instruction::POP;
+				m_context
+					<< u256(CompilerUtils::freeMemoryPointer + 32 + 32 * cacheSlot)
+					<< eth::Instruction::MLOAD;
+				m_context << u256(0);
+				setLValueToStorageItem(_indexAccess);
+				return false;
+			}
+		}
 		if (keyType->isDynamicallySized())
 		{
 			_indexAccess.indexExpression()->accept(*this);
@@ -912,6 +951,15 @@ bool ExpressionCompiler::visit(IndexAccess const& _indexAccess)
 			m_context << u256(0);
 		}
 		m_context << eth::Instruction::SHA3;
+		if (!fingerprint.empty())
+		{
+			int cacheSlot = m_context.assignSlotHashCache(fingerprint);
+			if (cacheSlot >= 0)
+				m_context
+					<< eth::Instruction::DUP1
+					<< u256(CompilerUtils::freeMemoryPointer + 32 + 32 * cacheSlot)
+					<< eth::Instruction::MSTORE;
+		}
 		m_context << u256(0);
 		setLValueToStorageItem(_indexAccess);
 	}
@@ -965,6 +1013,11 @@ bool ExpressionCompiler::visit(IndexAccess const& _indexAccess)
 void ExpressionCompiler::endVisit(Identifier const& _identifier)
 {
 	CompilerContext::LocationSetter locationSetter(m_context, _identifier);
+	if (m_context.isHoistedExpression(_identifier))
+	{
+		m_context.appendHoistedValue(_identifier);
+		return;
+	}
 	Declaration const* declaration = _identifier.annotation().referencedDeclaration;
 	if (MagicVariableDeclaration const* magicVar = dynamic_cast<MagicVariableDeclaration const*>(declaration))
 	{
@@ -989,7 +1042,7 @@ void ExpressionCompiler::endVisit(Identifier const& _identifier)
 	{
 		if (!variable->isConstant())
 			setLValueFromDeclaration(*declaration, _identifier);
-		else
+		else if (!pushFoldedConstant(_identifier))
 		{
 			variable->value()->accept(*this);
 			utils().convertType(*variable->value()->annotation().type, *variable->annotation().type);
@@ -1036,11 +1089,90 @@ void ExpressionCompiler::endVisit(Literal const& _literal)
 	}
 }
 
+bool ExpressionCompiler::pushFoldedConstant(Expression const& _expression)
+{
+	// Routed through the folder so that the annotation access is synchronized with
+	// parallel compilations folding the same shared AST.
+	shared_ptr<u256 const> value = ConstantFolder::fold(_expression);
+	if (!value || _expression.annotation().lValueRequested)
+		return false;
+	m_context << *value;
+	return true;
+}
+
+string ExpressionCompiler::slotHashCacheFingerprint(IndexAccess const& _indexAccess)
+{
+	// The base has to be a state variable so that the computed hash is fully determined
+	// by the key value and the variable's constant slot.
+	auto base = dynamic_cast<Identifier const*>(&_indexAccess.baseExpression());
+	if (!base)
+		return string();
+	Declaration const* declaration = base->annotation().referencedDeclaration;
+	if (!declaration || !m_context.isStateVariable(declaration))
+		return string();
+	solAssert(_indexAccess.indexExpression(), "");
+	Expression const& index = *_indexAccess.indexExpression();
+	string key;
+	if (auto value = ConstantFolder::fold(index))
+		key = "const:" + value->str();
+	else if (auto member = dynamic_cast<MemberAccess const*>(&index))
+	{
+		auto magic = dynamic_cast<Identifier const*>(&member->expression());
+		if (!magic || !dynamic_cast<MagicVariableDeclaration const*>(magic->annotation().referencedDeclaration))
+			return string();
+		string name = magic->name() + "." + member->memberName();
+		// Environment values that cannot change during one execution (msg.gas can).
+		static set<string> const c_stableValues{
+			"msg.sender", "msg.value", "tx.origin", "tx.gasprice",
+			"block.coinbase", "block.timestamp", "block.number",
+			"block.difficulty", "block.gaslimit"
+		};
+		if (!c_stableValues.count(name))
+			return string();
+		key = "env:" + name;
+	}
+	else if (auto identifier = dynamic_cast<Identifier const*>(&index))
+	{
+		// `now` is an alias for block.timestamp
+		if (
+			identifier->name() != "now" ||
+			!dynamic_cast<MagicVariableDeclaration const*>(identifier->annotation().referencedDeclaration)
+		)
+			return string();
+		key = "env:block.timestamp";
+	}
+	else
+		return string();
+	ostringstream fingerprint;
+	fingerprint << static_cast<void const*>(declaration) << "/" << key;
+	return fingerprint.str();
+}
+
 void ExpressionCompiler::appendAndOrOperatorCode(BinaryOperation const& _binaryOperation)
 {
 	Token::Value const c_op = _binaryOperation.getOperator();
 	solAssert(c_op == Token::Or || c_op == Token::And, "");
 
+	// A constant operand that does not decide the result on its own reduces the
+	// expression to the other operand; the deciding case folds the whole expression
+	// and never reaches this point (see pushFoldedConstant).
+	if (auto left = ConstantFolder::fold(_binaryOperation.leftExpression()))
+	{
+		solAssert((*left != 0) == (c_op == Token::And), "");
+		_binaryOperation.rightExpression().accept(*this);
+		return;
+	}
+	if (auto right = ConstantFolder::fold(_binaryOperation.rightExpression()))
+	{
+		_binaryOperation.leftExpression().accept(*this);
+		if ((*right != 0) != (c_op == Token::And))
+			// `x && false` / `x || true`: the left operand is still evaluated for its
+			// side effects, but the result is the constant.
+			m_context << eth::Instruction::POP << (c_op == Token::And ? u256(0) : u256(1));
+		// else `x && true` / `x || false`: the result is just the left operand.
+		return;
+	}
+
 	_binaryOperation.leftExpression().accept(*this);
 	m_context << eth::Instruction::DUP1;
 	if (c_op == Token::And)
@@ -1348,6 +1480,8 @@ void ExpressionCompiler::setLValueFromDeclaration(Declaration const& _declaratio
 {
 	if (m_context.isLocalVariable(&_declaration))
 		setLValue<StackVariable>(_expression, dynamic_cast<VariableDeclaration const&>(_declaration));
+	else if (m_context.isCalldataVariable(&_declaration))
+		setLValue<CalldataVariable>(_expression, dynamic_cast<VariableDeclaration const&>(_declaration));
 	else if (m_context.isStateVariable(&_declaration))
 		setLValue<StorageItem>(_expression, dynamic_cast<VariableDeclaration const&>(_declaration));
 	else
@@ -77,6 +77,7 @@ private:
 	virtual bool visit(BinaryOperation const& _binaryOperation) override;
 	virtual bool visit(FunctionCall const& _functionCall) override;
 	virtual bool visit(NewExpression const& _newExpression) override;
+	virtual bool visit(MemberAccess const& _memberAccess) override;
 	virtual void endVisit(MemberAccess const& _memberAccess) override;
 	virtual bool visit(IndexAccess const& _indexAccess) override;
 	virtual void endVisit(Identifier const& _identifier) override;
@@ -102,6 +103,15 @@ private:
 	/// expected to be on the stack and is updated by this call.
 	void appendExpressionCopyToMemory(Type const& _expectedType, Expression const& _expression);
 
+	/// Pushes the value recorded by constant folding for @a _expression, if there is one.
+	/// @returns true if a value was pushed and no further code is needed for the expression.
+	bool pushFoldedConstant(Expression const& _expression);
+
+	/// @returns a fingerprint identifying the slot hash computed by a mapping access
+	/// whose key cannot change during execution, or an empty string if the access does
+	/// not qualify for the slot hash cache (see CompilerContext::cachedSlotHashOffset).
+	std::string slotHashCacheFingerprint(IndexAccess const& _indexAccess);
+
 	/// Sets the current LValue to a new one (of the appropriate type) from the given declaration.
 	/// Also retrieves the value if it was not requested by @a _expression.
 	void setLValueFromDeclaration(Declaration const& _declaration, Expression const& _expression);
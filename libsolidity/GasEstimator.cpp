@@ -21,13 +21,17 @@
  */
 
 #include "GasEstimator.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <map>
 #include <functional>
 #include <memory>
+#include <thread>
 #include <libdevcore/SHA3.h>
 #include <libevmasm/ControlFlowGraph.h>
 #include <libevmasm/KnownState.h>
-#include <libevmasm/PathGasMeter.h>
+#include <libevmasm/SemanticInformation.h>
 #include <libsolidity/AST.h>
 #include <libsolidity/ASTVisitor.h>
 #include <libsolidity/CompilerUtils.h>
@@ -37,23 +41,280 @@ using namespace dev;
 using namespace dev::eth;
 using namespace dev::solidity;
 
+size_t const GasEstimator::c_defaultPathBudget;
+
+namespace
+{
+
+/// Accumulator for GasConsumption values that keeps the running sum in a native 64 bit
+/// integer as long as it fits and only falls back to 256 bit arithmetic once a summand
+/// or the sum itself leaves that range. Real-world gas figures practically always stay
+/// in the fast representation, which avoids multiprecision additions in the per-item
+/// metering loop.
+class GasAccumulator
+{
+public:
+	void add(GasEstimator::GasConsumption const& _gas)
+	{
+		if (_gas.isInfinite)
+			m_isInfinite = true;
+		if (m_isInfinite)
+			return;
+		if (!m_promoted && _gas.value <= u256(numeric_limits<uint64_t>::max()))
+		{
+			uint64_t value = uint64_t(_gas.value);
+			if (m_small <= numeric_limits<uint64_t>::max() - value)
+			{
+				m_small += value;
+				return;
+			}
+		}
+		promote();
+		m_large += _gas.value;
+	}
+	void add(GasAccumulator const& _other) { add(_other.toGasConsumption()); }
+	GasEstimator::GasConsumption toGasConsumption() const
+	{
+		if (m_isInfinite)
+			return GasEstimator::GasConsumption::infinite();
+		GasEstimator::GasConsumption gas;
+		gas.value = m_promoted ? m_large : u256(m_small);
+		return gas;
+	}
+
+private:
+	void promote()
+	{
+		if (!m_promoted)
+		{
+			m_large = m_small;
+			m_promoted = true;
+		}
+	}
+
+	bool m_isInfinite = false;
+	bool m_promoted = false;
+	uint64_t m_small = 0;
+	u256 m_large;
+};
+
+/// One pending execution path of the bounded path explorer below.
+struct GasPath
+{
+	size_t index = 0;
+	shared_ptr<KnownState> state;
+	GasEstimator::GasConsumption gas;
+	set<size_t> visitedJumpdests;
+};
+
+/**
+ * Path explorer used for functional gas estimation. Follows execution paths through a list
+ * of assembly items, metering each path with a GasMeter seeded from the path's abstract
+ * state, and returns the maximum over all terminal path costs.
+ *
+ * Two mechanisms keep the exploration bounded:
+ * - Worst-case memoisation per jump destination: a path entering a destination with no more
+ *   gas spent than a previously seen path is dropped - its suffix cannot increase the
+ *   maximum. This coarsens the abstract state at the destination to its program counter.
+ * - A path budget: once the given number of paths has been metered, exploration stops and
+ *   the result is marked as a lower bound.
+ */
+class BoundedPathGasMeter
+{
+public:
+	BoundedPathGasMeter(AssemblyItems const& _items, size_t _pathBudget):
+		m_items(_items), m_remainingPaths(_pathBudget)
+	{
+		for (size_t i = 0; i < m_items.size(); ++i)
+			if (m_items[i].type() == Tag)
+				m_tagPositions[m_items[i].data()] = i;
+	}
+
+	GasEstimator::FunctionalGasEstimation estimateMax(
+		size_t _startIndex,
+		shared_ptr<KnownState> const& _state
+	)
+	{
+		unique_ptr<GasPath> startPath(new GasPath());
+		startPath->index = _startIndex;
+		startPath->state = _state->copy();
+		queue(move(startPath));
+
+		GasEstimator::FunctionalGasEstimation result;
+		while (!m_queue.empty() && !result.gas.isInfinite)
+		{
+			if (m_remainingPaths == 0)
+			{
+				// Unexplored paths remain, so the maximum found so far only
+				// bounds the worst case from below.
+				result.isLowerBound = true;
+				break;
+			}
+			--m_remainingPaths;
+			GasEstimator::GasConsumption pathGas = handleQueueItem();
+			if (pathGas.isInfinite || (!result.gas.isInfinite && pathGas.value > result.gas.value))
+				result.gas = pathGas;
+		}
+		return result;
+	}
+
+private:
+	void queue(unique_ptr<GasPath>&& _newPath)
+	{
+		auto it = m_highestGasUsagePerJumpdest.find(_newPath->index);
+		if (it != m_highestGasUsagePerJumpdest.end())
+		{
+			GasEstimator::GasConsumption const& known = it->second;
+			if (known.isInfinite || (!_newPath->gas.isInfinite && _newPath->gas.value <= known.value))
+				return;
+		}
+		m_highestGasUsagePerJumpdest[_newPath->index] = _newPath->gas;
+		m_queue[_newPath->index] = move(_newPath);
+	}
+
+	/// Meters the pending path with the largest start index until it ends, branches or
+	/// turns out to loop. Branch targets are queued as new paths.
+	GasEstimator::GasConsumption handleQueueItem()
+	{
+		assertThrow(!m_queue.empty(), OptimizerException, "");
+		unique_ptr<GasPath> path = move(m_queue.rbegin()->second);
+		m_queue.erase(--m_queue.end());
+
+		shared_ptr<KnownState> state = path->state;
+		GasMeter meter(state);
+		ExpressionClasses& classes = state->expressionClasses();
+		GasEstimator::GasConsumption gas = path->gas;
+		size_t index = path->index;
+		while (index < m_items.size() && !gas.isInfinite)
+		{
+			bool branchStops = false;
+			AssemblyItem const& item = m_items.at(index);
+			if (item.type() == Tag)
+			{
+				// Reaching the same jump destination twice on one path means a loop
+				// whose trip count we cannot bound.
+				if (path->visitedJumpdests.count(index))
+					return GasEstimator::GasConsumption::infinite();
+				path->visitedJumpdests.insert(index);
+			}
+			else if (item == AssemblyItem(Instruction::JUMP) || item == AssemblyItem(Instruction::JUMPI))
+			{
+				// Resolve the target from the abstract stack before the jump pops it.
+				ExpressionClasses::Id targetId = state->stackElement(state->stackHeight(), item.location());
+				AssemblyItem const* target = classes.representative(targetId).item;
+				bool unconditional = item == AssemblyItem(Instruction::JUMP);
+				gas += meter.estimateMax(item);
+				if (!target || target->type() != PushTag || !m_tagPositions.count(target->data()))
+					return GasEstimator::GasConsumption::infinite();
+				unique_ptr<GasPath> branch(new GasPath());
+				branch->index = m_tagPositions.at(target->data());
+				branch->state = state->copy();
+				branch->gas = gas;
+				branch->visitedJumpdests = path->visitedJumpdests;
+				queue(move(branch));
+				if (unconditional)
+					return gas;
+				++index;
+				continue;
+			}
+			else if (item.type() == Operation && SemanticInformation::altersControlFlow(item))
+				branchStops = true;
+			gas += meter.estimateMax(item);
+			++index;
+			if (branchStops)
+				break;
+		}
+		return gas;
+	}
+
+	AssemblyItems const& m_items;
+	size_t m_remainingPaths;
+	std::map<u256, size_t> m_tagPositions;
+	/// Largest gas usage seen so far upon entering each jump destination.
+	std::map<size_t, GasEstimator::GasConsumption> m_highestGasUsagePerJumpdest;
+	std::map<size_t, unique_ptr<GasPath>> m_queue;
+};
+
+}
+
 GasEstimator::ASTGasConsumptionSelfAccumulated GasEstimator::structuralEstimation(
 	AssemblyItems const& _items,
 	vector<ASTNode const*> const& _ast
 )
 {
 	solAssert(std::count(_ast.begin(), _ast.end(), nullptr) == 0, "");
-	map<SourceLocation, GasConsumption> particularCosts;
+	map<SourceLocation, GasAccumulator> particularCosts;
 
+	// Metering is independent per basic block (each block carries its own
+	// start state), so the blocks - and with them the functions they make up -
+	// are distributed over a pool of threads. Each worker fills a per-block
+	// map; the maps are summed up below, so the result is identical to that
+	// of a sequential walk.
 	ControlFlowGraph cfg(_items);
+	vector<BasicBlock const*> blocks;
 	for (BasicBlock const& block: cfg.optimisedBlocks())
+		blocks.push_back(&block);
+	vector<map<SourceLocation, GasAccumulator>> blockCosts(blocks.size());
+	vector<exception_ptr> workerExceptions(blocks.size());
+	atomic<size_t> nextBlock(0);
+	auto meterWorker = [&]()
+	{
+		for (size_t i = nextBlock++; i < blocks.size(); i = nextBlock++)
+			try
+			{
+				BasicBlock const& block = *blocks[i];
+				assertThrow(!!block.startState, OptimizerException, "");
+				GasMeter meter(block.startState->copy());
+				auto const end = _items.begin() + block.end;
+				for (auto iter = _items.begin() + block.begin; iter != end; ++iter)
+					blockCosts[i][iter->location()].add(meter.estimateMax(*iter));
+			}
+			catch (...)
+			{
+				workerExceptions[i] = current_exception();
+			}
+	};
+	size_t threadCount = min(blocks.size(), size_t(max(1u, thread::hardware_concurrency())));
+	if (threadCount <= 1)
+		meterWorker();
+	else
 	{
-		assertThrow(!!block.startState, OptimizerException, "");
-		GasMeter meter(block.startState->copy());
-		auto const end = _items.begin() + block.end;
-		for (auto iter = _items.begin() + block.begin; iter != end; ++iter)
-			particularCosts[iter->location()] += meter.estimateMax(*iter);
+		vector<thread> workers;
+		for (size_t i = 0; i < threadCount; ++i)
+			workers.emplace_back(meterWorker);
+		for (thread& worker: workers)
+			worker.join();
 	}
+	for (size_t i = 0; i < blocks.size(); ++i)
+	{
+		if (workerExceptions[i])
+			rethrow_exception(workerExceptions[i]);
+		for (auto const& cost: blockCosts[i])
+			particularCosts[cost.first].add(cost.second);
+	}
+
+	// Flattened into a sorted vector for the attribution sweep below: the
+	// lookups are pure reads, and probing the tree map directly would insert a
+	// default entry for every covered location that never received a cost.
+	vector<pair<SourceLocation, GasConsumption>> sortedCosts;
+	sortedCosts.reserve(particularCosts.size());
+	for (auto const& cost: particularCosts)
+		sortedCosts.push_back(make_pair(cost.first, cost.second.toGasConsumption()));
+	auto costAtLocation = [&](SourceLocation const& _location) -> GasConsumption
+	{
+		auto it = lower_bound(
+			sortedCosts.begin(),
+			sortedCosts.end(),
+			_location,
+			[](pair<SourceLocation, GasConsumption> const& _entry, SourceLocation const& _loc)
+			{
+				return _entry.first < _loc;
+			}
+		);
+		if (it != sortedCosts.end() && !(_location < it->first))
+			return it->second;
+		return GasConsumption();
+	};
 
 	set<ASTNode const*> finestNodes = finestNodesAtLocation(_ast);
 	ASTGasConsumptionSelfAccumulated gasCosts;
@@ -61,12 +322,15 @@ GasEstimator::ASTGasConsumptionSelfAccumulated GasEstimator::structuralEstimatio
 	{
 		if (!finestNodes.count(&_node))
 			return true;
-		gasCosts[&_node][0] = gasCosts[&_node][1] = particularCosts[_node.location()];
+		gasCosts[&_node][0] = gasCosts[&_node][1] = costAtLocation(_node.location());
 		return true;
 	};
 	auto onEdge = [&](ASTNode const& _parent, ASTNode const& _child)
 	{
-		gasCosts[&_parent][1] += gasCosts[&_child][1];
+		// Copy the child's cost first - references into the flat map are
+		// invalidated when inserting the parent's entry.
+		GasConsumption childCost = gasCosts[&_child][1];
+		gasCosts[&_parent][1] += childCost;
 	};
 	ASTReduce folder(onNode, onEdge);
 	for (ASTNode const* ast: _ast)
@@ -75,7 +339,7 @@ GasEstimator::ASTGasConsumptionSelfAccumulated GasEstimator::structuralEstimatio
 	return gasCosts;
 }
 
-map<ASTNode const*, GasMeter::GasConsumption> GasEstimator::breakToStatementLevel(
+GasEstimator::ASTGasConsumption GasEstimator::breakToStatementLevel(
 	ASTGasConsumptionSelfAccumulated const& _gasCosts,
 	vector<ASTNode const*> const& _roots
 )
@@ -83,7 +347,7 @@ map<ASTNode const*, GasMeter::GasConsumption> GasEstimator::breakToStatementLeve
 	solAssert(std::count(_roots.begin(), _roots.end(), nullptr) == 0, "");
 	// first pass: statementDepth[node] is the distance from the deepend statement to node
 	// in direction of the tree root (or undefined if not possible)
-	map<ASTNode const*, int> statementDepth;
+	ASTNodeMap<int> statementDepth;
 	auto onNodeFirstPass = [&](ASTNode const& _node)
 	{
 		if (dynamic_cast<Statement const*>(&_node))
@@ -93,7 +357,13 @@ map<ASTNode const*, GasMeter::GasConsumption> GasEstimator::breakToStatementLeve
 	auto onEdgeFirstPass = [&](ASTNode const& _parent, ASTNode const& _child)
 	{
 		if (statementDepth.count(&_child))
-			statementDepth[&_parent] = max(statementDepth[&_parent], statementDepth[&_child] + 1);
+		{
+			// Copy the child's depth first - references into the flat map are
+			// invalidated when inserting the parent's entry.
+			int childDepth = statementDepth.at(&_child);
+			int& parentDepth = statementDepth[&_parent];
+			parentDepth = max(parentDepth, childDepth + 1);
+		}
 	};
 	ASTReduce firstPass(onNodeFirstPass, onEdgeFirstPass);
 	for (ASTNode const* node: _roots)
@@ -102,7 +372,7 @@ map<ASTNode const*, GasMeter::GasConsumption> GasEstimator::breakToStatementLeve
 	// we use the location of a node if
 	//  - its statement depth is 0 or
 	//  - its statement depth is undefined but the parent's statement depth is at least 1
-	map<ASTNode const*, GasConsumption> gasCosts;
+	ASTGasConsumption gasCosts;
 	auto onNodeSecondPass = [&](ASTNode const& _node)
 	{
 		return statementDepth.count(&_node);
@@ -124,9 +394,10 @@ map<ASTNode const*, GasMeter::GasConsumption> GasEstimator::breakToStatementLeve
 	return gasCosts;
 }
 
-GasEstimator::GasConsumption GasEstimator::functionalEstimation(
+GasEstimator::FunctionalGasEstimation GasEstimator::boundedFunctionalEstimation(
 	AssemblyItems const& _items,
-	string const& _signature
+	string const& _signature,
+	size_t _pathBudget
 )
 {
 	auto state = make_shared<KnownState>();
@@ -144,21 +415,25 @@ GasEstimator::GasConsumption GasEstimator::functionalEstimation(
 		});
 	}
 
-	PathGasMeter meter(_items);
-	return meter.estimateMax(0, state);
+	return BoundedPathGasMeter(_items, _pathBudget).estimateMax(0, state);
 }
 
-GasEstimator::GasConsumption GasEstimator::functionalEstimation(
+GasEstimator::FunctionalGasEstimation GasEstimator::boundedFunctionalEstimation(
 	AssemblyItems const& _items,
 	size_t const& _offset,
-	FunctionDefinition const& _function
+	FunctionDefinition const& _function,
+	size_t _pathBudget
 )
 {
 	auto state = make_shared<KnownState>();
 
 	unsigned parametersSize = CompilerUtils::sizeOnStack(_function.parameters());
 	if (parametersSize > 16)
-		return GasConsumption::infinite();
+	{
+		FunctionalGasEstimation result;
+		result.gas = GasConsumption::infinite();
+		return result;
+	}
 
 	// Store an invalid return value on the stack, so that the path estimator breaks upon reaching
 	// the return jump.
@@ -167,7 +442,24 @@ GasEstimator::GasConsumption GasEstimator::functionalEstimation(
 	if (parametersSize > 0)
 		state->feedItem(eth::swapInstruction(parametersSize));
 
-	return PathGasMeter(_items).estimateMax(_offset, state);
+	return BoundedPathGasMeter(_items, _pathBudget).estimateMax(_offset, state);
+}
+
+GasEstimator::GasConsumption GasEstimator::functionalEstimation(
+	AssemblyItems const& _items,
+	string const& _signature
+)
+{
+	return boundedFunctionalEstimation(_items, _signature).gas;
+}
+
+GasEstimator::GasConsumption GasEstimator::functionalEstimation(
+	AssemblyItems const& _items,
+	size_t const& _offset,
+	FunctionDefinition const& _function
+)
+{
+	return boundedFunctionalEstimation(_items, _offset, _function).gas;
 }
 
 set<ASTNode const*> GasEstimator::finestNodesAtLocation(
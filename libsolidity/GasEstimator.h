@@ -26,6 +26,7 @@
 #include <map>
 #include <array>
 #include <libsolidity/ASTForward.h>
+#include <libsolidity/ASTNodeMap.h>
 #include <libevmasm/GasMeter.h>
 #include <libevmasm/Assembly.h>
 
@@ -38,9 +39,21 @@ struct GasEstimator
 {
 public:
 	using GasConsumption = eth::GasMeter::GasConsumption;
-	using ASTGasConsumption = std::map<ASTNode const*, GasConsumption>;
+	using ASTGasConsumption = ASTNodeMap<GasConsumption>;
 	using ASTGasConsumptionSelfAccumulated =
-		std::map<ASTNode const*, std::array<GasConsumption, 2>>;
+		ASTNodeMap<std::array<GasConsumption, 2>>;
+
+	/// Result of a functional estimation. If the path budget ran out before all execution
+	/// paths were metered, @a gas only bounds the worst case from below and @a isLowerBound
+	/// is set.
+	struct FunctionalGasEstimation
+	{
+		GasConsumption gas;
+		bool isLowerBound = false;
+	};
+
+	/// Maximum number of execution paths the functional estimator follows by default.
+	static size_t const c_defaultPathBudget = 10000;
 
 	/// Estimates the gas consumption for every assembly item in the given assembly and stores
 	/// it by source location.
@@ -60,14 +73,31 @@ public:
 
 	/// @returns the estimated gas consumption by the (public or external) function with the
 	/// given signature. If no signature is given, estimates the maximum gas usage.
-	static GasConsumption functionalEstimation(
+	/// Exploration stops after @a _pathBudget execution paths; the result is marked as a
+	/// lower bound if paths were left unexplored.
+	static FunctionalGasEstimation boundedFunctionalEstimation(
 		eth::AssemblyItems const& _items,
-		std::string const& _signature = ""
+		std::string const& _signature = "",
+		size_t _pathBudget = c_defaultPathBudget
 	);
 
 	/// @returns the estimated gas consumption by the given function which starts at the given
-	/// offset into the list of assembly items.
+	/// offset into the list of assembly items, subject to the given path budget.
 	/// @note this does not work correctly for recursive functions.
+	static FunctionalGasEstimation boundedFunctionalEstimation(
+		eth::AssemblyItems const& _items,
+		size_t const& _offset,
+		FunctionDefinition const& _function,
+		size_t _pathBudget = c_defaultPathBudget
+	);
+
+	/// Convenience wrapper around boundedFunctionalEstimation that only returns the gas value.
+	static GasConsumption functionalEstimation(
+		eth::AssemblyItems const& _items,
+		std::string const& _signature = ""
+	);
+
+	/// Convenience wrapper around boundedFunctionalEstimation that only returns the gas value.
 	static GasConsumption functionalEstimation(
 		eth::AssemblyItems const& _items,
 		size_t const& _offset,
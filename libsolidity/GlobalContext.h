@@ -54,7 +54,12 @@ public:
 	std::vector<Declaration const*> declarations() const;
 
 private:
-	std::vector<std::shared_ptr<MagicVariableDeclaration const>> m_magicVariables;
+	/// @returns the process-wide list of magic variable declarations, built on first
+	/// use. They are immutable after construction and shared by all compilations; only
+	/// the contract-dependent "this" and "super" declarations live per instance.
+	static std::vector<std::shared_ptr<MagicVariableDeclaration const>> const& magicVariables();
+
+	std::vector<std::shared_ptr<MagicVariableDeclaration const>> const& m_magicVariables;
 	ContractDefinition const* m_currentContract = nullptr;
 	std::map<ContractDefinition const*, std::shared_ptr<MagicVariableDeclaration const>> mutable m_thisPointer;
 	std::map<ContractDefinition const*, std::shared_ptr<MagicVariableDeclaration const>> mutable m_superPointer;
@@ -1,6 +1,7 @@
 
 #include <libsolidity/InterfaceHandler.h>
 #include <boost/range/irange.hpp>
+#include <libdevcore/SHA3.h>
 #include <libsolidity/AST.h>
 #include <libsolidity/CompilerStack.h>
 using namespace std;
@@ -32,6 +33,8 @@ string InterfaceHandler::documentation(
 		return abiInterface(_contractDef);
 	case DocumentationType::ABISolidityInterface:
 		return ABISolidityInterface(_contractDef);
+	case DocumentationType::ABIBinary:
+		return abiBinary(_contractDef);
 	}
 
 	BOOST_THROW_EXCEPTION(InternalCompilerError() << errinfo_comment("Unknown documentation type"));
@@ -107,6 +110,109 @@ string InterfaceHandler::abiInterface(ContractDefinition const& _contractDef)
 	return Json::FastWriter().write(abi);
 }
 
+string InterfaceHandler::abiBinary(ContractDefinition const& _contractDef)
+{
+	string out;
+
+	auto appendUint16 = [](string& _out, size_t _value)
+	{
+		solAssert(_value <= 0xffff, "Binary ABI field too large.");
+		_out.push_back(char(_value & 0xff));
+		_out.push_back(char((_value >> 8) & 0xff));
+	};
+	auto appendString = [&](string& _out, string const& _str)
+	{
+		appendUint16(_out, _str.size());
+		_out += _str;
+	};
+	auto appendParameters = [&](
+		string& _out,
+		vector<string> const& _paramNames,
+		vector<string> const& _paramTypes,
+		TypePointers const& _types
+	)
+	{
+		solAssert(
+			_paramNames.size() == _paramTypes.size() && _paramNames.size() == _types.size(),
+			"Names and types vector size does not match"
+		);
+		appendUint16(_out, _paramNames.size());
+		for (unsigned i = 0; i < _paramNames.size(); ++i)
+		{
+			_out.push_back(char(uint8_t(_types[i]->category())));
+			_out.push_back(char(0));
+			appendString(_out, _paramTypes[i]);
+			appendString(_out, _paramNames[i]);
+		}
+	};
+
+	out += "SABI";
+	out.push_back(char(1)); // format version
+	out.push_back(char(_contractDef.constructor() ? 1 : 0));
+
+	auto const& functions = _contractDef.interfaceFunctions();
+	appendUint16(out, functions.size());
+	for (auto const& it: functions)
+	{
+		auto externalFunctionType = it.second->interfaceFunctionType();
+		// the interface function map is already keyed by the 4 byte selector
+		out.append(reinterpret_cast<char const*>(it.first.data()), 4);
+		out.push_back(char(it.second->isConstant() ? 1 : 0));
+		appendString(out, it.second->declaration().name());
+		appendParameters(
+			out,
+			externalFunctionType->parameterNames(),
+			externalFunctionType->parameterTypeNames(_contractDef.isLibrary()),
+			externalFunctionType->parameterTypes()
+		);
+		appendParameters(
+			out,
+			externalFunctionType->returnParameterNames(),
+			externalFunctionType->returnParameterTypeNames(_contractDef.isLibrary()),
+			externalFunctionType->returnParameterTypes()
+		);
+	}
+
+	if (_contractDef.constructor())
+	{
+		auto externalFunction = FunctionType(*_contractDef.constructor()).interfaceFunctionType();
+		solAssert(!!externalFunction, "");
+		appendParameters(
+			out,
+			externalFunction->parameterNames(),
+			externalFunction->parameterTypeNames(_contractDef.isLibrary()),
+			externalFunction->parameterTypes()
+		);
+	}
+
+	auto const& events = _contractDef.interfaceEvents();
+	appendUint16(out, events.size());
+	for (auto const& it: events)
+	{
+		string signature = it->name() + "(";
+		auto const& parameters = it->parameters();
+		for (unsigned i = 0; i < parameters.size(); ++i)
+			signature +=
+				parameters[i]->annotation().type->canonicalName(false) +
+				(i + 1 == parameters.size() ? "" : ",");
+		signature += ")";
+		h256 topic = dev::sha3(signature);
+		out.append(reinterpret_cast<char const*>(topic.data()), 32);
+		out.push_back(char(it->isAnonymous() ? 1 : 0));
+		appendString(out, it->name());
+		appendUint16(out, parameters.size());
+		for (auto const& p: parameters)
+		{
+			out.push_back(char(uint8_t(p->annotation().type->category())));
+			out.push_back(char(p->isIndexed() ? 1 : 0));
+			appendString(out, p->annotation().type->canonicalName(false));
+			appendString(out, p->name());
+		}
+	}
+
+	return out;
+}
+
 string InterfaceHandler::ABISolidityInterface(ContractDefinition const& _contractDef)
 {
 	string ret = (_contractDef.isLibrary() ? "library " : "contract ") + _contractDef.name() + "{";
@@ -75,6 +75,18 @@ public:
 	/// @return             A string with the json representation of the contract's ABI Interface
 	std::string abiInterface(ContractDefinition const& _contractDef);
 	std::string ABISolidityInterface(ContractDefinition const& _contractDef);
+	/// Get a compact binary ABI descriptor of the contract that can be consumed
+	/// without JSON parsing. Layout (integers little-endian, strings prefixed by
+	/// a 16 bit length):
+	///   "SABI" | u8 version | u8 flags (bit 0: has constructor)
+	///   u16 function count, then per function:
+	///     4 byte selector | u8 flags (bit 0: constant) | name | inputs | outputs
+	///   constructor inputs (only if the constructor flag is set)
+	///   u16 event count, then per event:
+	///     32 byte topic hash | u8 flags (bit 0: anonymous) | name | inputs
+	/// A parameter list is a u16 count followed by entries of
+	///   u8 type code (Type::Category) | u8 flags (bit 0: indexed) | type name | name
+	std::string abiBinary(ContractDefinition const& _contractDef);
 	/// Get the User documentation of the contract
 	/// @param _contractDef The contract definition
 	/// @return             A string with the json representation of the contract's user documentation
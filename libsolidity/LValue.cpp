@@ -74,6 +74,28 @@ void StackVariable::setToZero(SourceLocation const& _location, bool) const
 	storeValue(*m_dataType, _location, true);
 }
 
+CalldataVariable::CalldataVariable(CompilerContext& _compilerContext, VariableDeclaration const& _declaration):
+	LValue(_compilerContext, _declaration.annotation().type.get()),
+	m_calldataOffset(m_context.calldataOffsetOfVariable(_declaration))
+{
+}
+
+void CalldataVariable::retrieveValue(SourceLocation const&, bool) const
+{
+	// The same padded load the eager calldata unpacker would have performed up front.
+	CompilerUtils(m_context).loadFromMemory(m_calldataOffset, *m_dataType->decodingType(), true, true);
+}
+
+void CalldataVariable::storeValue(Type const&, SourceLocation const&, bool) const
+{
+	solAssert(false, "Calldata variables cannot be written to.");
+}
+
+void CalldataVariable::setToZero(SourceLocation const&, bool) const
+{
+	solAssert(false, "Calldata variables cannot be written to.");
+}
+
 MemoryItem::MemoryItem(CompilerContext& _compilerContext, Type const& _type, bool _padded):
 	LValue(_compilerContext, &_type),
 	m_padded(_padded)
@@ -263,17 +285,13 @@ void StorageItem::storeValue(Type const& _sourceType, SourceLocation const& _loc
 				"Struct assignment with conversion."
 			);
 			solAssert(sourceType.location() != DataLocation::CallData, "Structs in calldata not supported.");
-			for (auto const& member: structType.members())
+			auto storeSingleMember = [&](string const& _name, TypePointer const& _memberType)
 			{
-				// assign each member that is not a mapping
-				TypePointer const& memberType = member.type;
-				if (memberType->category() == Type::Category::Mapping)
-					continue;
-				TypePointer sourceMemberType = sourceType.memberType(member.name);
+				TypePointer sourceMemberType = sourceType.memberType(_name);
 				if (sourceType.location() == DataLocation::Storage)
 				{
 					// stack layout: source_ref target_ref
-					pair<u256, unsigned> const& offsets = sourceType.storageOffsetsOfMember(member.name);
+					pair<u256, unsigned> const& offsets = sourceType.storageOffsetsOfMember(_name);
 					m_context << offsets.first << eth::Instruction::DUP3 << eth::Instruction::ADD;
 					m_context << u256(offsets.second);
 					// stack: source_ref target_ref source_member_ref source_member_off
@@ -284,19 +302,87 @@ void StorageItem::storeValue(Type const& _sourceType, SourceLocation const& _loc
 				{
 					solAssert(sourceType.location() == DataLocation::Memory, "");
 					// stack layout: source_ref target_ref
-					TypePointer sourceMemberType = sourceType.memberType(member.name);
-					m_context << sourceType.memoryOffsetOfMember(member.name);
+					m_context << sourceType.memoryOffsetOfMember(_name);
 					m_context << eth::Instruction::DUP3 << eth::Instruction::ADD;
 					MemoryItem(m_context, *sourceMemberType).retrieveValue(_location, true);
 					// stack layout: source_ref target_ref source_value...
 				}
 				unsigned stackSize = sourceMemberType->sizeOnStack();
-				pair<u256, unsigned> const& offsets = structType.storageOffsetsOfMember(member.name);
+				pair<u256, unsigned> const& offsets = structType.storageOffsetsOfMember(_name);
 				m_context << eth::dupInstruction(1 + stackSize) << offsets.first << eth::Instruction::ADD;
 				m_context << u256(offsets.second);
 				// stack: source_ref target_ref target_off source_value... target_member_ref target_member_byte_off
-				StorageItem(m_context, *memberType).storeValue(*sourceMemberType, _location, true);
+				StorageItem(m_context, *_memberType).storeValue(*sourceMemberType, _location, true);
+			};
+			// Members packed into the same target slot are combined into a single
+			// read-modify-write so that each slot is written by one SSTORE only.
+			map<u256, vector<pair<string, TypePointer>>> packedMembers;
+			for (auto const& member: structType.members())
+			{
+				// assign each member that is not a mapping
+				TypePointer const& memberType = member.type;
+				if (memberType->category() == Type::Category::Mapping)
+					continue;
+				if (memberType->isValueType() && memberType->storageBytes() < 32)
+					packedMembers[structType.storageOffsetsOfMember(member.name).first].push_back(
+						make_pair(member.name, memberType)
+					);
+				else
+					storeSingleMember(member.name, memberType);
 			}
+			for (auto const& slot: packedMembers)
+				if (slot.second.size() == 1)
+					storeSingleMember(slot.second.front().first, slot.second.front().second);
+				else
+				{
+					// The slot holds only the members collected here (32-byte members and
+					// reference types occupy whole slots of their own), so the new slot
+					// content can be assembled from scratch without loading the old value.
+					// stack: source_ref target_ref
+					m_context << eth::Instruction::DUP1 << slot.first << eth::Instruction::ADD;
+					m_context << u256(0);
+					// stack: source_ref target_ref target_slot_ref new_word
+					for (auto const& member: slot.second)
+					{
+						TypePointer const& memberType = member.second;
+						TypePointer sourceMemberType = sourceType.memberType(member.first);
+						if (sourceType.location() == DataLocation::Storage)
+						{
+							pair<u256, unsigned> const& offsets = sourceType.storageOffsetsOfMember(member.first);
+							m_context << offsets.first << eth::dupInstruction(5) << eth::Instruction::ADD;
+							m_context << u256(offsets.second);
+							StorageItem(m_context, *sourceMemberType).retrieveValue(_location, true);
+						}
+						else
+						{
+							m_context << sourceType.memoryOffsetOfMember(member.first);
+							m_context << eth::dupInstruction(5) << eth::Instruction::ADD;
+							MemoryItem(m_context, *sourceMemberType).retrieveValue(_location, true);
+						}
+						// stack: source_ref target_ref target_slot_ref new_word value
+						solAssert(sourceMemberType->sizeOnStack() == 1, "");
+						if (memberType->category() == Type::Category::FixedBytes)
+							// move from the high-order end to the low-order end
+							m_context
+								<< (u256(1) << (256 - 8 * dynamic_cast<FixedBytesType const&>(*memberType).numBytes()))
+								<< eth::Instruction::SWAP1 << eth::Instruction::DIV;
+						else if (
+							memberType->category() == Type::Category::Integer &&
+							dynamic_cast<IntegerType const&>(*memberType).isSigned()
+						)
+							// remove the higher order bits of the sign extension
+							m_context
+								<< ((u256(1) << (8 * memberType->storageBytes())) - 1)
+								<< eth::Instruction::AND;
+						unsigned byteOffset = structType.storageOffsetsOfMember(member.first).second;
+						if (byteOffset > 0)
+							m_context << (u256(1) << (8 * byteOffset)) << eth::Instruction::MUL;
+						m_context << eth::Instruction::OR;
+						// stack: source_ref target_ref target_slot_ref new_word'
+					}
+					m_context << eth::Instruction::SWAP1 << eth::Instruction::SSTORE;
+					// stack: source_ref target_ref
+				}
 			// stack layout: source_ref target_ref
 			solAssert(sourceType.sizeOnStack() == 1, "Unexpected source size.");
 			if (_move)
@@ -326,6 +412,10 @@ void StorageItem::setToZero(SourceLocation const&, bool _removeReference) const
 		// @todo this can be improved: use StorageItem for non-value types, and just store 0 in
 		// all slots that contain value types later.
 		auto const& structType = dynamic_cast<StructType const&>(*m_dataType);
+		// Slots shared by several packed members are zeroed as a whole with a single
+		// SSTORE instead of one read-modify-write per member. Such a slot only holds
+		// the packed members (and padding), so no other data can be overwritten.
+		set<u256> zeroedSlots;
 		for (auto const& member: structType.members())
 		{
 			// zero each member that is not a mapping
@@ -333,6 +423,15 @@ void StorageItem::setToZero(SourceLocation const&, bool _removeReference) const
 			if (memberType->category() == Type::Category::Mapping)
 				continue;
 			pair<u256, unsigned> const& offsets = structType.storageOffsetsOfMember(member.name);
+			if (memberType->isValueType() && memberType->storageBytes() < 32)
+			{
+				if (zeroedSlots.insert(offsets.first).second)
+					// stack: storage_key storage_offset
+					m_context
+						<< offsets.first << eth::Instruction::DUP3 << eth::Instruction::ADD
+						<< u256(0) << eth::Instruction::SWAP1 << eth::Instruction::SSTORE;
+				continue;
+			}
 			m_context
 				<< offsets.first << eth::Instruction::DUP3 << eth::Instruction::ADD
 				<< u256(offsets.second);
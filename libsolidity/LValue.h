@@ -100,6 +100,33 @@ private:
 	unsigned m_size;
 };
 
+/**
+ * Function argument that stays in calldata and is loaded at its use sites. Read-only by
+ * construction: the compiler only chooses this representation for parameters that are
+ * never assigned to (see CompilerContext::markLazyCalldataFunction).
+ */
+class CalldataVariable: public LValue
+{
+public:
+	CalldataVariable(CompilerContext& _compilerContext, VariableDeclaration const& _declaration);
+
+	virtual unsigned sizeOnStack() const override { return 0; }
+	virtual void retrieveValue(SourceLocation const& _location, bool _remove = false) const override;
+	virtual void storeValue(
+		Type const& _sourceType,
+		SourceLocation const& _location = SourceLocation(),
+		bool _move = false
+	) const override;
+	virtual void setToZero(
+		SourceLocation const& _location = SourceLocation(),
+		bool _removeReference = true
+	) const override;
+
+private:
+	/// Offset of the (word-padded) value inside the calldata.
+	unsigned m_calldataOffset;
+};
+
 /**
  * Reference to some item in memory.
  */
@@ -214,8 +214,8 @@ void NameAndTypeResolver::importInheritedScope(ContractDefinition const& _base)
 {
 	auto iterator = m_scopes.find(&_base);
 	solAssert(iterator != end(m_scopes), "");
-	for (auto const& nameAndDeclaration: iterator->second.declarations())
-		for (auto const& declaration: nameAndDeclaration.second)
+	for (auto const& entry: iterator->second.declarations())
+		for (auto const& declaration: entry.declarations)
 			// Import if it was declared in the base, is not the constructor and is visible in derived classes
 			if (declaration->scope() == &_base && declaration->isVisibleInDerivedContracts())
 				m_currentScope->registerDeclaration(*declaration);
@@ -24,6 +24,8 @@
 #include <libdevcore/Log.h>
 #include <libevmasm/SourceLocation.h>
 #include <libsolidity/Parser.h>
+#include <libsolidity/ASTArena.h>
+#include <libsolidity/ASTStringPool.h>
 #include <libsolidity/Scanner.h>
 #include <libsolidity/Exceptions.h>
 #include <libsolidity/InterfaceHandler.h>
@@ -41,27 +43,42 @@ class Parser::ASTNodeFactory
 {
 public:
 	ASTNodeFactory(Parser const& _parser):
-		m_parser(_parser), m_location(_parser.position(), -1, _parser.sourceName()) {}
+		m_parser(_parser), m_start(_parser.position()), m_end(-1) {}
 	ASTNodeFactory(Parser const& _parser, ASTPointer<ASTNode> const& _childNode):
-		m_parser(_parser), m_location(_childNode->location()) {}
+		m_parser(_parser), m_start(_childNode->location().start), m_end(_childNode->location().end) {}
 
-	void markEndPosition() { m_location.end = m_parser.endPosition(); }
-	void setLocation(SourceLocation const& _location) { m_location = _location; }
-	void setLocationEmpty() { m_location.end = m_location.start; }
+	void markEndPosition() { m_end = m_parser.endPosition(); }
+	void setLocation(SourceLocation const& _location) { m_start = _location.start; m_end = _location.end; }
+	void setLocationEmpty() { m_end = m_start; }
 	/// Set the end position to the one of the given node.
-	void setEndPositionFromNode(ASTPointer<ASTNode> const& _node) { m_location.end = _node->location().end; }
+	void setEndPositionFromNode(ASTPointer<ASTNode> const& _node) { m_end = _node->location().end; }
 
 	template <class NodeType, typename... Args>
 	ASTPointer<NodeType> createNode(Args&& ... _args)
 	{
-		if (m_location.end < 0)
+		if (m_end < 0)
 			markEndPosition();
-		return make_shared<NodeType>(m_location, forward<Args>(_args)...);
+		// Nodes are bump-allocated into the parser's arena; the control block
+		// of each node keeps the arena alive. The source location (and with
+		// it the source name's reference count) is only materialized here -
+		// position tracking while parsing is plain integer stores.
+		ASTPointer<NodeType> node = allocate_shared<NodeType>(
+			ASTArenaAllocator<NodeType>(m_parser.m_arena),
+			SourceLocation(m_start, m_end, m_parser.sourceName()),
+			forward<Args>(_args)...
+		);
+		// Annotations created later (by the analysis passes) go into the same
+		// arena as the node itself.
+		node->setAnnotationArena(m_parser.m_arena.get());
+		return node;
 	}
 
 private:
 	Parser const& m_parser;
-	SourceLocation m_location;
+	/// Start and end position of the node; the end position can stay -1 until
+	/// createNode, which then takes the parser's end position.
+	int m_start;
+	int m_end;
 };
 
 ASTPointer<SourceUnit> Parser::parse(shared_ptr<Scanner> const& _scanner)
@@ -69,6 +86,7 @@ ASTPointer<SourceUnit> Parser::parse(shared_ptr<Scanner> const& _scanner)
 	try
 	{
 		m_scanner = _scanner;
+		m_arena = make_shared<ASTArena>();
 		ASTNodeFactory nodeFactory(*this);
 		vector<ASTPointer<ASTNode>> nodes;
 		while (m_scanner->currentToken() != Token::EOS)
@@ -86,7 +104,9 @@ ASTPointer<SourceUnit> Parser::parse(shared_ptr<Scanner> const& _scanner)
 				fatalParserError(std::string("Expected import directive or contract definition."));
 			}
 		}
-		return nodeFactory.createNode<SourceUnit>(nodes);
+		ASTPointer<SourceUnit> sourceUnit = nodeFactory.createNode<SourceUnit>(nodes);
+		sourceUnit->setArena(m_arena);
+		return sourceUnit;
 	}
 	catch (FatalError const& _error)
 	{
@@ -236,7 +256,7 @@ ASTPointer<FunctionDefinition> Parser::parseFunctionDefinition(ASTString const*
 	expectToken(Token::Function);
 	ASTPointer<ASTString> name;
 	if (m_scanner->currentToken() == Token::LParen)
-		name = make_shared<ASTString>(); // anonymous function
+		name = ASTStringPool::global().intern(""); // anonymous function
 	else
 		name = expectIdentifierToken();
 	VarDeclParserOptions options;
@@ -277,8 +297,14 @@ ASTPointer<FunctionDefinition> Parser::parseFunctionDefinition(ASTString const*
 	nodeFactory.markEndPosition();
 	if (m_scanner->currentToken() != Token::Semicolon)
 	{
-		block = parseBlock();
-		nodeFactory.setEndPositionFromNode(block);
+		if (m_skipFunctionBodies)
+			// Leave the body empty as if the function were unimplemented.
+			skipFunctionBody();
+		else
+		{
+			block = parseBlock();
+			nodeFactory.setEndPositionFromNode(block);
+		}
 	}
 	else
 		m_scanner->next(); // just consume the ';'
@@ -401,7 +427,7 @@ ASTPointer<VariableDeclaration> Parser::parseVariableDeclaration(
 
 	if (_options.allowEmptyName && m_scanner->currentToken() != Token::Identifier)
 	{
-		identifier = make_shared<ASTString>("");
+		identifier = ASTStringPool::global().intern("");
 		solAssert(type != nullptr, "");
 		nodeFactory.setEndPositionFromNode(type);
 	}
@@ -989,25 +1015,32 @@ ASTPointer<Expression> Parser::parsePrimaryExpression()
 		expression = nodeFactory.createNode<Literal>(token, getLiteralAndAdvance());
 		break;
 	case Token::Number:
-		if (Token::isEtherSubdenomination(m_scanner->peekNextToken()))
+	{
+		// Capture the value the scanner attached to the token before advancing.
+		bool const valueKnown = m_scanner->currentNumberValueKnown();
+		u256 const value = m_scanner->currentNumberValue();
+		ASTPointer<Literal> literalNode;
+		if (
+			Token::isEtherSubdenomination(m_scanner->peekNextToken()) ||
+			Token::isTimeSubdenomination(m_scanner->peekNextToken())
+		)
 		{
 			ASTPointer<ASTString> literal = getLiteralAndAdvance();
 			nodeFactory.markEndPosition();
 			Literal::SubDenomination subdenomination = static_cast<Literal::SubDenomination>(m_scanner->currentToken());
 			m_scanner->next();
-			expression = nodeFactory.createNode<Literal>(token, literal, subdenomination);
-			break;
+			literalNode = nodeFactory.createNode<Literal>(token, literal, subdenomination);
 		}
-		if (Token::isTimeSubdenomination(m_scanner->peekNextToken()))
+		else
 		{
-			ASTPointer<ASTString> literal = getLiteralAndAdvance();
 			nodeFactory.markEndPosition();
-			Literal::SubDenomination subdenomination = static_cast<Literal::SubDenomination>(m_scanner->currentToken());
-			m_scanner->next();
-			expression = nodeFactory.createNode<Literal>(token, literal, subdenomination);
-			break;
+			literalNode = nodeFactory.createNode<Literal>(token, getLiteralAndAdvance());
 		}
-		// fall-through
+		if (valueKnown)
+			literalNode->setScannedValue(value);
+		expression = literalNode;
+		break;
+	}
 	case Token::StringLiteral:
 		nodeFactory.markEndPosition();
 		expression = nodeFactory.createNode<Literal>(token, getLiteralAndAdvance());
@@ -1166,7 +1199,7 @@ ASTPointer<Expression> Parser::expressionFromIndexAccessStructure(
 		Identifier const& identifier = dynamic_cast<Identifier const&>(*_path[i]);
 		expression = nodeFactory.createNode<MemberAccess>(
 			expression,
-			make_shared<ASTString>(identifier.name())
+			ASTStringPool::global().intern(identifier.name())
 		);
 	}
 	for (auto const& index: _indices)
@@ -1177,10 +1210,30 @@ ASTPointer<Expression> Parser::expressionFromIndexAccessStructure(
 	return expression;
 }
 
+void Parser::skipFunctionBody()
+{
+	expectToken(Token::LBrace);
+	int depth = 1;
+	while (depth > 0)
+	{
+		Token::Value token = m_scanner->currentToken();
+		if (token == Token::EOS)
+			fatalParserError(std::string("Function body not closed at end of source."));
+		else if (token == Token::LBrace)
+			++depth;
+		else if (token == Token::RBrace)
+			--depth;
+		m_scanner->next();
+	}
+}
+
 void Parser::expectToken(Token::Value _value)
 {
 	if (m_scanner->currentToken() != _value)
-		fatalParserError(std::string(string("Expected token ") + string(Token::name(_value))));
+		fatalParserError([_value]() -> string
+		{
+			return string("Expected token ") + Token::name(_value);
+		});
 	m_scanner->next();
 }
 
@@ -1202,7 +1255,9 @@ ASTPointer<ASTString> Parser::expectIdentifierToken()
 
 ASTPointer<ASTString> Parser::getLiteralAndAdvance()
 {
-	ASTPointer<ASTString> identifier = make_shared<ASTString>(m_scanner->currentLiteral());
+	// Identifiers and short literals are interned so repeated names share one
+	// string object across the whole AST.
+	ASTPointer<ASTString> identifier = ASTStringPool::global().intern(m_scanner->currentLiteral());
 	m_scanner->next();
 	return identifier;
 }
@@ -1217,11 +1272,25 @@ ASTPointer<ParameterList> Parser::createEmptyParameterList()
 void Parser::parserError(string const& _description)
 {
 	auto err = make_shared<Error>(Error::Type::ParserError);
-	*err <<
-		errinfo_sourceLocation(SourceLocation(position(), position(), sourceName())) <<
-		errinfo_comment(_description);
+	*err << errinfo_sourceLocation(SourceLocation(position(), position(), sourceName()));
+	err->setDescription(_description);
+
+	m_errors.push_back(err);
+	if (m_errorSink && !m_errorSink(*err))
+		// The sink requested cancellation; abort like a fatal error.
+		BOOST_THROW_EXCEPTION(FatalError());
+}
+
+void Parser::parserError(Error::DescriptionFormatter _formatter)
+{
+	auto err = make_shared<Error>(Error::Type::ParserError);
+	*err << errinfo_sourceLocation(SourceLocation(position(), position(), sourceName()));
+	err->setDescriptionFormatter(std::move(_formatter));
 
 	m_errors.push_back(err);
+	if (m_errorSink && !m_errorSink(*err))
+		// The sink requested cancellation; abort like a fatal error.
+		BOOST_THROW_EXCEPTION(FatalError());
 }
 
 void Parser::fatalParserError(string const& _description)
@@ -1230,5 +1299,11 @@ void Parser::fatalParserError(string const& _description)
 	BOOST_THROW_EXCEPTION(FatalError());
 }
 
+void Parser::fatalParserError(Error::DescriptionFormatter _formatter)
+{
+	parserError(std::move(_formatter));
+	BOOST_THROW_EXCEPTION(FatalError());
+}
+
 }
 }
@@ -30,11 +30,19 @@ namespace solidity
 {
 
 class Scanner;
+class ASTArena;
 
 class Parser
 {
 public:
-	Parser(ErrorList& errors): m_errors(errors){};
+	/// If @a _skipFunctionBodies is true, function bodies are lexed over by brace
+	/// matching without building statement ASTs. The resulting SourceUnit is
+	/// sufficient for import resolution and interface extraction, but not for
+	/// type checking or compilation.
+	/// If @a _errorSink is set, it is called for every recorded error; a false
+	/// return aborts the parse like a fatal error.
+	Parser(ErrorList& errors, bool _skipFunctionBodies = false, ErrorSink _errorSink = ErrorSink()):
+		m_skipFunctionBodies(_skipFunctionBodies), m_errors(errors), m_errorSink(std::move(_errorSink)) {};
 
 	ASTPointer<SourceUnit> parse(std::shared_ptr<Scanner> const& _scanner);
 	std::shared_ptr<std::string const> const& sourceName() const;
@@ -135,6 +143,11 @@ private:
 		std::vector<ASTPointer<PrimaryExpression>> const& _path,
 		std::vector<std::pair<ASTPointer<Expression>, SourceLocation>> const& _indices
 	);
+	/// Lexes over a function body by brace matching without building an AST
+	/// (used in signature-only mode). Expects the current token to be the
+	/// opening brace and consumes everything up to and including the matching
+	/// closing brace.
+	void skipFunctionBody();
 	/// If current token value is not _value, throw exception otherwise advance token.
 	void expectToken(Token::Value _value);
 	Token::Value expectAssignmentOperator();
@@ -148,16 +161,26 @@ private:
 	/// Creates a @ref ParserError and annotates it with the current position and the
 	/// given @a _description.
 	void parserError(std::string const& _description);
+	/// Creates a @ref ParserError whose description is built by @a _formatter only
+	/// when the error is actually rendered.
+	void parserError(Error::DescriptionFormatter _formatter);
 
 	/// Creates a @ref ParserError and annotates it with the current position and the
 	/// given @a _description. Throws the FatalError.
 	void fatalParserError(std::string const& _description);
+	void fatalParserError(Error::DescriptionFormatter _formatter);
 
 	std::shared_ptr<Scanner> m_scanner;
+	/// Arena the nodes of the currently parsed source unit are allocated in.
+	std::shared_ptr<ASTArena> m_arena;
 	/// Flag that signifies whether '_' is parsed as a PlaceholderStatement or a regular identifier.
 	bool m_insideModifier = false;
+	/// Whether function bodies are skipped instead of parsed, see the constructor.
+	bool m_skipFunctionBodies = false;
 	/// The reference to the list of errors and warning to add errors/warnings during parsing
 	ErrorList& m_errors;
+	/// Optional callback notified of every recorded error, see the constructor.
+	ErrorSink m_errorSink;
 };
 
 }
@@ -43,7 +43,7 @@ ReferencesResolver::ReferencesResolver(
 	m_returnParameters(_returnParameters),
 	m_resolveInsideCode(_resolveInsideCode)
 {
-	_root.accept(*this);
+	walk(_root);
 }
 
 bool ReferencesResolver::visit(Return const& _return)
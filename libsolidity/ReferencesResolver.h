@@ -25,7 +25,7 @@
 #include <map>
 #include <list>
 #include <boost/noncopyable.hpp>
-#include <libsolidity/ASTVisitor.h>
+#include <libsolidity/ASTStaticVisitor.h>
 #include <libsolidity/ASTAnnotations.h>
 
 namespace dev
@@ -39,7 +39,7 @@ class NameAndTypeResolver;
  * Resolves references to declarations (of variables and types) and also establishes the link
  * between a return statement and the return parameter list.
  */
-class ReferencesResolver: private ASTConstVisitor
+class ReferencesResolver: private ASTStaticVisitor<ReferencesResolver>
 {
 public:
 	ReferencesResolver(
@@ -51,11 +51,15 @@ public:
 	);
 
 private:
-	virtual bool visit(Block const&) override { return m_resolveInsideCode; }
-	virtual bool visit(Identifier const& _identifier) override;
-	virtual bool visit(UserDefinedTypeName const& _typeName) override;
-	virtual bool visit(Return const& _return) override;
-	virtual void endVisit(VariableDeclaration const& _variable) override;
+	friend class ASTStaticVisitor<ReferencesResolver>;
+	using ASTStaticVisitor<ReferencesResolver>::visit;
+	using ASTStaticVisitor<ReferencesResolver>::endVisit;
+
+	bool visit(Block const&) { return m_resolveInsideCode; }
+	bool visit(Identifier const& _identifier);
+	bool visit(UserDefinedTypeName const& _typeName);
+	bool visit(Return const& _return);
+	void endVisit(VariableDeclaration const& _variable);
 
 	TypePointer typeFor(TypeName const& _typeName);
 
@@ -51,9 +51,16 @@
  */
 
 #include <algorithm>
+#include <cstring>
 #include <tuple>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #include <libsolidity/Utils.h>
 #include <libsolidity/Scanner.h>
+#include <libsolidity/ASTStringPool.h>
 
 using namespace std;
 
@@ -101,6 +108,152 @@ int hexValue(char c)
 		return c - 'A' + 10;
 	else return -1;
 }
+
+///@{
+///@name Vectorized character classification
+/// These helpers classify whole blocks of source text per iteration so that
+/// whitespace runs and identifier tails are skipped at close to memory
+/// bandwidth. They fall back to the byte-at-a-time loop on compilers or
+/// targets without SSE2/AVX2 and for the unaligned tail of the input.
+/// Note that all comparisons are signed, so bytes >= 0x80 never classify as
+/// whitespace or identifier characters, matching the scalar predicates.
+
+/// @returns the position of the first character at or after _position that is
+/// not whitespace, or _size if the run extends to the end of the input.
+size_t endOfWhitespaceRun(char const* _data, size_t _position, size_t _size)
+{
+#if defined(__AVX2__)
+	while (_position + 32 <= _size)
+	{
+		__m256i chunk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(_data + _position));
+		__m256i match = _mm256_or_si256(
+			_mm256_or_si256(
+				_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')),
+				_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'))),
+			_mm256_or_si256(
+				_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t')),
+				_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\r'))));
+		unsigned mask = unsigned(_mm256_movemask_epi8(match));
+		if (mask != 0xffffffffu)
+			return _position + __builtin_ctz(~mask);
+		_position += 32;
+	}
+#elif defined(__SSE2__)
+	while (_position + 16 <= _size)
+	{
+		__m128i chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_data + _position));
+		__m128i match = _mm_or_si128(
+			_mm_or_si128(
+				_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')),
+				_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'))),
+			_mm_or_si128(
+				_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t')),
+				_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))));
+		unsigned mask = unsigned(_mm_movemask_epi8(match));
+		if (mask != 0xffffu)
+			return _position + __builtin_ctz(~mask & 0xffffu);
+		_position += 16;
+	}
+#endif
+	while (_position < _size && isWhiteSpace(_data[_position]))
+		_position++;
+	return _position;
+}
+
+/// @returns the position of the first character at or after _position that
+/// cannot be part of an identifier, or _size if the identifier extends to the
+/// end of the input.
+size_t endOfIdentifierRun(char const* _data, size_t _position, size_t _size)
+{
+#if defined(__AVX2__)
+	while (_position + 32 <= _size)
+	{
+		__m256i chunk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(_data + _position));
+		__m256i lower = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+		__m256i alpha = _mm256_and_si256(
+			_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+			_mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+		__m256i digit = _mm256_and_si256(
+			_mm256_cmpgt_epi8(chunk, _mm256_set1_epi8('0' - 1)),
+			_mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), chunk));
+		__m256i other = _mm256_or_si256(
+			_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('_')),
+			_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('$')));
+		unsigned mask = unsigned(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(alpha, digit), other)));
+		if (mask != 0xffffffffu)
+			return _position + __builtin_ctz(~mask);
+		_position += 32;
+	}
+#elif defined(__SSE2__)
+	while (_position + 16 <= _size)
+	{
+		__m128i chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_data + _position));
+		__m128i lower = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+		__m128i alpha = _mm_and_si128(
+			_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+			_mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), lower));
+		__m128i digit = _mm_and_si128(
+			_mm_cmpgt_epi8(chunk, _mm_set1_epi8('0' - 1)),
+			_mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), chunk));
+		__m128i other = _mm_or_si128(
+			_mm_cmpeq_epi8(chunk, _mm_set1_epi8('_')),
+			_mm_cmpeq_epi8(chunk, _mm_set1_epi8('$')));
+		unsigned mask = unsigned(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(alpha, digit), other)));
+		if (mask != 0xffffu)
+			return _position + __builtin_ctz(~mask & 0xffffu);
+		_position += 16;
+	}
+#endif
+	while (_position < _size && isIdentifierPart(_data[_position]))
+		_position++;
+	return _position;
+}
+///@}
+
+/// Converts a scanned decimal or hexadecimal number literal directly into a
+/// 256-bit value, accumulating in a native 64-bit word for as long as the
+/// value fits. @returns false for literals that need the string-based
+/// conversion downstream (fractional parts, exponents or values exceeding
+/// 256 bits).
+bool parseNumberValue(string const& _literal, u256& o_value)
+{
+	size_t i = 0;
+	unsigned base = 10;
+	if (_literal.size() >= 2 && _literal[0] == '0' && (_literal[1] == 'x' || _literal[1] == 'X'))
+	{
+		base = 16;
+		i = 2;
+	}
+	if (i == _literal.size())
+		return false;
+	if (_literal.size() - i <= (base == 16 ? size_t(15) : size_t(19)))
+	{
+		// Fast path: the value is guaranteed to fit into 64 bits.
+		uint64_t small = 0;
+		for (; i < _literal.size(); ++i)
+		{
+			int d = hexValue(_literal[i]);
+			if (d < 0 || unsigned(d) >= base)
+				return false;
+			small = small * base + d;
+		}
+		o_value = small;
+		return true;
+	}
+	u256 value = 0;
+	for (; i < _literal.size(); ++i)
+	{
+		int d = hexValue(_literal[i]);
+		if (d < 0 || unsigned(d) >= base)
+			return false;
+		if (value > (u256(-1) - d) / base)
+			return false; // exceeds 256 bits, leave it to the bigint path
+		value = value * base + d;
+	}
+	o_value = value;
+	return true;
+}
+
 } // end anonymous namespace
 
 
@@ -147,7 +300,9 @@ private:
 void Scanner::reset(CharStream const& _source, string const& _sourceName)
 {
 	m_source = _source;
-	m_sourceName = make_shared<string const>(_sourceName);
+	// Source names repeat across scanners (re-compilations, imports of the
+	// same file), so share one interned copy instead of allocating per reset.
+	m_sourceName = ASTStringPool::global().intern(_sourceName);
 	reset();
 }
 
@@ -155,11 +310,104 @@ void Scanner::reset()
 {
 	m_source.reset();
 	m_char = m_source.get();
-	skipWhitespace();
-	scanToken();
+	if (m_tokenizeUpFront)
+	{
+		tokenizeAll();
+		m_nextTokenIndex = 0;
+		materializeBufferedToken();
+	}
+	else
+	{
+		skipWhitespace();
+		scanToken();
+	}
 	next();
 }
 
+void Scanner::tokenizeAll()
+{
+	m_tokenBuffer.clear();
+	m_commentBuffer.clear();
+	m_numberValueBuffer.clear();
+	m_literalPool.clear();
+	m_tokenBuffer.reserve(m_source.size() / 8 + 1);
+	m_literalPool.reserve(m_source.size() / 8 + 1);
+	skipWhitespace();
+	do
+	{
+		scanToken();
+		CompactToken record;
+		record.token = m_nextToken.token;
+		record.start = m_nextToken.location.start;
+		record.end = m_nextToken.location.end;
+		record.literalOffset = unsigned(m_literalPool.size());
+		record.literalLength = unsigned(m_nextToken.literal.size());
+		m_literalPool += m_nextToken.literal;
+		record.commentIndex = 0;
+		if (!m_nextSkippedComment.literal.empty())
+		{
+			CompactComment comment;
+			comment.token = m_nextSkippedComment.token;
+			comment.start = m_nextSkippedComment.location.start;
+			comment.end = m_nextSkippedComment.location.end;
+			comment.literalOffset = unsigned(m_literalPool.size());
+			comment.literalLength = unsigned(m_nextSkippedComment.literal.size());
+			m_literalPool += m_nextSkippedComment.literal;
+			m_commentBuffer.push_back(comment);
+			record.commentIndex = unsigned(m_commentBuffer.size());
+		}
+		record.numberValueIndex = 0;
+		if (m_nextToken.numberValueKnown)
+		{
+			m_numberValueBuffer.push_back(m_nextToken.numberValue);
+			record.numberValueIndex = unsigned(m_numberValueBuffer.size());
+		}
+		m_tokenBuffer.push_back(record);
+	}
+	while (m_tokenBuffer.back().token != Token::EOS);
+}
+
+void Scanner::materializeBufferedToken()
+{
+	solAssert(m_nextTokenIndex < m_tokenBuffer.size(), "");
+	CompactToken const& record = m_tokenBuffer[m_nextTokenIndex];
+	m_nextToken.token = record.token;
+	m_nextToken.location.start = record.start;
+	m_nextToken.location.end = record.end;
+	m_nextToken.literal.assign(m_literalPool, record.literalOffset, record.literalLength);
+	m_nextToken.numberValueKnown = record.numberValueIndex != 0;
+	if (record.numberValueIndex)
+		m_nextToken.numberValue = m_numberValueBuffer[record.numberValueIndex - 1];
+	m_nextSkippedComment.literal.clear();
+	if (record.commentIndex)
+	{
+		CompactComment const& comment = m_commentBuffer[record.commentIndex - 1];
+		m_nextSkippedComment.token = comment.token;
+		m_nextSkippedComment.location.start = comment.start;
+		m_nextSkippedComment.location.end = comment.end;
+		m_nextSkippedComment.literal.assign(m_literalPool, comment.literalOffset, comment.literalLength);
+	}
+}
+
+void Scanner::loadBufferedToken()
+{
+	// Stay on the last record (EOS) once it is reached.
+	if (m_nextTokenIndex + 1 < m_tokenBuffer.size())
+		m_nextTokenIndex++;
+	materializeBufferedToken();
+}
+
+Token::Value Scanner::peekToken(size_t _ahead) const
+{
+	if (_ahead == 0)
+		return m_currentToken.token;
+	if (_ahead == 1)
+		return m_nextToken.token;
+	solAssert(m_tokenizeUpFront, "Arbitrary lookahead requires pre-tokenized mode.");
+	size_t index = min(m_nextTokenIndex + _ahead - 1, m_tokenBuffer.size() - 1);
+	return m_tokenBuffer[index].token;
+}
+
 bool Scanner::scanHexByte(char& o_scannedByte)
 {
 	char x = 0;
@@ -184,9 +432,16 @@ BOOST_STATIC_ASSERT(Token::NUM_TOKENS <= 0x100);
 
 Token::Value Scanner::next()
 {
-	m_currentToken = m_nextToken;
-	m_skippedComment = m_nextSkippedComment;
-	scanToken();
+	// Swap instead of copying so the literal strings exchange their heap
+	// buffers; scanToken() and materializeBufferedToken() overwrite all fields
+	// of the look-ahead descriptors anyway. Together with clear() retaining
+	// capacity this makes steady-state lexing allocation-free per token.
+	swap(m_currentToken, m_nextToken);
+	swap(m_skippedComment, m_nextSkippedComment);
+	if (m_tokenizeUpFront)
+		loadBufferedToken();
+	else
+		scanToken();
 
 	return m_currentToken.token;
 }
@@ -203,8 +458,8 @@ Token::Value Scanner::selectToken(char _next, Token::Value _then, Token::Value _
 bool Scanner::skipWhitespace()
 {
 	int const startPosition = sourcePos();
-	while (isWhiteSpace(m_char))
-		advance();
+	if (isWhiteSpace(m_char))
+		m_char = m_source.setPosition(endOfWhitespaceRun(m_source.data(), sourcePos(), m_source.size()));
 	// Return whether or not we skipped any characters.
 	return sourcePos() != startPosition;
 }
@@ -223,13 +478,22 @@ Token::Value Scanner::skipSingleLineComment()
 	// The line terminator at the end of the line is not considered
 	// to be part of the single-line comment; it is recognized
 	// separately by the lexical grammar and becomes part of the
-	// stream of input elements for the syntactic grammar
-	while (!isLineTerminator(m_char))
-		if (!advance()) break;
-
+	// stream of input elements for the syntactic grammar.
+	// Jump straight to the line terminator (or the end of the input)
+	// instead of testing every character individually.
+	m_char = m_source.setPosition(endOfLine(sourcePos()));
 	return Token::Whitespace;
 }
 
+size_t Scanner::endOfLine(size_t _position) const
+{
+	if (_position >= m_source.size())
+		return m_source.size();
+	char const* lineEnd = static_cast<char const*>(
+		memchr(m_source.data() + _position, '\n', m_source.size() - _position));
+	return lineEnd ? size_t(lineEnd - m_source.data()) : m_source.size();
+}
+
 Token::Value Scanner::scanSingleLineDocComment()
 {
 	LiteralScope literal(this, LITERAL_TYPE_COMMENT);
@@ -263,21 +527,29 @@ Token::Value Scanner::scanSingleLineDocComment()
 Token::Value Scanner::skipMultiLineComment()
 {
 	advance();
-	while (!isSourcePastEndOfInput())
+	// Bulk-search for the terminating "*/": hop from '*' to '*' via memchr
+	// instead of advancing one character at a time.
+	size_t position = sourcePos();
+	while (position < m_source.size())
 	{
-		char ch = m_char;
-		advance();
-
-		// If we have reached the end of the multi-line comment, we
-		// consume the '/' and insert a whitespace. This way all
-		// multi-line comments are treated as whitespace.
-		if (ch == '*' && m_char == '/')
+		char const* star = static_cast<char const*>(
+			memchr(m_source.data() + position, '*', m_source.size() - position));
+		if (!star)
+			break;
+		position = star - m_source.data();
+		if (position + 1 < m_source.size() && m_source.data()[position + 1] == '/')
 		{
+			// We have reached the end of the multi-line comment. Position on
+			// the '/' and insert a whitespace; this way all multi-line
+			// comments are treated as whitespace.
+			m_source.setPosition(position + 1);
 			m_char = ' ';
 			return Token::Whitespace;
 		}
+		position++;
 	}
 	// Unterminated multi-line comment.
+	m_char = m_source.setPosition(m_source.size());
 	return Token::Illegal;
 }
 
@@ -382,6 +654,7 @@ Token::Value Scanner::scanSlash()
 void Scanner::scanToken()
 {
 	m_nextToken.literal.clear();
+	m_nextToken.numberValueKnown = false;
 	m_nextSkippedComment.literal.clear();
 	Token::Value token;
 	do
@@ -616,6 +889,24 @@ Token::Value Scanner::scanString()
 	char const quote = m_char;
 	advance();  // consume quote
 	LiteralScope literal(this, LITERAL_TYPE_STRING);
+	// Fast path: most literals contain no escape sequence at all, so try to
+	// locate the closing quote with a single search and bulk-copy the
+	// contents. Fall back to the per-character loop as soon as a backslash
+	// (or an unterminated literal) is involved.
+	size_t const start = sourcePos();
+	char const* data = m_source.data();
+	char const* close = static_cast<char const*>(memchr(data + start, quote, m_source.size() - start));
+	if (close)
+	{
+		size_t const end = close - data;
+		if (!memchr(data + start, '\\', end - start) && endOfLine(start) > end)
+		{
+			m_nextToken.literal.append(data + start, end - start);
+			literal.complete();
+			m_char = m_source.setPosition(end + 1);  // consume closing quote
+			return Token::StringLiteral;
+		}
+	}
 	while (m_char != quote && !isSourcePastEndOfInput() && !isLineTerminator(m_char))
 	{
 		char c = m_char;
@@ -702,6 +993,9 @@ Token::Value Scanner::scanNumber(char _charSeen)
 	if (isDecimalDigit(m_char) || isIdentifierStart(m_char))
 		return Token::Illegal;
 	literal.complete();
+	// Attach the numeric value to the token so that downstream consumers do
+	// not have to re-parse the literal text.
+	m_nextToken.numberValueKnown = parseNumberValue(m_nextToken.literal, m_nextToken.numberValue);
 	return Token::Number;
 }
 
@@ -709,10 +1003,11 @@ Token::Value Scanner::scanIdentifierOrKeyword()
 {
 	solAssert(isIdentifierStart(m_char), "");
 	LiteralScope literal(this, LITERAL_TYPE_STRING);
-	addLiteralCharAndAdvance();
-	// Scan the rest of the identifier characters.
-	while (isIdentifierPart(m_char))
-		addLiteralCharAndAdvance();
+	// Find the end of the identifier in bulk and copy it in one piece.
+	size_t const start = sourcePos();
+	size_t const end = endOfIdentifierRun(m_source.data(), start + 1, m_source.size());
+	m_nextToken.literal.append(m_source.data() + start, end - start);
+	m_char = m_source.setPosition(end);
 	literal.complete();
 	return Token::fromIdentifierOrKeyword(m_nextToken.literal);
 }
@@ -724,7 +1019,14 @@ char CharStream::advanceAndGet(size_t _chars)
 	m_position += _chars;
 	if (isPastEndOfInput())
 		return 0;
-	return m_source[m_position];
+	return m_data[m_position];
+}
+
+char CharStream::setPosition(size_t _position)
+{
+	solAssert(_position <= m_size, "");
+	m_position = _position;
+	return isPastEndOfInput() ? 0 : m_data[m_position];
 }
 
 char CharStream::rollback(size_t _amount)
@@ -734,36 +1036,40 @@ char CharStream::rollback(size_t _amount)
 	return get();
 }
 
+void CharStream::ensureLineIndex() const
+{
+	if (!m_lineStarts.empty())
+		return;
+	m_lineStarts.push_back(0);
+	for (size_t i = 0; i < m_size; ++i)
+		if (m_data[i] == '\n')
+			m_lineStarts.push_back(i + 1);
+}
+
 string CharStream::lineAtPosition(int _position) const
 {
 	// if _position points to \n, it returns the line before the \n
-	using size_type = string::size_type;
-	size_type searchStart = min<size_type>(m_source.size(), _position);
+	ensureLineIndex();
+	size_t searchStart = min<size_t>(m_size, _position);
 	if (searchStart > 0)
 		searchStart--;
-	size_type lineStart = m_source.rfind('\n', searchStart);
-	if (lineStart == string::npos)
-		lineStart = 0;
-	else
-		lineStart++;
-	return m_source.substr(lineStart, min(m_source.find('\n', lineStart),
-										  m_source.size()) - lineStart);
+	// The line start to use is the greatest one not after searchStart + 1, so
+	// that a '\n' at searchStart itself selects the following line.
+	auto it = upper_bound(m_lineStarts.begin(), m_lineStarts.end(), searchStart + 1);
+	size_t lineStart = *(it - 1);
+	size_t lineEnd = it == m_lineStarts.end() ? m_size : *it - 1;
+	if (lineEnd <= lineStart)
+		return string();
+	return string(m_data + lineStart, lineEnd - lineStart);
 }
 
 tuple<int, int> CharStream::translatePositionToLineColumn(int _position) const
 {
-	using size_type = string::size_type;
-	size_type searchPosition = min<size_type>(m_source.size(), _position);
-	int lineNumber = count(m_source.begin(), m_source.begin() + searchPosition, '\n');
-	size_type lineStart;
-	if (searchPosition == 0)
-		lineStart = 0;
-	else
-	{
-		lineStart = m_source.rfind('\n', searchPosition - 1);
-		lineStart = lineStart == string::npos ? 0 : lineStart + 1;
-	}
-	return tuple<int, int>(lineNumber, searchPosition - lineStart);
+	ensureLineIndex();
+	size_t searchPosition = min<size_t>(m_size, _position);
+	auto it = upper_bound(m_lineStarts.begin(), m_lineStarts.end(), searchPosition);
+	size_t lineNumber = size_t(it - m_lineStarts.begin()) - 1;
+	return tuple<int, int>(int(lineNumber), int(searchPosition - m_lineStarts[lineNumber]));
 }
 
 
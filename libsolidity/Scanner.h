@@ -52,6 +52,9 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
 #include <libdevcore/Common.h>
 #include <libdevcore/Log.h>
 #include <libdevcore/CommonData.h>
@@ -72,26 +75,63 @@ class CharStream
 {
 public:
 	CharStream(): m_position(0) {}
-	explicit CharStream(std::string const& _source): m_source(_source), m_position(0) {}
+	explicit CharStream(std::string const& _source):
+		m_ownedSource(std::make_shared<std::string>(_source)),
+		m_data(m_ownedSource->data()),
+		m_size(m_ownedSource->size()),
+		m_position(0)
+	{}
+	/// Constructs a stream over an externally owned buffer, e.g. a memory-mapped
+	/// file. The bytes are not copied; the buffer has to stay alive and unchanged
+	/// for the lifetime of the stream and all of its copies.
+	CharStream(char const* _data, size_t _size): m_data(_data), m_size(_size), m_position(0) {}
 	int position() const { return m_position; }
-	bool isPastEndOfInput(size_t _charsForward = 0) const { return (m_position + _charsForward) >= m_source.size(); }
-	char get(size_t _charsForward = 0) const { return m_source[m_position + _charsForward]; }
+	bool isPastEndOfInput(size_t _charsForward = 0) const { return (m_position + _charsForward) >= m_size; }
+	/// @returns the character @a _charsForward characters ahead of the current
+	/// position, or 0 past the end of the input (also covering empty and
+	/// default-constructed streams, whose data pointer is null).
+	char get(size_t _charsForward = 0) const
+	{
+		size_t position = m_position + _charsForward;
+		return position < m_size ? m_data[position] : 0;
+	}
 	char advanceAndGet(size_t _chars=1);
 	char rollback(size_t _amount);
+	/// Moves the position directly to @a _position (used by the bulk scanning paths)
+	/// and @returns the character there or 0 if it is past the end of the input.
+	char setPosition(size_t _position);
+
+	///@{
+	///@name Raw access for bulk scanning
+	/// Direct read-only access to the source text so that the scanner can
+	/// classify many characters per step instead of going through get().
+	char const* data() const { return m_data; }
+	size_t size() const { return m_size; }
+	///@}
 
 	void reset() { m_position = 0; }
 
 	///@{
-	///@name Error printing helper functions
-	/// Functions that help pretty-printing parse errors
-	/// Do only use in error cases, they are quite expensive.
+	///@name Position translation helper functions
+	/// Functions that help pretty-printing parse errors and translating
+	/// locations for diagnostics. Backed by a lazily built newline-offset
+	/// index, so each query is a binary search over the line starts.
 	std::string lineAtPosition(int _position) const;
 	std::tuple<int, int> translatePositionToLineColumn(int _position) const;
 	///@}
 
 private:
-	std::string m_source;
+	/// Builds the newline-offset index on first use.
+	void ensureLineIndex() const;
+
+	/// Keeps string-constructed sources alive; copies of the stream share it.
+	/// Empty for streams over externally owned buffers.
+	std::shared_ptr<std::string const> m_ownedSource;
+	char const* m_data = nullptr;
+	size_t m_size = 0;
 	size_t m_position;
+	/// Start offsets of all lines, built lazily by ensureLineIndex().
+	mutable std::vector<size_t> m_lineStarts;
 };
 
 
@@ -101,7 +141,16 @@ class Scanner
 	friend class LiteralScope;
 public:
 
-	explicit Scanner(CharStream const& _source = CharStream(), std::string const& _sourceName = "") { reset(_source, _sourceName); }
+	/// If @a _tokenizeUpFront is set, the whole source is scanned into a
+	/// compact token buffer on reset and next() just walks the buffer. This
+	/// gives the parser cache-friendly sequential access, makes arbitrary
+	/// lookahead via peekToken() cheap and allows scanning of one source to
+	/// overlap with parsing of another.
+	explicit Scanner(
+		CharStream const& _source = CharStream(),
+		std::string const& _sourceName = "",
+		bool _tokenizeUpFront = false
+	): m_tokenizeUpFront(_tokenizeUpFront) { reset(_source, _sourceName); }
 
 	/// Resets the scanner as if newly constructed with _source and _sourceName as input.
 	void reset(CharStream const& _source, std::string const& _sourceName);
@@ -111,6 +160,11 @@ public:
 	/// Returns the next token and advances input
 	Token::Value next();
 
+	/// @returns the type of the token @a _ahead tokens after the current one
+	/// without advancing the input. _ahead == 0 is the current and 1 the next
+	/// token; larger distances are only available in pre-tokenized mode.
+	Token::Value peekToken(size_t _ahead) const;
+
 	///@{
 	///@name Information about the current token
 
@@ -122,6 +176,13 @@ public:
 
 	SourceLocation currentLocation() const { return m_currentToken.location; }
 	std::string const& currentLiteral() const { return m_currentToken.literal; }
+	/// @returns true if the scanner already converted the current number token
+	/// to its numeric value (fractional literals and values exceeding 256 bits
+	/// are left to the string-based conversion downstream).
+	bool currentNumberValueKnown() const { return m_currentToken.numberValueKnown; }
+	/// @returns the value of the current number token, only valid if
+	/// currentNumberValueKnown() returns true.
+	u256 const& currentNumberValue() const { return m_currentToken.numberValue; }
 	///@}
 
 	///@{
@@ -145,6 +206,9 @@ public:
 
 	std::shared_ptr<std::string const> const& sourceName() const { return m_sourceName; }
 
+	/// @returns direct access to the underlying character stream, e.g. to hash source slices.
+	CharStream const& charStream() const { return m_source; }
+
 	///@{
 	///@name Error printing helper functions
 	/// Functions that help pretty-printing parse errors
@@ -160,8 +224,46 @@ private:
 		Token::Value token;
 		SourceLocation location;
 		std::string literal;
+		/// Numeric value of a number token, pre-parsed during scanning.
+		u256 numberValue;
+		bool numberValueKnown = false;
 	};
 
+	///@{
+	///@name Pre-tokenization support
+	/// Compact record for a pre-scanned token. The literal text of all tokens
+	/// lives concatenated in a shared pool and is referenced by offset/length.
+	struct CompactToken
+	{
+		Token::Value token;
+		int start;
+		int end;
+		unsigned literalOffset;
+		unsigned literalLength;
+		/// 1-based index into the comment buffer for a documentation comment
+		/// preceding this token, 0 if there is none.
+		unsigned commentIndex;
+		/// 1-based index into the number value buffer, 0 if not pre-parsed.
+		unsigned numberValueIndex;
+	};
+	struct CompactComment
+	{
+		Token::Value token;
+		int start;
+		int end;
+		unsigned literalOffset;
+		unsigned literalLength;
+	};
+
+	/// Scans the whole source into m_tokenBuffer (pre-tokenized mode only).
+	void tokenizeAll();
+	/// Fills m_nextToken/m_nextSkippedComment from the buffered record at
+	/// m_nextTokenIndex.
+	void materializeBufferedToken();
+	/// Advances to the next buffered record (stays on EOS) and materializes it.
+	void loadBufferedToken();
+	///@}
+
 	///@{
 	///@name Literal buffer support
 	inline void addLiteralChar(char c) { m_nextToken.literal.push_back(c); }
@@ -187,6 +289,9 @@ private:
 	bool skipWhitespaceExceptLF();
 	Token::Value skipSingleLineComment();
 	Token::Value skipMultiLineComment();
+	/// @returns the position of the next line terminator at or after
+	/// @a _position (or the end of the input), found via bulk search.
+	size_t endOfLine(size_t _position) const;
 
 	void scanDecimalDigits();
 	Token::Value scanNumber(char _charSeen = 0);
@@ -218,6 +323,18 @@ private:
 
 	/// one character look-ahead, equals 0 at end of input
 	char m_char;
+
+	///@{
+	///@name Pre-tokenization state
+	bool m_tokenizeUpFront = false;
+	std::vector<CompactToken> m_tokenBuffer;
+	std::vector<CompactComment> m_commentBuffer;
+	std::vector<u256> m_numberValueBuffer;
+	/// Concatenated literal texts of all buffered tokens and comments.
+	std::string m_literalPool;
+	/// Index of the buffered record currently held in m_nextToken.
+	size_t m_nextTokenIndex = 0;
+	///@}
 };
 
 }
@@ -99,7 +99,14 @@ void SourceReferenceFormatter::printExceptionInformation(
 	}
 
 	_stream << _name;
-	if (string const* description = boost::get_error_info<errinfo_comment>(_exception))
+	// Errors carry structured data and format their description only now, when
+	// they are actually rendered.
+	string const* description = nullptr;
+	if (auto error = dynamic_cast<Error const*>(&_exception))
+		description = error->description();
+	else
+		description = boost::get_error_info<errinfo_comment>(_exception);
+	if (description)
 		_stream << ": " << *description << endl;
 
 	if (location)
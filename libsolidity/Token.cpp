@@ -40,7 +40,7 @@
 // You should have received a copy of the GNU General Public License
 // along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
 
-#include <map>
+#include <cstring>
 #include <libsolidity/Token.h>
 
 using namespace std;
@@ -80,17 +80,81 @@ char const Token::m_tokenType[] =
 {
 	TOKEN_LIST(KT, KK)
 };
-Token::Value Token::fromIdentifierOrKeyword(const std::string& _name)
+namespace
+{
+
+/// Open-addressing hash table over the keywords of TOKEN_LIST. The table is
+/// sized to several times the keyword count so a lookup almost always hits
+/// (or can reject) with the first probe; collisions step linearly and an
+/// empty slot terminates a miss. Classifying an identifier is thus a single
+/// hash plus typically one length/memcmp check, instead of the tree walk and
+/// per-node string comparisons of a std::map.
+class KeywordTable
 {
-	// The following macros are used inside TOKEN_LIST and cause non-keyword tokens to be ignored
-	// and keywords to be put inside the keywords variable.
-#define KEYWORD(name, string, precedence) {string, Token::name},
+public:
+	KeywordTable()
+	{
+		// The following macros are used inside TOKEN_LIST and cause non-keyword
+		// tokens to be ignored while keywords are inserted into the table.
+#define KEYWORD(name, string, precedence) insert(string, Token::name);
 #define TOKEN(name, string, precedence)
-	static const map<string, Token::Value> keywords({TOKEN_LIST(TOKEN, KEYWORD)});
+		TOKEN_LIST(TOKEN, KEYWORD)
 #undef KEYWORD
 #undef TOKEN
-	auto it = keywords.find(_name);
-	return it == keywords.end() ? Token::Identifier : it->second;
+	}
+
+	Token::Value lookup(string const& _name) const
+	{
+		uint32_t slot = hash(_name.data(), _name.size()) & (c_size - 1);
+		while (m_entries[slot].string)
+		{
+			if (m_entries[slot].length == _name.size() && memcmp(m_entries[slot].string, _name.data(), _name.size()) == 0)
+				return m_entries[slot].token;
+			slot = (slot + 1) & (c_size - 1);
+		}
+		return Token::Identifier;
+	}
+
+private:
+	struct Entry
+	{
+		char const* string;
+		unsigned length;
+		Token::Value token;
+	};
+	/// Power of two, roughly five times the number of keywords.
+	static unsigned const c_size = 1024;
+
+	static uint32_t hash(char const* _data, size_t _length)
+	{
+		// FNV-1a, cheap and well-distributed on short identifier-like strings.
+		uint32_t h = 2166136261u;
+		for (size_t i = 0; i < _length; ++i)
+		{
+			h ^= uint8_t(_data[i]);
+			h *= 16777619u;
+		}
+		return h;
+	}
+
+	void insert(char const* _string, Token::Value _token)
+	{
+		size_t length = strlen(_string);
+		uint32_t slot = hash(_string, length) & (c_size - 1);
+		while (m_entries[slot].string)
+			slot = (slot + 1) & (c_size - 1);
+		m_entries[slot] = Entry{_string, unsigned(length), _token};
+	}
+
+	Entry m_entries[c_size] = {};
+};
+
+} // end anonymous namespace
+
+Token::Value Token::fromIdentifierOrKeyword(const std::string& _name)
+{
+	static KeywordTable const keywords;
+	return keywords.lookup(_name);
 }
 
 #undef KT
@@ -60,6 +60,15 @@ TypePointer const& TypeChecker::type(VariableDeclaration const& _variable) const
 
 bool TypeChecker::visit(ContractDefinition const& _contract)
 {
+	if (m_mode == Mode::OnlyBodies)
+	{
+		// Declarations and signatures were already covered by a SkipBodies
+		// run; only descend into the executable bodies now.
+		ASTNode::listAccept(_contract.functionModifiers(), *this);
+		ASTNode::listAccept(_contract.definedFunctions(), *this);
+		return false;
+	}
+
 	// We force our own visiting order here.
 	ASTNode::listAccept(_contract.definedStructs(), *this);
 	ASTNode::listAccept(_contract.baseContracts(), *this);
@@ -82,7 +91,7 @@ bool TypeChecker::visit(ContractDefinition const& _contract)
 			{
 				auto err = make_shared<Error>(Error::Type::DeclarationError);
 				*err << errinfo_comment("Only one fallback function is allowed.");
-				m_errors.push_back(err);
+				reportError(err);
 			}
 			else
 			{
@@ -107,10 +116,13 @@ bool TypeChecker::visit(ContractDefinition const& _contract)
 	{
 		FixedHash<4> const& hash = it.first;
 		if (hashes.count(hash))
-			typeError(
-				_contract,
-				string("Function signature hash collision for ") + it.second->externalSignature()
-			);
+		{
+			FunctionTypePointer functionType = it.second;
+			typeError(_contract, [functionType]() -> string
+			{
+				return "Function signature hash collision for " + functionType->externalSignature();
+			});
+		}
 		hashes.insert(hash);
 	}
 
@@ -141,7 +153,7 @@ void TypeChecker::checkContractDuplicateFunctions(ContractDefinition const& _con
 			errinfo_sourceLocation(functions[_contract.name()].front()->location()) <<
 			errinfo_comment("More than one constructor defined.") <<
 			errinfo_secondarySourceLocation(ssl);
-		m_errors.push_back(err);
+		reportError(err);
 	}
 	for (auto const& it: functions)
 	{
@@ -156,7 +168,7 @@ void TypeChecker::checkContractDuplicateFunctions(ContractDefinition const& _con
 						errinfo_comment("Function with same name and arguments defined twice.") <<
 						errinfo_secondarySourceLocation(SecondarySourceLocation().append(
 							"Other declaration is here:", overloads[i]->location()));
-					m_errors.push_back(err);
+					reportError(err);
 				}
 	}
 }
@@ -337,26 +349,36 @@ void TypeChecker::endVisit(InheritanceSpecifier const& _inheritance)
 	auto const& arguments = _inheritance.arguments();
 	TypePointers parameterTypes = ContractType(*base).constructorType()->parameterTypes();
 	if (!arguments.empty() && parameterTypes.size() != arguments.size())
-		typeError(
-			_inheritance,
-			"Wrong argument count for constructor call: " +
-			toString(arguments.size()) +
-			" arguments given but expected " +
-			toString(parameterTypes.size()) +
-			"."
-		);
+	{
+		size_t given = arguments.size();
+		size_t expected = parameterTypes.size();
+		typeError(_inheritance, [given, expected]() -> string
+		{
+			return
+				"Wrong argument count for constructor call: " +
+				toString(given) +
+				" arguments given but expected " +
+				toString(expected) +
+				".";
+		});
+	}
 
 	for (size_t i = 0; i < arguments.size(); ++i)
 		if (!type(*arguments[i])->isImplicitlyConvertibleTo(*parameterTypes[i]))
-			typeError(
-				*arguments[i],
-				"Invalid type for argument in constructor call. "
-				"Invalid implicit conversion from " +
-				type(*arguments[i])->toString() +
-				" to " +
-				parameterTypes[i]->toString() +
-				" requested."
-			);
+		{
+			TypePointer argumentType = type(*arguments[i]);
+			TypePointer parameterType = parameterTypes[i];
+			typeError(*arguments[i], [argumentType, parameterType]() -> string
+			{
+				return
+					"Invalid type for argument in constructor call. "
+					"Invalid implicit conversion from " +
+					argumentType->toString() +
+					" to " +
+					parameterType->toString() +
+					" requested.";
+			});
+		}
 }
 
 bool TypeChecker::visit(StructDefinition const& _struct)
@@ -390,26 +412,38 @@ bool TypeChecker::visit(StructDefinition const& _struct)
 
 bool TypeChecker::visit(FunctionDefinition const& _function)
 {
-	bool isLibraryFunction = dynamic_cast<ContractDefinition const&>(*_function.scope()).isLibrary();
-	for (ASTPointer<VariableDeclaration> const& var: _function.parameters() + _function.returnParameters())
+	if (m_mode != Mode::OnlyBodies)
 	{
-		if (!type(*var)->canLiveOutsideStorage())
-			typeError(*var, "Type is required to live outside storage.");
-		if (_function.visibility() >= FunctionDefinition::Visibility::Public && !(type(*var)->interfaceType(isLibraryFunction)))
-			fatalTypeError(*var, "Internal type is not allowed for public or external functions.");
+		bool isLibraryFunction = dynamic_cast<ContractDefinition const&>(*_function.scope()).isLibrary();
+		for (ASTPointer<VariableDeclaration> const& var: _function.parameters() + _function.returnParameters())
+		{
+			if (!type(*var)->canLiveOutsideStorage())
+				typeError(*var, "Type is required to live outside storage.");
+			if (_function.visibility() >= FunctionDefinition::Visibility::Public && !(type(*var)->interfaceType(isLibraryFunction)))
+				fatalTypeError(*var, "Internal type is not allowed for public or external functions.");
+		}
+		for (ASTPointer<ModifierInvocation> const& modifier: _function.modifiers())
+			visitManually(
+				*modifier,
+				_function.isConstructor() ?
+				dynamic_cast<ContractDefinition const&>(*_function.scope()).annotation().linearizedBaseContracts :
+				vector<ContractDefinition const*>()
+			);
 	}
-	for (ASTPointer<ModifierInvocation> const& modifier: _function.modifiers())
-		visitManually(
-			*modifier,
-			_function.isConstructor() ?
-			dynamic_cast<ContractDefinition const&>(*_function.scope()).annotation().linearizedBaseContracts :
-			vector<ContractDefinition const*>()
-		);
-	if (_function.isImplemented())
+	if (_function.isImplemented() && m_mode != Mode::SkipBodies)
 		_function.body().accept(*this);
 	return false;
 }
 
+bool TypeChecker::visit(ModifierDefinition const& _modifier)
+{
+	if (m_mode != Mode::OnlyBodies)
+		_modifier.parameterList().accept(*this);
+	if (m_mode != Mode::SkipBodies)
+		_modifier.body().accept(*this);
+	return false;
+}
+
 bool TypeChecker::visit(VariableDeclaration const& _variable)
 {
 	// Variables can be declared without type (with "var"), in which case the first assignment
@@ -446,7 +480,10 @@ bool TypeChecker::visit(VariableDeclaration const& _variable)
 	{
 		if (varType->dataStoredIn(DataLocation::Memory) || varType->dataStoredIn(DataLocation::CallData))
 			if (!varType->canLiveOutsideStorage())
-				typeError(_variable, "Type " + varType->toString() + " is only valid in storage.");
+				typeError(_variable, [varType]() -> string
+				{
+					return "Type " + varType->toString() + " is only valid in storage.";
+				});
 	}
 	else if (
 		_variable.visibility() >= VariableDeclaration::Visibility::Public &&
@@ -485,25 +522,35 @@ void TypeChecker::visitManually(
 	if (!parameters)
 		typeError(_modifier, "Referenced declaration is neither modifier nor base class.");
 	if (parameters->size() != arguments.size())
-		typeError(
-			_modifier,
-			"Wrong argument count for modifier invocation: " +
-			toString(arguments.size()) +
-			" arguments given but expected " +
-			toString(parameters->size()) +
-			"."
-		);
+	{
+		size_t given = arguments.size();
+		size_t expected = parameters->size();
+		typeError(_modifier, [given, expected]() -> string
+		{
+			return
+				"Wrong argument count for modifier invocation: " +
+				toString(given) +
+				" arguments given but expected " +
+				toString(expected) +
+				".";
+		});
+	}
 	for (size_t i = 0; i < _modifier.arguments().size(); ++i)
 		if (!type(*arguments[i])->isImplicitlyConvertibleTo(*type(*(*parameters)[i])))
-			typeError(
-				*arguments[i],
-				"Invalid type for argument in modifier invocation. "
-				"Invalid implicit conversion from " +
-				type(*arguments[i])->toString() +
-				" to " +
-				type(*(*parameters)[i])->toString() +
-				" requested."
-			);
+		{
+			TypePointer argumentType = type(*arguments[i]);
+			TypePointer parameterType = type(*(*parameters)[i]);
+			typeError(*arguments[i], [argumentType, parameterType]() -> string
+			{
+				return
+					"Invalid type for argument in modifier invocation. "
+					"Invalid implicit conversion from " +
+					argumentType->toString() +
+					" to " +
+					parameterType->toString() +
+					" requested.";
+			});
+		}
 }
 
 bool TypeChecker::visit(EventDefinition const& _eventDef)
@@ -572,14 +619,18 @@ void TypeChecker::endVisit(Return const& _return)
 		if (tupleType->components().size() != params->parameters().size())
 			typeError(_return, "Different number of arguments in return statement than in returns declaration.");
 		else if (!tupleType->isImplicitlyConvertibleTo(TupleType(returnTypes)))
-			typeError(
-				*_return.expression(),
-				"Return argument type " +
-				type(*_return.expression())->toString() +
-				" is not implicitly convertible to expected type " +
-				TupleType(returnTypes).toString(false) +
-				"."
-			);
+		{
+			TypePointer givenType = type(*_return.expression());
+			typeError(*_return.expression(), [givenType, returnTypes]() -> string
+			{
+				return
+					"Return argument type " +
+					givenType->toString() +
+					" is not implicitly convertible to expected type " +
+					TupleType(returnTypes).toString(false) +
+					".";
+			});
+		}
 	}
 	else if (params->parameters().size() != 1)
 		typeError(_return, "Different number of arguments in return statement than in returns declaration.");
@@ -587,14 +638,19 @@ void TypeChecker::endVisit(Return const& _return)
 	{
 		TypePointer const& expected = type(*params->parameters().front());
 		if (!type(*_return.expression())->isImplicitlyConvertibleTo(*expected))
-			typeError(
-				*_return.expression(),
-				"Return argument type " +
-				type(*_return.expression())->toString() +
-				" is not implicitly convertible to expected type (type of first return variable) " +
-				expected->toString() +
-				"."
-			);
+		{
+			TypePointer givenType = type(*_return.expression());
+			TypePointer expectedType = expected;
+			typeError(*_return.expression(), [givenType, expectedType]() -> string
+			{
+				return
+					"Return argument type " +
+					givenType->toString() +
+					" is not implicitly convertible to expected type (type of first return variable) " +
+					expectedType->toString() +
+					".";
+			});
+		}
 	}
 }
 
@@ -613,10 +669,13 @@ bool TypeChecker::visit(VariableDeclarationStatement const& _statement)
 			if (ref->dataStoredIn(DataLocation::Storage))
 			{
 				auto err = make_shared<Error>(Error::Type::Warning);
-				*err <<
-					errinfo_sourceLocation(varDecl.location()) <<
-					errinfo_comment("Uninitialized storage pointer. Did you mean '<type> memory " + varDecl.name() + "'?");
-				m_errors.push_back(err);
+				*err << errinfo_sourceLocation(varDecl.location());
+				string name = varDecl.name();
+				err->setDescriptionFormatter([name]() -> string
+				{
+					return "Uninitialized storage pointer. Did you mean '<type> memory " + name + "'?";
+				});
+				reportError(err);
 			}
 		}
 		varDecl.accept(*this);
@@ -641,12 +700,16 @@ bool TypeChecker::visit(VariableDeclarationStatement const& _statement)
 	if (variables.empty())
 	{
 		if (!valueTypes.empty())
-			fatalTypeError(
-				_statement,
-				"Too many components (" +
-				toString(valueTypes.size()) +
-				") in value for variable assignment (0) needed"
-			);
+		{
+			size_t components = valueTypes.size();
+			fatalTypeError(_statement, [components]() -> string
+			{
+				return
+					"Too many components (" +
+					toString(components) +
+					") in value for variable assignment (0) needed";
+			});
+		}
 	}
 	else if (valueTypes.size() != variables.size() && !variables.front() && !variables.back())
 		fatalTypeError(
@@ -657,23 +720,26 @@ bool TypeChecker::visit(VariableDeclarationStatement const& _statement)
 	size_t minNumValues = variables.size();
 	if (!variables.empty() && (!variables.back() || !variables.front()))
 		--minNumValues;
+	size_t components = valueTypes.size();
 	if (valueTypes.size() < minNumValues)
-		fatalTypeError(
-			_statement,
-			"Not enough components (" +
-			toString(valueTypes.size()) +
-			") in value to assign all variables (" +
-			toString(minNumValues) + ")."
-		);
+		fatalTypeError(_statement, [components, minNumValues]() -> string
+		{
+			return
+				"Not enough components (" +
+				toString(components) +
+				") in value to assign all variables (" +
+				toString(minNumValues) + ").";
+		});
 	if (valueTypes.size() > variables.size() && variables.front() && variables.back())
-		fatalTypeError(
-			_statement,
-			"Too many components (" +
-			toString(valueTypes.size()) +
-			") in value for variable assignment (" +
-			toString(minNumValues) +
-			" needed)."
-		);
+		fatalTypeError(_statement, [components, minNumValues]() -> string
+		{
+			return
+				"Too many components (" +
+				toString(components) +
+				") in value for variable assignment (" +
+				toString(minNumValues) +
+				" needed).";
+		});
 	bool fillRight = !variables.empty() && (!variables.back() || variables.front());
 	for (size_t i = 0; i < min(variables.size(), valueTypes.size()); ++i)
 		if (fillRight)
@@ -697,7 +763,10 @@ bool TypeChecker::visit(VariableDeclarationStatement const& _statement)
 				valueComponentType->category() == Type::Category::IntegerConstant &&
 				!dynamic_pointer_cast<IntegerConstantType const>(valueComponentType)->integerType()
 			)
-				fatalTypeError(*_statement.initialValue(), "Invalid integer constant " + valueComponentType->toString() + ".");
+				fatalTypeError(*_statement.initialValue(), [valueComponentType]() -> string
+				{
+					return "Invalid integer constant " + valueComponentType->toString() + ".";
+				});
 			var.annotation().type = valueComponentType->mobileType();
 			var.accept(*this);
 		}
@@ -705,14 +774,18 @@ bool TypeChecker::visit(VariableDeclarationStatement const& _statement)
 		{
 			var.accept(*this);
 			if (!valueComponentType->isImplicitlyConvertibleTo(*var.annotation().type))
-				typeError(
-					_statement,
-					"Type " +
-					valueComponentType->toString() +
-					" is not implicitly convertible to expected type " +
-					var.annotation().type->toString() +
-					"."
-				);
+			{
+				TypePointer variableType = var.annotation().type;
+				typeError(_statement, [valueComponentType, variableType]() -> string
+				{
+					return
+						"Type " +
+						valueComponentType->toString() +
+						" is not implicitly convertible to expected type " +
+						variableType->toString() +
+						".";
+				});
+			}
 		}
 	}
 	return false;
@@ -752,15 +825,20 @@ bool TypeChecker::visit(Assignment const& _assignment)
 			type(_assignment.rightHandSide())
 		);
 		if (!resultType || *resultType != *t)
-			typeError(
-				_assignment,
-				"Operator " +
-				string(Token::toString(_assignment.assignmentOperator())) +
-				" not compatible with types " +
-				t->toString() +
-				" and " +
-				type(_assignment.rightHandSide())->toString()
-			);
+		{
+			Token::Value op = _assignment.assignmentOperator();
+			TypePointer rightType = type(_assignment.rightHandSide());
+			typeError(_assignment, [op, t, rightType]() -> string
+			{
+				return
+					"Operator " +
+					string(Token::toString(op)) +
+					" not compatible with types " +
+					t->toString() +
+					" and " +
+					rightType->toString();
+			});
+		}
 	}
 	return false;
 }
@@ -822,13 +900,15 @@ bool TypeChecker::visit(UnaryOperation const& _operation)
 	TypePointer t = type(_operation.subExpression())->unaryOperatorResult(op);
 	if (!t)
 	{
-		typeError(
-			_operation,
-			"Unary operator " +
-			string(Token::toString(op)) +
-			" cannot be applied to type " +
-			subExprType->toString()
-		);
+		TypePointer subType = subExprType;
+		typeError(_operation, [op, subType]() -> string
+		{
+			return
+				"Unary operator " +
+				string(Token::toString(op)) +
+				" cannot be applied to type " +
+				subType->toString();
+		});
 		t = subExprType;
 	}
 	_operation.annotation().type = t;
@@ -839,24 +919,28 @@ void TypeChecker::endVisit(BinaryOperation const& _operation)
 {
 	TypePointer const& leftType = type(_operation.leftExpression());
 	TypePointer const& rightType = type(_operation.rightExpression());
-	TypePointer commonType = leftType->binaryOperatorResult(_operation.getOperator(), rightType);
+	TypePointer commonType = memoizedBinaryOperatorResult(_operation.getOperator(), leftType, rightType);
 	if (!commonType)
 	{
-		typeError(
-			_operation,
-			"Operator " +
-			string(Token::toString(_operation.getOperator())) +
-			" not compatible with types " +
-			leftType->toString() +
-			" and " +
-			rightType->toString()
-		);
+		Token::Value op = _operation.getOperator();
+		TypePointer left = leftType;
+		TypePointer right = rightType;
+		typeError(_operation, [op, left, right]() -> string
+		{
+			return
+				"Operator " +
+				string(Token::toString(op)) +
+				" not compatible with types " +
+				left->toString() +
+				" and " +
+				right->toString();
+		});
 		commonType = leftType;
 	}
 	_operation.annotation().commonType = commonType;
 	_operation.annotation().type =
 		Token::isCompareOp(_operation.getOperator()) ?
-		make_shared<BoolType>() :
+		TypePool::boolean() :
 		commonType;
 }
 
@@ -944,20 +1028,29 @@ bool TypeChecker::visit(FunctionCall const& _functionCall)
 	TypePointers const& parameterTypes = functionType->parameterTypes();
 	if (!functionType->takesArbitraryParameters() && parameterTypes.size() != arguments.size())
 	{
-		string msg =
-			"Wrong argument count for function call: " +
-			toString(arguments.size()) +
-			" arguments given but expected " +
-			toString(parameterTypes.size()) +
-			".";
-		// Extend error message in case we try to construct a struct with mapping member.
-		if (_functionCall.annotation().isStructConstructorCall && !membersRemovedForStructConstructor.empty())
+		size_t given = arguments.size();
+		size_t expected = parameterTypes.size();
+		// Mention members skipped in memory in case we try to construct a
+		// struct with a mapping member.
+		set<string> skippedMembers;
+		if (_functionCall.annotation().isStructConstructorCall)
+			skippedMembers = membersRemovedForStructConstructor;
+		typeError(_functionCall, [given, expected, skippedMembers]() -> string
 		{
-			msg += " Members that have to be skipped in memory:";
-			for (auto const& member: membersRemovedForStructConstructor)
-				msg += " " + member;
-		}
-		typeError(_functionCall, msg);
+			string msg =
+				"Wrong argument count for function call: " +
+				toString(given) +
+				" arguments given but expected " +
+				toString(expected) +
+				".";
+			if (!skippedMembers.empty())
+			{
+				msg += " Members that have to be skipped in memory:";
+				for (auto const& member: skippedMembers)
+					msg += " " + member;
+			}
+			return msg;
+		});
 	}
 	else if (isPositionalCall)
 	{
@@ -972,15 +1065,20 @@ bool TypeChecker::visit(FunctionCall const& _functionCall)
 						typeError(*arguments[i], "Integer constant too large.");
 			}
 			else if (!type(*arguments[i])->isImplicitlyConvertibleTo(*parameterTypes[i]))
-				typeError(
-					*arguments[i],
-					"Invalid type for argument in function call. "
-					"Invalid implicit conversion from " +
-					type(*arguments[i])->toString() +
-					" to " +
-					parameterTypes[i]->toString() +
-					" requested."
-				);
+			{
+				TypePointer argumentType = type(*arguments[i]);
+				TypePointer parameterType = parameterTypes[i];
+				typeError(*arguments[i], [argumentType, parameterType]() -> string
+				{
+					return
+						"Invalid type for argument in function call. "
+						"Invalid implicit conversion from " +
+						argumentType->toString() +
+						" to " +
+						parameterType->toString() +
+						" requested.";
+				});
+			}
 		}
 	}
 	else
@@ -1019,15 +1117,20 @@ bool TypeChecker::visit(FunctionCall const& _functionCall)
 							found = true;
 							// check type convertible
 							if (!type(*arguments[i])->isImplicitlyConvertibleTo(*parameterTypes[j]))
-								typeError(
-									*arguments[i],
-									"Invalid type for argument in function call. "
-									"Invalid implicit conversion from " +
-									type(*arguments[i])->toString() +
-									" to " +
-									parameterTypes[i]->toString() +
-									" requested."
-								);
+							{
+								TypePointer argumentType = type(*arguments[i]);
+								TypePointer parameterType = parameterTypes[i];
+								typeError(*arguments[i], [argumentType, parameterType]() -> string
+								{
+									return
+										"Invalid type for argument in function call. "
+										"Invalid implicit conversion from " +
+										argumentType->toString() +
+										" to " +
+										parameterType->toString() +
+										" requested.";
+								});
+							}
 							break;
 						}
 
@@ -1103,24 +1206,27 @@ bool TypeChecker::visit(MemberAccess const& _memberAccess)
 			exprType
 		);
 		if (!storageType->members().membersByName(memberName).empty())
-			fatalTypeError(
-				_memberAccess,
-				"Member \"" + memberName + "\" is not available in " +
-				exprType->toString() +
-				" outside of storage."
-			);
-		fatalTypeError(
-			_memberAccess,
-			"Member \"" + memberName + "\" not found or not visible "
-			"after argument-dependent lookup in " + exprType->toString()
-		);
+			fatalTypeError(_memberAccess, [memberName, exprType]() -> string
+			{
+				return
+					"Member \"" + memberName + "\" is not available in " +
+					exprType->toString() +
+					" outside of storage.";
+			});
+		fatalTypeError(_memberAccess, [memberName, exprType]() -> string
+		{
+			return
+				"Member \"" + memberName + "\" not found or not visible "
+				"after argument-dependent lookup in " + exprType->toString();
+		});
 	}
 	else if (possibleMembers.size() > 1)
-		fatalTypeError(
-			_memberAccess,
-			"Member \"" + memberName + "\" not unique "
-			"after argument-dependent lookup in " + exprType->toString()
-		);
+		fatalTypeError(_memberAccess, [memberName, exprType]() -> string
+		{
+			return
+				"Member \"" + memberName + "\" not unique "
+				"after argument-dependent lookup in " + exprType->toString();
+		});
 
 	auto& annotation = _memberAccess.annotation();
 	annotation.referencedDeclaration = possibleMembers.front().declaration;
@@ -1201,10 +1307,10 @@ bool TypeChecker::visit(IndexAccess const& _access)
 		break;
 	}
 	default:
-		fatalTypeError(
-			_access.baseExpression(),
-			"Indexed expression has to be a type, mapping or array (is " + baseType->toString() + ")"
-		);
+		fatalTypeError(_access.baseExpression(), [baseType]() -> string
+		{
+			return "Indexed expression has to be a type, mapping or array (is " + baseType->toString() + ")";
+		});
 	}
 	_access.annotation().type = move(resultType);
 	_access.annotation().isLValue = isLValue;
@@ -1293,14 +1399,21 @@ void TypeChecker::expectType(Expression const& _expression, Type const& _expecte
 	_expression.accept(*this);
 
 	if (!type(_expression)->isImplicitlyConvertibleTo(_expectedType))
-		typeError(
-			_expression,
-			"Type " +
-			type(_expression)->toString() +
-			" is not implicitly convertible to expected type " +
-			_expectedType.toString() +
-			"."
-		);
+	{
+		TypePointer givenType = type(_expression);
+		// The expected type is frequently a stack temporary, so its description
+		// has to be taken now; the given type's is deferred.
+		string expectedDescription = _expectedType.toString();
+		typeError(_expression, [givenType, expectedDescription]() -> string
+		{
+			return
+				"Type " +
+				givenType->toString() +
+				" is not implicitly convertible to expected type " +
+				expectedDescription +
+				".";
+		});
+	}
 }
 
 void TypeChecker::requireLValue(Expression const& _expression)
@@ -1311,14 +1424,30 @@ void TypeChecker::requireLValue(Expression const& _expression)
 		typeError(_expression, "Expression has to be an lvalue.");
 }
 
+void TypeChecker::reportError(shared_ptr<Error const> _error)
+{
+	m_errors.push_back(_error);
+	if (m_errorSink && !m_errorSink(*_error))
+		// The sink requested cancellation; abort like a fatal error.
+		BOOST_THROW_EXCEPTION(FatalError());
+}
+
 void TypeChecker::typeError(ASTNode const& _node, string const& _description)
 {
 	auto err = make_shared<Error>(Error::Type::TypeError);
-	*err <<
-		errinfo_sourceLocation(_node.location()) <<
-		errinfo_comment(_description);
+	*err << errinfo_sourceLocation(_node.location());
+	err->setDescription(_description);
 
-	m_errors.push_back(err);
+	reportError(err);
+}
+
+void TypeChecker::typeError(ASTNode const& _node, Error::DescriptionFormatter _formatter)
+{
+	auto err = make_shared<Error>(Error::Type::TypeError);
+	*err << errinfo_sourceLocation(_node.location());
+	err->setDescriptionFormatter(std::move(_formatter));
+
+	reportError(err);
 }
 
 void TypeChecker::fatalTypeError(ASTNode const& _node, string const& _description)
@@ -1326,3 +1455,9 @@ void TypeChecker::fatalTypeError(ASTNode const& _node, string const& _descriptio
 	typeError(_node, _description);
 	BOOST_THROW_EXCEPTION(FatalError());
 }
+
+void TypeChecker::fatalTypeError(ASTNode const& _node, Error::DescriptionFormatter _formatter)
+{
+	typeError(_node, std::move(_formatter));
+	BOOST_THROW_EXCEPTION(FatalError());
+}
@@ -42,8 +42,20 @@ namespace solidity
 class TypeChecker: private ASTConstVisitor
 {
 public:
+	/// Controls how much of a contract checkTypeRequirements covers.
+	enum class Mode
+	{
+		Full, ///< check declarations, signatures and all executable bodies
+		SkipBodies, ///< check declarations and signatures but leave function and modifier bodies unchecked
+		OnlyBodies ///< check only the bodies a previous SkipBodies run left out
+	};
+
 	/// @param _errors the reference to the list of errors and warnings to add them found during type checking.
-	TypeChecker(ErrorList& _errors): m_errors(_errors) {}
+	/// @param _mode the parts of the contract to cover, see @a Mode.
+	/// @param _errorSink optional callback notified of every recorded error; a false
+	/// return aborts the check like a fatal error.
+	TypeChecker(ErrorList& _errors, Mode _mode = Mode::Full, ErrorSink _errorSink = ErrorSink()):
+		m_errors(_errors), m_mode(_mode), m_errorSink(std::move(_errorSink)) {}
 
 	/// Performs type checking on the given contract and all of its sub-nodes.
 	/// @returns true iff all checks passed. Note even if all checks passed, errors() can still contain warnings
@@ -56,11 +68,20 @@ public:
 	TypePointer const& type(VariableDeclaration const& _variable) const;
 
 private:
+	/// Records @a _error, notifies the error sink and aborts if it requests cancellation.
+	void reportError(std::shared_ptr<Error const> _error);
+
 	/// Adds a new error to the list of errors.
 	void typeError(ASTNode const& _node, std::string const& _description);
+	/// Adds a new error whose description is built by @a _formatter only when the
+	/// error is actually rendered. Use this whenever the description requires
+	/// formatting work (type names, argument counts); the formatter must only
+	/// capture data that outlives the type checking run.
+	void typeError(ASTNode const& _node, Error::DescriptionFormatter _formatter);
 
 	/// Adds a new error to the list of errors and throws to abort type checking.
 	void fatalTypeError(ASTNode const& _node, std::string const& _description);
+	void fatalTypeError(ASTNode const& _node, Error::DescriptionFormatter _formatter);
 
 	virtual bool visit(ContractDefinition const& _contract) override;
 	/// Checks that two functions defined in this contract with the same name have different
@@ -78,6 +99,7 @@ private:
 	virtual void endVisit(InheritanceSpecifier const& _inheritance) override;
 	virtual bool visit(StructDefinition const& _struct) override;
 	virtual bool visit(FunctionDefinition const& _function) override;
+	virtual bool visit(ModifierDefinition const& _modifier) override;
 	virtual bool visit(VariableDeclaration const& _variable) override;
 	/// We need to do this manually because we want to pass the bases of the current contract in
 	/// case this is a base constructor call.
@@ -116,6 +138,9 @@ private:
 	void requireLValue(Expression const& _expression);
 
 	ErrorList& m_errors;
+	Mode m_mode = Mode::Full;
+	/// Optional callback notified of every recorded error, see the constructor.
+	ErrorSink m_errorSink;
 };
 
 }
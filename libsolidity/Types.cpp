@@ -21,7 +21,11 @@
  */
 
 #include <libsolidity/Types.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <limits>
+#include <unordered_map>
 #include <boost/range/adaptor/reversed.hpp>
 #include <libdevcore/CommonIO.h>
 #include <libdevcore/CommonData.h>
@@ -33,12 +37,164 @@ using namespace std;
 using namespace dev;
 using namespace dev::solidity;
 
-void StorageOffsets::computeOffsets(TypePointers const& _types)
+recursive_mutex& dev::solidity::typeCacheMutex()
 {
+	static recursive_mutex mutex;
+	return mutex;
+}
+
+namespace
+{
+
+map<pair<int, IntegerType::Modifier>, shared_ptr<IntegerType const>>& integerPool()
+{
+	static map<pair<int, IntegerType::Modifier>, shared_ptr<IntegerType const>> pool;
+	return pool;
+}
+
+map<int, shared_ptr<FixedBytesType const>>& fixedBytesPool()
+{
+	static map<int, shared_ptr<FixedBytesType const>> pool;
+	return pool;
+}
+
+}
+
+shared_ptr<IntegerType const> TypePool::integer(int _bits, IntegerType::Modifier _modifier)
+{
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
+	shared_ptr<IntegerType const>& entry = integerPool()[make_pair(_bits, _modifier)];
+	if (!entry)
+		entry = make_shared<IntegerType>(_bits, _modifier);
+	return entry;
+}
+
+shared_ptr<FixedBytesType const> TypePool::fixedBytes(int _bytes)
+{
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
+	shared_ptr<FixedBytesType const>& entry = fixedBytesPool()[_bytes];
+	if (!entry)
+		entry = make_shared<FixedBytesType>(_bytes);
+	return entry;
+}
+
+shared_ptr<BoolType const> TypePool::boolean()
+{
+	static shared_ptr<BoolType const> const pool = make_shared<BoolType>();
+	return pool;
+}
+
+namespace
+{
+
+struct BinaryOperatorCacheKey
+{
+	Token::Value op;
+	TypePointer left;
+	TypePointer right;
+
+	bool operator==(BinaryOperatorCacheKey const& _other) const
+	{
+		return op == _other.op && left == _other.left && right == _other.right;
+	}
+};
+
+struct BinaryOperatorCacheKeyHash
+{
+	size_t operator()(BinaryOperatorCacheKey const& _key) const
+	{
+		size_t hash = std::hash<int>()(int(_key.op));
+		hash = hash * 31 + std::hash<Type const*>()(_key.left.get());
+		hash = hash * 31 + std::hash<Type const*>()(_key.right.get());
+		return hash;
+	}
+};
+
+unordered_map<BinaryOperatorCacheKey, TypePointer, BinaryOperatorCacheKeyHash>& binaryOperatorCache()
+{
+	static unordered_map<BinaryOperatorCacheKey, TypePointer, BinaryOperatorCacheKeyHash> cache;
+	return cache;
+}
+
+}
+
+TypePool::Statistics TypePool::statistics()
+{
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
+	Statistics statistics;
+	statistics.integerTypes = integerPool().size();
+	statistics.fixedBytesTypes = fixedBytesPool().size();
+	statistics.binaryOperatorResults = binaryOperatorCache().size();
+	return statistics;
+}
+
+TypePointer dev::solidity::memoizedBinaryOperatorResult(Token::Value _operator, TypePointer const& _left, TypePointer const& _right)
+{
+	// Constant and literal types are value-specific one-off instances; caching
+	// their results would only grow the table without ever producing a hit.
+	if (
+		_left->category() == Type::Category::IntegerConstant ||
+		_left->category() == Type::Category::StringLiteral ||
+		_right->category() == Type::Category::IntegerConstant ||
+		_right->category() == Type::Category::StringLiteral
+	)
+		return _left->binaryOperatorResult(_operator, _right);
+
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
+	auto& cache = binaryOperatorCache();
+	BinaryOperatorCacheKey key{_operator, _left, _right};
+	auto it = cache.find(key);
+	if (it != cache.end())
+		return it->second;
+	TypePointer result = _left->binaryOperatorResult(_operator, _right);
+	cache.insert(make_pair(key, result));
+	return result;
+}
+
+namespace
+{
+
+/// Flag backing StorageOffsets::layoutOptimization().
+atomic<bool> s_optimizeStorageLayout{false};
+
+}
+
+void StorageOffsets::setLayoutOptimization(bool _enabled)
+{
+	s_optimizeStorageLayout = _enabled;
+}
+
+bool StorageOffsets::layoutOptimization()
+{
+	return s_optimizeStorageLayout;
+}
+
+void StorageOffsets::computeOffsets(TypePointers const& _types, bool _optimizeLayout)
+{
+	vector<size_t> order(_types.size());
+	for (size_t i = 0; i < order.size(); ++i)
+		order[i] = i;
+	if (_optimizeLayout)
+	{
+		// Assign slots in decreasing size order: full-slot members first, then
+		// the packable ones from wide to narrow, so small members end up
+		// sharing slots instead of padding out whatever precedes them.
+		// The sort is stable, keeping members that were declared together (and
+		// are likely accessed together) in adjacent slots.
+		auto width = [&](size_t _index) -> unsigned
+		{
+			TypePointer const& type = _types[_index];
+			if (!type->canBeStored() || type->storageSize() > 1)
+				return 32;
+			return type->storageBytes();
+		};
+		stable_sort(order.begin(), order.end(), [&](size_t _a, size_t _b) { return width(_a) > width(_b); });
+	}
+
 	bigint slotOffset = 0;
 	unsigned byteOffset = 0;
 	map<size_t, pair<u256, unsigned>> offsets;
-	for (size_t i = 0; i < _types.size(); ++i)
+	for (size_t i: order)
 	{
 		TypePointer const& type = _types[i];
 		if (!type->canBeStored())
@@ -83,11 +239,53 @@ MemberList& MemberList::operator=(MemberList&& _other)
 
 	m_memberTypes = std::move(_other.m_memberTypes);
 	m_storageOffsets = std::move(_other.m_storageOffsets);
+	m_nameIndex = std::move(_other.m_nameIndex);
 	return *this;
 }
 
+std::unordered_map<string, vector<size_t>> const& MemberList::nameIndex() const
+{
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
+	if (!m_nameIndex)
+	{
+		std::unique_ptr<std::unordered_map<string, vector<size_t>>> index(
+			new std::unordered_map<string, vector<size_t>>()
+		);
+		for (size_t i = 0; i < m_memberTypes.size(); ++i)
+			(*index)[m_memberTypes[i].name].push_back(i);
+		m_nameIndex = std::move(index);
+	}
+	return *m_nameIndex;
+}
+
+TypePointer MemberList::memberType(string const& _name) const
+{
+	TypePointer type;
+	auto const& index = nameIndex();
+	auto it = index.find(_name);
+	if (it != index.end())
+		for (size_t position: it->second)
+		{
+			solAssert(!type, "Requested member type by non-unique name.");
+			type = m_memberTypes[position].type;
+		}
+	return type;
+}
+
+MemberList::MemberMap MemberList::membersByName(string const& _name) const
+{
+	MemberMap members;
+	auto const& index = nameIndex();
+	auto it = index.find(_name);
+	if (it != index.end())
+		for (size_t position: it->second)
+			members.push_back(m_memberTypes[position]);
+	return members;
+}
+
 std::pair<u256, unsigned> const* MemberList::memberStorageOffset(string const& _name) const
 {
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
 	if (!m_storageOffsets)
 	{
 		TypePointers memberTypes;
@@ -95,11 +293,12 @@ std::pair<u256, unsigned> const* MemberList::memberStorageOffset(string const& _
 		for (auto const& member: m_memberTypes)
 			memberTypes.push_back(member.type);
 		m_storageOffsets.reset(new StorageOffsets());
-		m_storageOffsets->computeOffsets(memberTypes);
+		m_storageOffsets->computeOffsets(memberTypes, StorageOffsets::layoutOptimization());
 	}
-	for (size_t index = 0; index < m_memberTypes.size(); ++index)
-		if (m_memberTypes[index].name == _name)
-			return m_storageOffsets->offset(index);
+	auto const& index = nameIndex();
+	auto it = index.find(_name);
+	if (it != index.end())
+		return m_storageOffsets->offset(it->second.front());
 	return nullptr;
 }
 
@@ -126,22 +325,22 @@ TypePointer Type::fromElementaryTypeName(Token::Value _typeToken)
 		switch(modifier)
 		{
 		case 0:
-			return make_shared<IntegerType>(bytes * 8, IntegerType::Modifier::Signed);
+			return TypePool::integer(bytes * 8, IntegerType::Modifier::Signed);
 		case 1:
-			return make_shared<IntegerType>(bytes * 8, IntegerType::Modifier::Unsigned);
+			return TypePool::integer(bytes * 8, IntegerType::Modifier::Unsigned);
 		case 2:
-			return make_shared<FixedBytesType>(bytes + 1);
+			return TypePool::fixedBytes(bytes + 1);
 		default:
 			solAssert(false, "Unexpected modifier value. Should never happen");
 			return TypePointer();
 		}
 	}
 	else if (_typeToken == Token::Byte)
-		return make_shared<FixedBytesType>(1);
+		return TypePool::fixedBytes(1);
 	else if (_typeToken == Token::Address)
-		return make_shared<IntegerType>(0, IntegerType::Modifier::Address);
+		return TypePool::integer(0, IntegerType::Modifier::Address);
 	else if (_typeToken == Token::Bool)
-		return make_shared<BoolType>();
+		return TypePool::boolean();
 	else if (_typeToken == Token::Bytes)
 		return make_shared<ArrayType>(DataLocation::Storage);
 	else if (_typeToken == Token::String)
@@ -163,7 +362,7 @@ TypePointer Type::forLiteral(Literal const& _literal)
 	{
 	case Token::TrueLiteral:
 	case Token::FalseLiteral:
-		return make_shared<BoolType>();
+		return TypePool::boolean();
 	case Token::Number:
 		if (!IntegerConstantType::isValidLiteral(_literal))
 			return TypePointer();
@@ -198,6 +397,8 @@ IntegerType::IntegerType(int _bits, IntegerType::Modifier _modifier):
 
 bool IntegerType::isImplicitlyConvertibleTo(Type const& _convertTo) const
 {
+	if (&_convertTo == this)
+		return true;
 	if (_convertTo.category() != category())
 		return false;
 	IntegerType const& convertTo = dynamic_cast<IntegerType const&>(_convertTo);
@@ -282,6 +483,8 @@ const MemberList IntegerType::AddressMemberList({
 
 bool IntegerConstantType::isValidLiteral(const Literal& _literal)
 {
+	if (_literal.scannedValueKnown())
+		return true;
 	try
 	{
 		bigint x(_literal.value());
@@ -295,7 +498,10 @@ bool IntegerConstantType::isValidLiteral(const Literal& _literal)
 
 IntegerConstantType::IntegerConstantType(Literal const& _literal)
 {
-	m_value = bigint(_literal.value());
+	if (_literal.scannedValueKnown())
+		m_value = bigint(_literal.scannedValue());
+	else
+		m_value = bigint(_literal.value());
 
 	switch (_literal.subDenomination())
 	{
@@ -328,6 +534,16 @@ IntegerConstantType::IntegerConstantType(Literal const& _literal)
 		m_value *= bigint("31536000");
 		break;
 	}
+	cacheSmallValue();
+}
+
+void IntegerConstantType::cacheSmallValue()
+{
+	m_isSmall =
+		m_value >= std::numeric_limits<int64_t>::min() &&
+		m_value <= std::numeric_limits<int64_t>::max();
+	if (m_isSmall)
+		m_smallValue = m_value.convert_to<int64_t>();
 }
 
 bool IntegerConstantType::isImplicitlyConvertibleTo(Type const& _convertTo) const
@@ -406,6 +622,77 @@ TypePointer IntegerConstantType::binaryOperatorResult(Token::Value _operator, Ty
 	}
 	else
 	{
+		// Fast path: both operands fit into 64 bits, so typical literal math
+		// runs on native integers with explicit overflow checks and falls back
+		// to bigint only when the result might not fit.
+		if (m_isSmall && other.m_isSmall)
+		{
+			int64_t const a = m_smallValue;
+			int64_t const b = other.m_smallValue;
+			int64_t const maxValue = std::numeric_limits<int64_t>::max();
+			int64_t const minValue = std::numeric_limits<int64_t>::min();
+			bool computed = true;
+			int64_t result = 0;
+			switch (_operator)
+			{
+			case Token::BitOr:
+			case Token::BitXor:
+			case Token::BitAnd:
+				// Negative operands differ between two's complement and the
+				// sign-magnitude bigint representation; leave them to bigint.
+				if (a < 0 || b < 0)
+					computed = false;
+				else if (_operator == Token::BitOr)
+					result = a | b;
+				else if (_operator == Token::BitXor)
+					result = a ^ b;
+				else
+					result = a & b;
+				break;
+			case Token::Add:
+				if (b > 0 ? a > maxValue - b : a < minValue - b)
+					computed = false;
+				else
+					result = a + b;
+				break;
+			case Token::Sub:
+				if (b > 0 ? a < minValue + b : a > maxValue + b)
+					computed = false;
+				else
+					result = a - b;
+				break;
+			case Token::Mul:
+				// Factors below 2^31 in magnitude cannot overflow a 63 bit product.
+				if (a > -(int64_t(1) << 31) && a < (int64_t(1) << 31) && b > -(int64_t(1) << 31) && b < (int64_t(1) << 31))
+					result = a * b;
+				else
+					computed = false;
+				break;
+			case Token::Div:
+				if (b == 0)
+					return TypePointer();
+				if (a == minValue && b == -1)
+					computed = false;
+				else
+					result = a / b;
+				break;
+			case Token::Mod:
+				if (b == 0)
+					return TypePointer();
+				if (a == minValue && b == -1)
+					computed = false;
+				else
+					result = a % b;
+				break;
+			default:
+				// Exponentiation and unsupported operators take the bigint path.
+				computed = false;
+				break;
+			}
+			if (computed)
+				return make_shared<IntegerConstantType>(bigint(result));
+		}
+
 		bigint value;
 		switch (_operator)
 		{
@@ -495,7 +782,7 @@ shared_ptr<IntegerType const> IntegerConstantType::integerType() const
 	if (value > u256(-1))
 		return shared_ptr<IntegerType const>();
 	else
-		return make_shared<IntegerType>(
+		return TypePool::integer(
 			max(bytesRequired(value), 1u) * 8,
 			negative ? IntegerType::Modifier::Signed : IntegerType::Modifier::Unsigned
 		);
@@ -530,11 +817,11 @@ TypePointer StringLiteralType::mobileType() const
 	return make_shared<ArrayType>(DataLocation::Memory, true);
 }
 
-shared_ptr<FixedBytesType> FixedBytesType::smallestTypeForLiteral(string const& _literal)
+shared_ptr<FixedBytesType const> FixedBytesType::smallestTypeForLiteral(string const& _literal)
 {
 	if (_literal.length() <= 32)
-		return make_shared<FixedBytesType>(_literal.length());
-	return shared_ptr<FixedBytesType>();
+		return TypePool::fixedBytes(_literal.length());
+	return shared_ptr<FixedBytesType const>();
 }
 
 FixedBytesType::FixedBytesType(int _bytes): m_bytes(_bytes)
@@ -860,16 +1147,17 @@ string ArrayType::canonicalName(bool _addDataLocation) const
 
 MemberList const& ArrayType::members() const
 {
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
 	if (!m_members)
 	{
 		MemberList::MemberMap members;
 		if (!isString())
 		{
-			members.push_back({"length", make_shared<IntegerType>(256)});
+			members.push_back({"length", TypePool::integer(256)});
 			if (isDynamicallySized() && location() == DataLocation::Storage)
 				members.push_back({"push", make_shared<FunctionType>(
 					TypePointers{baseType()},
-					TypePointers{make_shared<IntegerType>(256)},
+					TypePointers{TypePool::integer(256)},
 					strings{string()},
 					strings{string()},
 					isByteArray() ? FunctionType::Location::ByteArrayPush : FunctionType::Location::ArrayPush
@@ -883,7 +1171,7 @@ MemberList const& ArrayType::members() const
 TypePointer ArrayType::encodingType() const
 {
 	if (location() == DataLocation::Storage)
-		return make_shared<IntegerType>(256);
+		return TypePool::integer(256);
 	else
 		return this->copyForLocation(DataLocation::Memory, true);
 }
@@ -891,7 +1179,7 @@ TypePointer ArrayType::encodingType() const
 TypePointer ArrayType::decodingType() const
 {
 	if (location() == DataLocation::Storage)
-		return make_shared<IntegerType>(256);
+		return TypePool::integer(256);
 	else
 		return shared_from_this();
 }
@@ -959,6 +1247,7 @@ string ContractType::canonicalName(bool) const
 MemberList const& ContractType::members() const
 {
 	// We need to lazy-initialize it because of recursive references.
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
 	if (!m_members)
 	{
 		// All address members and all interface functions
@@ -1009,6 +1298,7 @@ MemberList const& ContractType::members() const
 
 shared_ptr<FunctionType const> const& ContractType::constructorType() const
 {
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
 	if (!m_constructorType)
 	{
 		FunctionDefinition const* constructor = m_contract.constructor();
@@ -1031,7 +1321,7 @@ vector<tuple<VariableDeclaration const*, u256, unsigned>> ContractType::stateVar
 	for (auto variable: variables)
 		types.push_back(variable->annotation().type);
 	StorageOffsets offsets;
-	offsets.computeOffsets(types);
+	offsets.computeOffsets(types, StorageOffsets::layoutOptimization());
 
 	vector<tuple<VariableDeclaration const*, u256, unsigned>> variablesAndOffsets;
 	for (size_t index = 0; index < variables.size(); ++index)
@@ -1102,6 +1392,7 @@ string StructType::toString(bool _short) const
 MemberList const& StructType::members() const
 {
 	// We need to lazy-initialize it because of recursive references.
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
 	if (!m_members)
 	{
 		MemberList::MemberMap members;
@@ -1385,7 +1676,7 @@ FunctionType::FunctionType(VariableDeclaration const& _varDecl):
 				break;
 			returnType = arrayType->baseType();
 			paramNames.push_back("");
-			paramTypes.push_back(make_shared<IntegerType>(256));
+			paramTypes.push_back(TypePool::integer(256));
 		}
 		else
 			break;
@@ -1535,6 +1826,7 @@ FunctionTypePointer FunctionType::interfaceFunctionType() const
 
 MemberList const& FunctionType::members() const
 {
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
 	switch (m_location)
 	{
 	case Location::External:
@@ -1787,6 +2079,7 @@ unsigned TypeType::sizeOnStack() const
 MemberList const& TypeType::members() const
 {
 	// We need to lazy-initialize it because of recursive references.
+	lock_guard<recursive_mutex> guard(typeCacheMutex());
 	if (!m_members)
 	{
 		MemberList::MemberMap members;
@@ -1869,27 +2162,27 @@ MagicType::MagicType(MagicType::Kind _kind):
 	{
 	case Kind::Block:
 		m_members = MemberList({
-			{"coinbase", make_shared<IntegerType>(0, IntegerType::Modifier::Address)},
-			{"timestamp", make_shared<IntegerType>(256)},
+			{"coinbase", TypePool::integer(0, IntegerType::Modifier::Address)},
+			{"timestamp", TypePool::integer(256)},
 			{"blockhash", make_shared<FunctionType>(strings{"uint"}, strings{"bytes32"}, FunctionType::Location::BlockHash)},
-			{"difficulty", make_shared<IntegerType>(256)},
-			{"number", make_shared<IntegerType>(256)},
-			{"gaslimit", make_shared<IntegerType>(256)}
+			{"difficulty", TypePool::integer(256)},
+			{"number", TypePool::integer(256)},
+			{"gaslimit", TypePool::integer(256)}
 		});
 		break;
 	case Kind::Message:
 		m_members = MemberList({
-			{"sender", make_shared<IntegerType>(0, IntegerType::Modifier::Address)},
-			{"gas", make_shared<IntegerType>(256)},
-			{"value", make_shared<IntegerType>(256)},
+			{"sender", TypePool::integer(0, IntegerType::Modifier::Address)},
+			{"gas", TypePool::integer(256)},
+			{"value", TypePool::integer(256)},
 			{"data", make_shared<ArrayType>(DataLocation::CallData)},
-			{"sig", make_shared<FixedBytesType>(4)}
+			{"sig", TypePool::fixedBytes(4)}
 		});
 		break;
 	case Kind::Transaction:
 		m_members = MemberList({
-			{"origin", make_shared<IntegerType>(0, IntegerType::Modifier::Address)},
-			{"gasprice", make_shared<IntegerType>(256)}
+			{"origin", TypePool::integer(0, IntegerType::Modifier::Address)},
+			{"gasprice", TypePool::integer(256)}
 		});
 		break;
 	default:
@@ -23,8 +23,10 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <boost/noncopyable.hpp>
 #include <libdevcore/Common.h>
 #include <libsolidity/Exceptions.h>
@@ -43,6 +45,12 @@ using TypePointer = std::shared_ptr<Type const>;
 using FunctionTypePointer = std::shared_ptr<FunctionType const>;
 using TypePointers = std::vector<TypePointer>;
 
+/// @returns the mutex guarding all lazily initialized type information (member lists,
+/// storage offsets, constructor types, interface function lists). Contracts are type
+/// checked concurrently and may trigger the same initialization from several threads;
+/// the mutex is recursive because building one cache can require another one.
+std::recursive_mutex& typeCacheMutex();
+
 
 enum class DataLocation { Storage, CallData, Memory };
 
@@ -53,13 +61,22 @@ class StorageOffsets
 {
 public:
 	/// Resets the StorageOffsets objects and determines the position in storage for each
-	/// of the elements of @a _types.
-	void computeOffsets(TypePointers const& _types);
+	/// of the elements of @a _types. If @a _optimizeLayout is set, slots are assigned in
+	/// size-sorted instead of declaration order so that small members share slots; the
+	/// returned offsets are still keyed by the original indices.
+	void computeOffsets(TypePointers const& _types, bool _optimizeLayout = false);
 	/// @returns the offset of the given member, might be null if the member is not part of storage.
 	std::pair<u256, unsigned> const* offset(size_t _index) const;
 	/// @returns the total number of slots occupied by all members.
 	u256 const& storageSize() const { return m_storageSize; }
 
+	/// Globally enables or disables layout optimization for all offsets computed from
+	/// cached member lists. Opt-in and off by default since it changes the storage
+	/// layout; must be set before parsing, while no layouts are cached yet.
+	static void setLayoutOptimization(bool _enabled);
+	/// @returns whether layout optimization is currently enabled.
+	static bool layoutOptimization();
+
 private:
 	u256 m_storageSize;
 	std::map<size_t, std::pair<u256, unsigned>> m_offsets;
@@ -90,25 +107,8 @@ public:
 	MemberList() {}
 	explicit MemberList(MemberMap const& _members): m_memberTypes(_members) {}
 	MemberList& operator=(MemberList&& _other);
-	TypePointer memberType(std::string const& _name) const
-	{
-		TypePointer type;
-		for (auto const& it: m_memberTypes)
-			if (it.name == _name)
-			{
-				solAssert(!type, "Requested member type by non-unique name.");
-				type = it.type;
-			}
-		return type;
-	}
-	MemberMap membersByName(std::string const& _name) const
-	{
-		MemberMap members;
-		for (auto const& it: m_memberTypes)
-			if (it.name == _name)
-				members.push_back(it);
-		return members;
-	}
+	TypePointer memberType(std::string const& _name) const;
+	MemberMap membersByName(std::string const& _name) const;
 	/// @returns the offset of the given member in storage slots and bytes inside a slot or
 	/// a nullptr if the member is not part of storage.
 	std::pair<u256, unsigned> const* memberStorageOffset(std::string const& _name) const;
@@ -119,8 +119,14 @@ public:
 	MemberMap::const_iterator end() const { return m_memberTypes.end(); }
 
 private:
+	/// @returns the lazily built index from member name to the positions of the
+	/// members with that name in m_memberTypes (which stays ordered for
+	/// layout-sensitive consumers like StorageOffsets).
+	std::unordered_map<std::string, std::vector<size_t>> const& nameIndex() const;
+
 	MemberMap m_memberTypes;
 	mutable std::unique_ptr<StorageOffsets> m_storageOffsets;
+	mutable std::unique_ptr<std::unordered_map<std::string, std::vector<size_t>>> m_nameIndex;
 };
 
 /**
@@ -155,7 +161,9 @@ public:
 	/// Calculates the
 
 	virtual Category category() const = 0;
-	virtual bool isImplicitlyConvertibleTo(Type const& _other) const { return *this == _other; }
+	/// Pooled types (see @ref TypePool) are shared instances, so identical pointers
+	/// prove convertibility without a structural comparison.
+	virtual bool isImplicitlyConvertibleTo(Type const& _other) const { return &_other == this || *this == _other; }
 	virtual bool isExplicitlyConvertibleTo(Type const& _convertTo) const
 	{
 		return isImplicitlyConvertibleTo(_convertTo);
@@ -310,7 +318,7 @@ public:
 	static bool isValidLiteral(Literal const& _literal);
 
 	explicit IntegerConstantType(Literal const& _literal);
-	explicit IntegerConstantType(bigint _value): m_value(_value) {}
+	explicit IntegerConstantType(bigint _value): m_value(_value) { cacheSmallValue(); }
 
 	virtual bool isImplicitlyConvertibleTo(Type const& _convertTo) const override;
 	virtual bool isExplicitlyConvertibleTo(Type const& _convertTo) const override;
@@ -329,8 +337,17 @@ public:
 	/// @returns the smallest integer type that can hold the value or an empty pointer if not possible.
 	std::shared_ptr<IntegerType const> integerType() const;
 
+	bigint const& value() const { return m_value; }
+
 private:
+	/// Stores the value in m_smallValue as well if it fits into 64 bits, enabling
+	/// native arithmetic in binaryOperatorResult for the typical small literals.
+	void cacheSmallValue();
+
 	bigint m_value;
+	/// Native copy of m_value, valid iff m_isSmall is set.
+	int64_t m_smallValue = 0;
+	bool m_isSmall = false;
 };
 
 /**
@@ -374,7 +391,7 @@ public:
 
 	/// @returns the smallest bytes type for the given literal or an empty pointer
 	/// if no type fits.
-	static std::shared_ptr<FixedBytesType> smallestTypeForLiteral(std::string const& _literal);
+	static std::shared_ptr<FixedBytesType const> smallestTypeForLiteral(std::string const& _literal);
 
 	explicit FixedBytesType(int _bytes);
 
@@ -420,6 +437,41 @@ public:
 	virtual TypePointer interfaceType(bool) const override { return shared_from_this(); }
 };
 
+/**
+ * Process-wide pool of canonical value type instances. Structurally identical
+ * integers, fixed bytes and booleans are represented by a single shared
+ * instance each, so the repeated constructions during type checking become
+ * lookups and equality of pooled types holds by pointer identity.
+ */
+class TypePool
+{
+public:
+	/// @returns the canonical instance of the integer type with the given bit width and modifier.
+	static std::shared_ptr<IntegerType const> integer(int _bits, IntegerType::Modifier _modifier = IntegerType::Modifier::Unsigned);
+	/// @returns the canonical instance of the fixed bytes type of the given length.
+	static std::shared_ptr<FixedBytesType const> fixedBytes(int _bytes);
+	/// @returns the canonical boolean type instance.
+	static std::shared_ptr<BoolType const> boolean();
+
+	/// Sizes of the process-wide type caches, see CompilerStack::memoryAccounting().
+	struct Statistics
+	{
+		size_t integerTypes = 0;
+		size_t fixedBytesTypes = 0;
+		size_t binaryOperatorResults = 0;
+	};
+	/// @returns the current sizes of the type pools and the binary operator
+	/// result cache.
+	static Statistics statistics();
+};
+
+/// Memoized wrapper around Type::binaryOperatorResult. Results are cached per
+/// (operator, left type instance, right type instance) triple, so with pooled
+/// operand types (see @ref TypePool) the recurring operator typings of
+/// arithmetic-heavy code become a single hash lookup. The cache keeps the
+/// operand types alive, which makes keying by instance safe.
+TypePointer memoizedBinaryOperatorResult(Token::Value _operator, TypePointer const& _left, TypePointer const& _right);
+
 /**
  * Base class used by types which are not value types and can be stored either in storage, memory
  * or calldata. This is currently used by arrays and structs.
@@ -485,7 +537,7 @@ public:
 	explicit ArrayType(DataLocation _location, bool _isString = false):
 		ReferenceType(_location),
 		m_arrayKind(_isString ? ArrayKind::String : ArrayKind::Bytes),
-		m_baseType(std::make_shared<FixedBytesType>(1))
+		m_baseType(TypePool::fixedBytes(1))
 	{
 	}
 	/// Constructor for a dynamically sized array type ("type[]")
@@ -568,7 +620,7 @@ public:
 	virtual MemberList const& members() const override;
 	virtual TypePointer encodingType() const override
 	{
-		return std::make_shared<IntegerType>(160, IntegerType::Modifier::Address);
+		return TypePool::integer(160, IntegerType::Modifier::Address);
 	}
 	virtual TypePointer interfaceType(bool _inLibrary) const override
 	{
@@ -621,7 +673,7 @@ public:
 	virtual MemberList const& members() const override;
 	virtual TypePointer encodingType() const override
 	{
-		return location() == DataLocation::Storage ? std::make_shared<IntegerType>(256) : TypePointer();
+		return location() == DataLocation::Storage ? TypePool::integer(256) : TypePointer();
 	}
 	virtual TypePointer interfaceType(bool _inLibrary) const override;
 
@@ -670,7 +722,7 @@ public:
 	virtual bool isExplicitlyConvertibleTo(Type const& _convertTo) const override;
 	virtual TypePointer encodingType() const override
 	{
-		return std::make_shared<IntegerType>(8 * int(storageBytes()));
+		return TypePool::integer(8 * int(storageBytes()));
 	}
 	virtual TypePointer interfaceType(bool _inLibrary) const override
 	{
@@ -893,7 +945,7 @@ public:
 	virtual bool canLiveOutsideStorage() const override { return false; }
 	virtual TypePointer encodingType() const override
 	{
-		return std::make_shared<IntegerType>(256);
+		return TypePool::integer(256);
 	}
 	virtual TypePointer interfaceType(bool _inLibrary) const override
 	{
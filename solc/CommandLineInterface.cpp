@@ -22,13 +22,25 @@
  */
 #include "CommandLineInterface.h"
 
+#include <algorithm>
+#include <atomic>
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <thread>
+#include <chrono>
+#include <cstring>
+#include <ctime>
 
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include "solidity/BuildInfo.h"
 #include <libdevcore/Common.h>
 #include <libdevcore/CommonData.h>
@@ -40,6 +52,7 @@
 #include <libsolidity/Parser.h>
 #include <libsolidity/ASTPrinter.h>
 #include <libsolidity/ASTJsonConverter.h>
+#include <libsolidity/ASTVisitor.h>
 #include <libsolidity/NameAndTypeResolver.h>
 #include <libsolidity/Exceptions.h>
 #include <libsolidity/CompilerStack.h>
@@ -55,9 +68,11 @@ namespace solidity
 {
 
 static string const g_argAbiStr = "abi";
+static string const g_argAbiBinStr = "abi-bin";
 static string const g_argSolInterfaceStr = "interface";
 static string const g_argSignatureHashes = "hashes";
 static string const g_argGas = "gas";
+static string const g_argGasProfile = "gas-profile";
 static string const g_argAsmStr = "asm";
 static string const g_argAsmJsonStr = "asm-json";
 static string const g_argAstStr = "ast";
@@ -69,6 +84,11 @@ static string const g_argOpcodesStr = "opcodes";
 static string const g_argNatspecDevStr = "devdoc";
 static string const g_argNatspecUserStr = "userdoc";
 static string const g_argAddStandard = "add-std";
+static string const g_argDaemon = "daemon";
+static string const g_argWatch = "watch";
+static string const g_argOutputArchive = "output-archive";
+static string const g_argTimings = "timings";
+static string const g_argMemoryStats = "memory-stats";
 static string const g_stdinFileName = "<stdin>";
 
 /// Possible arguments to for --combined-json
@@ -106,7 +126,9 @@ static bool needsHumanTargetedStdout(po::variables_map const& _args)
 
 	return
 		_args.count(g_argGas) ||
+		_args.count(g_argGasProfile) ||
 		humanTargetedStdout(_args, g_argAbiStr) ||
+		humanTargetedStdout(_args, g_argAbiBinStr) ||
 		humanTargetedStdout(_args, g_argSolInterfaceStr) ||
 		humanTargetedStdout(_args, g_argSignatureHashes) ||
 		humanTargetedStdout(_args, g_argNatspecUserStr) ||
@@ -195,6 +217,7 @@ void CommandLineInterface::handleMeta(DocumentationType _type, string const& _co
 	std::string argName;
 	std::string suffix;
 	std::string title;
+	bool binary = false;
 	switch(_type)
 	{
 	case DocumentationType::ABIInterface:
@@ -202,6 +225,12 @@ void CommandLineInterface::handleMeta(DocumentationType _type, string const& _co
 		suffix = ".abi";
 		title = "Contract JSON ABI";
 		break;
+	case DocumentationType::ABIBinary:
+		argName = g_argAbiBinStr;
+		suffix = ".abi.bin";
+		title = "Contract binary ABI";
+		binary = true;
+		break;
 	case DocumentationType::ABISolidityInterface:
 		argName = g_argSolInterfaceStr;
 		suffix = "_interface.sol";
@@ -229,7 +258,11 @@ void CommandLineInterface::handleMeta(DocumentationType _type, string const& _co
 		else
 		{
 			cout << title << endl;
-			cout << m_compiler->metadata(_contract, _type) << endl;
+			if (binary)
+				// raw bytes are unsuitable for the terminal
+				cout << toHex(asBytes(m_compiler->metadata(_contract, _type))) << endl;
+			else
+				cout << m_compiler->metadata(_contract, _type) << endl;
 		}
 
 	}
@@ -237,18 +270,23 @@ void CommandLineInterface::handleMeta(DocumentationType _type, string const& _co
 
 void CommandLineInterface::handleGasEstimation(string const& _contract)
 {
-	using Gas = GasEstimator::GasConsumption;
 	if (!m_compiler->assemblyItems(_contract) && !m_compiler->runtimeAssemblyItems(_contract))
 		return;
+	// Appended whenever the estimator ran out of path budget, i.e. the printed
+	// value only bounds the worst case from below.
+	auto lowerBoundNote = [](GasEstimator::FunctionalGasEstimation const& _estimate)
+	{
+		return _estimate.isLowerBound ? " (lower bound)" : "";
+	};
 	cout << "Gas estimation:" << endl;
 	if (eth::AssemblyItems const* items = m_compiler->assemblyItems(_contract))
 	{
-		Gas gas = GasEstimator::functionalEstimation(*items);
+		GasEstimator::FunctionalGasEstimation estimate = GasEstimator::boundedFunctionalEstimation(*items);
 		u256 bytecodeSize(m_compiler->runtimeObject(_contract).bytecode.size());
 		cout << "construction:" << endl;
-		cout << "   " << gas << " + " << (bytecodeSize * eth::c_createDataGas) << " = ";
-		gas += bytecodeSize * eth::c_createDataGas;
-		cout << gas << endl;
+		cout << "   " << estimate.gas << " + " << (bytecodeSize * eth::c_createDataGas) << " = ";
+		estimate.gas += bytecodeSize * eth::c_createDataGas;
+		cout << estimate.gas << lowerBoundNote(estimate) << endl;
 	}
 	if (eth::AssemblyItems const* items = m_compiler->runtimeAssemblyItems(_contract))
 	{
@@ -257,13 +295,13 @@ void CommandLineInterface::handleGasEstimation(string const& _contract)
 		for (auto it: contract.interfaceFunctions())
 		{
 			string sig = it.second->externalSignature();
-			GasEstimator::GasConsumption gas = GasEstimator::functionalEstimation(*items, sig);
-			cout << "   " << sig << ":\t" << gas << endl;
+			GasEstimator::FunctionalGasEstimation estimate = GasEstimator::boundedFunctionalEstimation(*items, sig);
+			cout << "   " << sig << ":\t" << estimate.gas << lowerBoundNote(estimate) << endl;
 		}
 		if (contract.fallbackFunction())
 		{
-			GasEstimator::GasConsumption gas = GasEstimator::functionalEstimation(*items, "INVALID");
-			cout << "   fallback:\t" << gas << endl;
+			GasEstimator::FunctionalGasEstimation estimate = GasEstimator::boundedFunctionalEstimation(*items, "INVALID");
+			cout << "   fallback:\t" << estimate.gas << lowerBoundNote(estimate) << endl;
 		}
 		cout << "internal:" << endl;
 		for (auto const& it: contract.definedFunctions())
@@ -271,16 +309,151 @@ void CommandLineInterface::handleGasEstimation(string const& _contract)
 			if (it->isPartOfExternalInterface() || it->isConstructor())
 				continue;
 			size_t entry = m_compiler->functionEntryPoint(_contract, *it);
-			GasEstimator::GasConsumption gas = GasEstimator::GasConsumption::infinite();
+			GasEstimator::FunctionalGasEstimation estimate;
+			estimate.gas = GasEstimator::GasConsumption::infinite();
 			if (entry > 0)
-				gas = GasEstimator::functionalEstimation(*items, entry, *it);
+				estimate = GasEstimator::boundedFunctionalEstimation(*items, entry, *it);
 			FunctionType type(*it);
 			cout << "   " << it->name() << "(";
 			auto end = type.parameterTypes().end();
 			for (auto it = type.parameterTypes().begin(); it != end; ++it)
 				cout << (*it)->toString() << (it + 1 == end ? "" : ",");
-			cout << "):\t" << gas << endl;
+			cout << "):\t" << estimate.gas << lowerBoundNote(estimate) << endl;
+		}
+	}
+}
+
+void CommandLineInterface::handleGasProfile(string const& _contract)
+{
+	if (!m_args.count(g_argGasProfile))
+		return;
+	if (!m_compiler->runtimeAssemblyItems(_contract))
+		return;
+
+	vector<ASTNode const*> asts;
+	for (auto const& sourceCode: sourceCodes())
+		asts.push_back(&m_compiler->ast(sourceCode.first));
+	GasEstimator::ASTGasConsumption gasCosts = GasEstimator::breakToStatementLevel(
+		GasEstimator::structuralEstimation(*m_compiler->runtimeAssemblyItems(_contract), asts),
+		asts
+	);
+
+	// Attribute each profiled statement to its enclosing function or modifier and
+	// accumulate per-function totals for the percentage column.
+	struct HotSpot
+	{
+		ASTNode const* node;
+		string function;
+		GasEstimator::GasConsumption gas;
+	};
+	vector<HotSpot> hotSpots;
+	map<string, u256> functionTotals;
+	vector<string> functionStack;
+	SimpleASTVisitor collector(
+		[&](ASTNode const& _node)
+		{
+			if (auto function = dynamic_cast<FunctionDefinition const*>(&_node))
+				functionStack.push_back(function->name());
+			else if (auto modifier = dynamic_cast<ModifierDefinition const*>(&_node))
+				functionStack.push_back(modifier->name());
+			if (gasCosts.count(&_node))
+			{
+				HotSpot spot;
+				spot.node = &_node;
+				spot.function = functionStack.empty() ? string() : functionStack.back();
+				spot.gas = gasCosts.at(&_node);
+				hotSpots.push_back(spot);
+				if (!spot.gas.isInfinite)
+					functionTotals[spot.function] += spot.gas.value;
+			}
+			return true;
+		},
+		[&](ASTNode const& _node)
+		{
+			if (dynamic_cast<FunctionDefinition const*>(&_node) || dynamic_cast<ModifierDefinition const*>(&_node))
+				functionStack.pop_back();
+		}
+	);
+	for (ASTNode const* ast: asts)
+		ast->accept(collector);
+
+	// Unbounded consumptions first, then descending by estimated gas.
+	sort(hotSpots.begin(), hotSpots.end(), [](HotSpot const& _a, HotSpot const& _b)
+	{
+		if (_a.gas.isInfinite != _b.gas.isInfinite)
+			return _a.gas.isInfinite;
+		return _a.gas.value > _b.gas.value;
+	});
+
+	auto locationString = [&](SourceLocation const& _location) -> string
+	{
+		if (!_location.sourceName)
+			return string();
+		int line = -1;
+		int column = -1;
+		tie(line, column) = m_compiler->scanner(*_location.sourceName).translatePositionToLineColumn(_location.start);
+		ostringstream str;
+		str << *_location.sourceName << ":" << (line + 1) << ":" << (column + 1);
+		return str.str();
+	};
+	auto excerpt = [&](SourceLocation const& _location) -> string
+	{
+		if (!_location.sourceName || _location.start < 0 || _location.end < _location.start)
+			return string();
+		auto source = m_sourceCodes.find(*_location.sourceName);
+		if (source == m_sourceCodes.end() || _location.end > int(source->second.size()))
+			return string();
+		string text = source->second.substr(_location.start, _location.end - _location.start);
+		for (char& c: text)
+			if (c == '\n' || c == '\r' || c == '\t')
+				c = ' ';
+		if (text.size() > 40)
+			text = text.substr(0, 37) + "...";
+		return text;
+	};
+	auto percentString = [&](HotSpot const& _spot) -> string
+	{
+		if (_spot.gas.isInfinite)
+			return "-";
+		u256 total = functionTotals[_spot.function];
+		if (total == 0)
+			return "-";
+		u256 permille = _spot.gas.value * 1000 / total;
+		ostringstream str;
+		str << (permille / 10) << "." << (permille % 10) << "%";
+		return str.str();
+	};
+
+	if (m_args.count("output-dir"))
+	{
+		Json::Value profile(Json::objectValue);
+		Json::Value spots(Json::arrayValue);
+		for (HotSpot const& spot: hotSpots)
+		{
+			Json::Value entry(Json::objectValue);
+			ostringstream gasStr;
+			gasStr << spot.gas;
+			entry["gas"] = gasStr.str();
+			entry["percentOfFunction"] = percentString(spot);
+			entry["function"] = spot.function;
+			entry["location"] = locationString(spot.node->location());
+			entry["code"] = excerpt(spot.node->location());
+			spots.append(entry);
 		}
+		profile["hotSpots"] = spots;
+		createFile(_contract + "_gas_profile.json", Json::FastWriter().write(profile));
+	}
+	else
+	{
+		cout << "Gas hot spots:" << endl;
+		cout << "   gas\tpercent\tfunction\tlocation\tcode" << endl;
+		for (HotSpot const& spot: hotSpots)
+			cout <<
+				"   " << spot.gas <<
+				"\t" << percentString(spot) <<
+				"\t" << spot.function <<
+				"\t" << locationString(spot.node->location()) <<
+				"\t" << excerpt(spot.node->location()) << endl;
 	}
 }
 
@@ -317,17 +490,97 @@ bool CommandLineInterface::parseLibraryOption(string const& _input)
 	return true;
 }
 
+CommandLineInterface::~CommandLineInterface()
+{
+#ifndef _WIN32
+	for (auto const& mapped: m_mappedSources)
+		if (mapped.second.first)
+			munmap(const_cast<char*>(mapped.second.first), mapped.second.second);
+#endif
+}
+
+map<string, string> const& CommandLineInterface::sourceCodes()
+{
+	for (auto const& mapped: m_mappedSources)
+		if (!m_sourceCodes.count(mapped.first))
+			m_sourceCodes[mapped.first] = string(mapped.second.first, mapped.second.second);
+	return m_sourceCodes;
+}
+
 void CommandLineInterface::createFile(string const& _fileName, string const& _data)
 {
+	// Only buffers the artifact; writeOutputFiles() flushes all of them in one
+	// batch at the end of the run, so slow (e.g. network) filesystems see a few
+	// large parallel writes instead of many small synchronous ones.
+	m_bufferedOutputs[_fileName] = _data;
+}
+
+void CommandLineInterface::writeOutputFiles()
+{
+	if (m_bufferedOutputs.empty())
+		return;
 	namespace fs = boost::filesystem;
 	// create directory if not existent
 	fs::path p(m_args.at("output-dir").as<string>());
 	fs::create_directories(p);
-	string pathName = (p / _fileName).string();
-	ofstream outFile(pathName);
-	outFile << _data;
-	if (!outFile)
-		BOOST_THROW_EXCEPTION(FileError() << errinfo_comment("Could not write to file: " + pathName));
+
+	// Leave up-to-date outputs untouched so tools watching them only see real changes.
+	auto writeUnlessUnchanged = [&](string const& _pathName, string const& _data)
+	{
+		if (fs::exists(_pathName) && dev::contentsString(_pathName) == _data)
+			return;
+		ofstream outFile(_pathName);
+		outFile << _data;
+		if (!outFile)
+			BOOST_THROW_EXCEPTION(FileError() << errinfo_comment("Could not write to file: " + _pathName));
+	};
+
+	if (m_args.count(g_argOutputArchive))
+	{
+		// A single manifest file keeps the whole build to one write.
+		Json::Value manifest(Json::objectValue);
+		for (auto const& output: m_bufferedOutputs)
+			manifest[output.first] = output.second;
+		writeUnlessUnchanged((p / "artifacts.json").string(), Json::FastWriter().write(manifest));
+		m_bufferedOutputs.clear();
+		return;
+	}
+
+	vector<pair<string, string>> outputs(m_bufferedOutputs.begin(), m_bufferedOutputs.end());
+	size_t threadCount = min(outputs.size(), size_t(max(1u, thread::hardware_concurrency())));
+	if (threadCount <= 1)
+	{
+		for (auto const& output: outputs)
+			writeUnlessUnchanged((p / output.first).string(), output.second);
+		m_bufferedOutputs.clear();
+		return;
+	}
+
+	// Flush in parallel so the per-file latency of the filesystem overlaps.
+	atomic<size_t> next(0);
+	vector<exception_ptr> workerErrors(threadCount);
+	auto work = [&](size_t _worker)
+	{
+		try
+		{
+			for (size_t i = next++; i < outputs.size(); i = next++)
+				writeUnlessUnchanged((p / outputs[i].first).string(), outputs[i].second);
+		}
+		catch (...)
+		{
+			workerErrors[_worker] = current_exception();
+		}
+	};
+	vector<thread> workers;
+	for (size_t t = 1; t < threadCount; ++t)
+		workers.emplace_back(work, t);
+	work(0);
+	for (thread& worker: workers)
+		worker.join();
+	for (exception_ptr const& error: workerErrors)
+		if (error)
+			rethrow_exception(error);
+	m_bufferedOutputs.clear();
 }
 
 bool CommandLineInterface::parseArguments(int _argc, char** _argv)
@@ -366,16 +619,41 @@ Allowed options)",
 			po::value<string>()->value_name("path"),
 			"If given, creates one file per component and contract/file at the specified directory."
 		)
+		(
+			g_argOutputArchive.c_str(),
+			"Write all artifacts into a single artifacts.json manifest in the output "
+			"directory instead of one file per artifact."
+		)
 		(
 			"combined-json",
 			po::value<string>()->value_name(boost::join(g_combinedJsonArgs, ",")),
 			"Output a single json document containing the specified information."
 		)
 		(g_argGas.c_str(), "Print an estimate of the maximal gas usage for each function.")
+		(
+			g_argGasProfile.c_str(),
+			"Print a statement-level gas hot-spot profile for each contract, "
+			"sorted by estimated gas consumption."
+		)
+		(g_argTimings.c_str(), "Print wall and CPU time per compilation phase as JSON.")
+		(g_argMemoryStats.c_str(), "Print AST, type cache and assembly memory figures as JSON.")
 		(
 			"link",
 			"Switch to linker mode, ignoring all options apart from --libraries "
 			"and modify binaries in place."
+		)
+		(
+			g_argDaemon.c_str(),
+			"Run as a long-lived compile server: reads one JSON job per line "
+			"({\"sources\":{<name>:<content>},\"optimize\":<bool>}) from standard input "
+			"and writes one JSON result per line, reusing the warm compiler state "
+			"across jobs."
+		)
+		(
+			g_argWatch.c_str(),
+			"Stay running after the initial build, recompile whenever an input file "
+			"changes and rewrite only the output files whose content changed. "
+			"Requires input files and --output-dir."
 		);
 	po::options_description outputComponents("Output Components");
 	outputComponents.add_options()
@@ -388,6 +666,7 @@ Allowed options)",
 		(g_argRuntimeBinaryStr.c_str(), "Binary of the runtime part of the contracts in hex.")
 		(g_argCloneBinaryStr.c_str(), "Binary of the clone contracts in hex.")
 		(g_argAbiStr.c_str(), "ABI specification of the contracts.")
+		(g_argAbiBinStr.c_str(), "Compact binary ABI descriptor of the contracts.")
 		(g_argSolInterfaceStr.c_str(), "Solidity interface of the contracts.")
 		(g_argSignatureHashes.c_str(), "Function signature hashes of the contracts.")
 		(g_argNatspecUserStr.c_str(), "Natspec user documentation of all contracts.")
@@ -443,8 +722,17 @@ Allowed options)",
 
 bool CommandLineInterface::processInput()
 {
+	// Daemon jobs arrive over standard input later; nothing to read or compile here.
+	if (m_args.count(g_argDaemon))
+		return true;
+
 	if (!m_args.count("input-file"))
 	{
+		if (m_args.count(g_argWatch))
+		{
+			cerr << "--watch requires input files." << endl;
+			return false;
+		}
 		string s;
 		while (!cin.eof())
 		{
@@ -468,6 +756,32 @@ bool CommandLineInterface::processInput()
 				continue;
 			}
 
+			// In linker mode the binaries are patched in place by link();
+			// nothing has to be read here.
+			if (m_args.count("link"))
+				continue;
+#ifndef _WIN32
+			// Map regular files read-only so the scanner works directly on the
+			// page cache and the source bytes are never copied. Watch mode
+			// rereads files on change, so it keeps using string copies.
+			if (!m_args.count(g_argWatch))
+			{
+				// Empty files cannot be mapped and are registered as empty
+				// string sources through the fallback below.
+				size_t size = boost::filesystem::file_size(path);
+				int fd = size > 0 ? open(infile.c_str(), O_RDONLY) : -1;
+				if (fd >= 0)
+				{
+					void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+					close(fd);
+					if (data != MAP_FAILED)
+					{
+						m_mappedSources[infile] = make_pair(static_cast<char const*>(data), size);
+						continue;
+					}
+				}
+			}
+#endif
 			m_sourceCodes[infile] = dev::contentsString(infile);
 		}
 
@@ -483,15 +797,44 @@ bool CommandLineInterface::processInput()
 		return link();
 	}
 
-	m_compiler.reset(new CompilerStack(m_args.count(g_argAddStandard) > 0));
+	return compileSources();
+}
+
+bool CommandLineInterface::compileSources()
+{
+	if (!m_compiler)
+		m_compiler.reset(new CompilerStack(m_args.count(g_argAddStandard) > 0));
+	else
+		// Keep the cached ASTs so that unchanged sources are not reparsed.
+		m_compiler->reset(true);
 	try
 	{
 		for (auto const& sourceCode: m_sourceCodes)
 			m_compiler->addSource(sourceCode.first, sourceCode.second);
-		// TODO: Perhaps we should not compile unless requested
+		for (auto const& mapped: m_mappedSources)
+			m_compiler->addSource(mapped.first, mapped.second.first, mapped.second.second);
 		bool optimize = m_args.count("optimize") > 0;
 		unsigned runs = m_args["optimize-runs"].as<unsigned>();
-		bool successful = m_compiler->compile(optimize, runs);
+		// Interface-only invocations (e.g. --abi --userdoc) stop after the
+		// semantic checks; code generation only runs if a requested output
+		// needs bytecode or assembly.
+		set<string> combinedRequests;
+		if (m_args.count("combined-json"))
+			boost::split(combinedRequests, m_args["combined-json"].as<string>(), boost::is_any_of(","));
+		bool needsBytecode =
+			m_args.count(g_argBinaryStr) || combinedRequests.count("bin") ||
+			m_args.count(g_argRuntimeBinaryStr) || combinedRequests.count("bin-runtime") ||
+			m_args.count(g_argCloneBinaryStr) || combinedRequests.count("clone-bin") ||
+			m_args.count(g_argOpcodesStr) || combinedRequests.count("opcodes") ||
+			m_args.count(g_argAsmStr) || combinedRequests.count("asm") ||
+			m_args.count(g_argAsmJsonStr) ||
+			m_args.count(g_argGas) ||
+			m_args.count(g_argGasProfile) ||
+			// the pretty-printed AST annotates statements with gas estimates
+			m_args.count(g_argAstStr);
+		bool successful = needsBytecode ?
+			m_compiler->compile(optimize, runs) :
+			m_compiler->typeCheck();
 		for (auto const& error: m_compiler->errors())
 			SourceReferenceFormatter::printExceptionInformation(
 				cerr,
@@ -500,7 +843,8 @@ bool CommandLineInterface::processInput()
 			);
 		if (!successful)
 			return false;
-		m_compiler->link(m_libraries);
+		if (needsBytecode)
+			m_compiler->link(m_libraries);
 	}
 	catch (CompilerError const& _exception)
 	{
@@ -541,53 +885,108 @@ void CommandLineInterface::handleCombinedJSON()
 	if (!m_args.count("combined-json"))
 		return;
 
-	Json::Value output(Json::objectValue);
-
-	output["version"] = ::dev::solidity::VersionString;
 	set<string> requests;
 	boost::split(requests, m_args["combined-json"].as<string>(), boost::is_any_of(","));
 	vector<string> contracts = m_compiler->contractNames();
 
+	// The document is streamed section by section, so peak memory is bounded by a
+	// single contract's artifacts instead of the whole project's output.
+	Json::FastWriter writer;
+	auto writeValue = [&](Json::Value const& _value)
+	{
+		string json = writer.write(_value);
+		// FastWriter terminates each document with a newline
+		if (!json.empty() && json[json.size() - 1] == '\n')
+			json.resize(json.size() - 1);
+		cout << json;
+	};
+
+	cout << "{\"version\": " << Json::valueToQuotedString(::dev::solidity::VersionString.c_str());
+
 	if (!contracts.empty())
-		output["contracts"] = Json::Value(Json::objectValue);
-	for (string const& contractName: contracts)
-	{
-		Json::Value contractData(Json::objectValue);
-		if (requests.count("interface"))
-			contractData["interface"] = m_compiler->solidityInterface(contractName);
-		if (requests.count("abi"))
-			contractData["abi"] = m_compiler->interface(contractName);
-		if (requests.count("bin"))
-			contractData["bin"] = m_compiler->object(contractName).toHex();
-		if (requests.count("bin-runtime"))
-			contractData["bin-runtime"] = m_compiler->runtimeObject(contractName).toHex();
-		if (requests.count("clone-bin"))
-			contractData["clone-bin"] = m_compiler->cloneObject(contractName).toHex();
-		if (requests.count("opcodes"))
-			contractData["opcodes"] = eth::disassemble(m_compiler->object(contractName).bytecode);
-		if (requests.count("asm"))
+	{
+		cout << ", \"contracts\": {";
+		bool firstContract = true;
+		for (string const& contractName: contracts)
 		{
-			ostringstream unused;
-			contractData["asm"] = m_compiler->streamAssembly(unused, contractName, m_sourceCodes, true);
+			cout << (firstContract ? "" : ", ");
+			firstContract = false;
+			cout << Json::valueToQuotedString(contractName.c_str()) << ": {";
+			bool firstEntry = true;
+			auto writeEntry = [&](string const& _name, Json::Value const& _value)
+			{
+				cout << (firstEntry ? "" : ", ") << Json::valueToQuotedString(_name.c_str()) << ": ";
+				firstEntry = false;
+				writeValue(_value);
+			};
+			if (requests.count("interface"))
+				writeEntry("interface", m_compiler->solidityInterface(contractName));
+			if (requests.count("abi"))
+				writeEntry("abi", m_compiler->interface(contractName));
+			if (requests.count("bin"))
+				writeEntry("bin", m_compiler->object(contractName).toHex());
+			if (requests.count("bin-runtime"))
+				writeEntry("bin-runtime", m_compiler->runtimeObject(contractName).toHex());
+			if (requests.count("clone-bin"))
+				writeEntry("clone-bin", m_compiler->cloneObject(contractName).toHex());
+			if (requests.count("opcodes"))
+				writeEntry("opcodes", eth::disassemble(m_compiler->object(contractName).bytecode));
+			if (requests.count("asm"))
+			{
+				ostringstream unused;
+				writeEntry("asm", m_compiler->streamAssembly(unused, contractName, sourceCodes(), true));
+			}
+			if (requests.count("devdoc"))
+				writeEntry("devdoc", m_compiler->metadata(contractName, DocumentationType::NatspecDev));
+			if (requests.count("userdoc"))
+				writeEntry("userdoc", m_compiler->metadata(contractName, DocumentationType::NatspecUser));
+			cout << "}";
 		}
-		if (requests.count("devdoc"))
-			contractData["devdoc"] = m_compiler->metadata(contractName, DocumentationType::NatspecDev);
-		if (requests.count("userdoc"))
-			contractData["userdoc"] = m_compiler->metadata(contractName, DocumentationType::NatspecUser);
-		output["contracts"][contractName] = contractData;
+		cout << "}";
 	}
 
 	if (requests.count("ast"))
 	{
-		output["sources"] = Json::Value(Json::objectValue);
-		for (auto const& sourceCode: m_sourceCodes)
+		vector<string> sourceList;
+		for (auto const& sourceCode: sourceCodes())
+			sourceList.push_back(sourceCode.first);
+		cout << ", \"sources\": {";
+		bool firstSource = true;
+		for (auto const& sourceCode: sourceCodes())
 		{
-			ASTJsonConverter converter(m_compiler->ast(sourceCode.first));
-			output["sources"][sourceCode.first] = Json::Value(Json::objectValue);
-			output["sources"][sourceCode.first]["AST"] = converter.json();
+			cout << (firstSource ? "" : ", ");
+			firstSource = false;
+			cout << Json::valueToQuotedString(sourceCode.first.c_str()) << ": {\"AST\": ";
+			ASTJsonConverter converter(m_compiler->ast(sourceCode.first), sourceList);
+			converter.print(cout);
+			cout << "}";
 		}
+		cout << "}";
 	}
-	cout << Json::FastWriter().write(output) << endl;
+
+	cout << "}" << endl;
+}
+
+void CommandLineInterface::handleTimings()
+{
+	if (!m_args.count(g_argTimings))
+		return;
+	string json = Json::FastWriter().write(m_compiler->timings().toJson());
+	if (m_args.count("output-dir"))
+		createFile("timings.json", json);
+	else
+		cout << "Timings: " << endl << json;
+}
+
+void CommandLineInterface::handleMemoryStats()
+{
+	if (!m_args.count(g_argMemoryStats))
+		return;
+	string json = Json::FastWriter().write(m_compiler->memoryAccounting());
+	if (m_args.count("output-dir"))
+		createFile("memory.json", json);
+	else
+		cout << "Memory: " << endl << json;
 }
 
 void CommandLineInterface::handleAst(string const& _argStr)
@@ -605,9 +1004,13 @@ void CommandLineInterface::handleAst(string const& _argStr)
 	if (m_args.count(_argStr))
 	{
 		vector<ASTNode const*> asts;
-		for (auto const& sourceCode: m_sourceCodes)
+		vector<string> sourceList;
+		for (auto const& sourceCode: sourceCodes())
+		{
 			asts.push_back(&m_compiler->ast(sourceCode.first));
-		map<ASTNode const*, eth::GasMeter::GasConsumption> gasCosts;
+			sourceList.push_back(sourceCode.first);
+		}
+		GasEstimator::ASTGasConsumption gasCosts;
 		if (m_compiler->runtimeAssemblyItems())
 			gasCosts = GasEstimator::breakToStatementLevel(
 				GasEstimator::structuralEstimation(*m_compiler->runtimeAssemblyItems(), asts),
@@ -616,7 +1019,7 @@ void CommandLineInterface::handleAst(string const& _argStr)
 
 		if (m_args.count("output-dir"))
 		{
-			for (auto const& sourceCode: m_sourceCodes)
+			for (auto const& sourceCode: sourceCodes())
 			{
 				stringstream data;
 				string postfix = "";
@@ -627,7 +1030,7 @@ void CommandLineInterface::handleAst(string const& _argStr)
 				}
 				else
 				{
-					ASTJsonConverter converter(m_compiler->ast(sourceCode.first));
+					ASTJsonConverter converter(m_compiler->ast(sourceCode.first), sourceList);
 					converter.print(data);
 					postfix += "_json";
 				}
@@ -638,7 +1041,7 @@ void CommandLineInterface::handleAst(string const& _argStr)
 		else
 		{
 			cout << title << endl << endl;
-			for (auto const& sourceCode: m_sourceCodes)
+			for (auto const& sourceCode: sourceCodes())
 			{
 				cout << endl << "======= " << sourceCode.first << " =======" << endl;
 				if (_argStr == g_argAstStr)
@@ -652,7 +1055,7 @@ void CommandLineInterface::handleAst(string const& _argStr)
 				}
 				else
 				{
-					ASTJsonConverter converter(m_compiler->ast(sourceCode.first));
+					ASTJsonConverter converter(m_compiler->ast(sourceCode.first), sourceList);
 					converter.print(cout);
 				}
 			}
@@ -662,50 +1065,253 @@ void CommandLineInterface::handleAst(string const& _argStr)
 
 void CommandLineInterface::actOnInput()
 {
-	if (m_onlyLink)
+	if (m_args.count(g_argDaemon))
+		runDaemon();
+	else if (m_onlyLink)
 		writeLinkedFiles();
 	else
+	{
 		outputCompilationResults();
+		if (m_args.count(g_argWatch))
+			runWatchMode();
+	}
+}
+
+void CommandLineInterface::runWatchMode()
+{
+	// Poll the input files for modification. Unchanged sources are served from the
+	// compiler's AST cache on recompilation, so a rebuild only pays for the import
+	// subgraph that actually changed, and createFile() skips rewriting outputs
+	// whose content is already up to date.
+	map<string, std::time_t> lastModified;
+	for (string const& infile: m_args["input-file"].as<vector<string>>())
+		if (boost::filesystem::exists(infile) && boost::filesystem::is_regular_file(infile))
+			lastModified[infile] = boost::filesystem::last_write_time(infile);
+	cerr << "Watching " << lastModified.size() << " file(s) for changes..." << endl;
+	while (true)
+	{
+		this_thread::sleep_for(chrono::milliseconds(50));
+		bool changed = false;
+		for (auto& watched: lastModified)
+		{
+			if (!boost::filesystem::exists(watched.first))
+				continue;
+			std::time_t stamp = boost::filesystem::last_write_time(watched.first);
+			if (stamp == watched.second)
+				continue;
+			watched.second = stamp;
+			m_sourceCodes[watched.first] = dev::contentsString(watched.first);
+			changed = true;
+		}
+		if (!changed)
+			continue;
+		// Keep watching even if the edited source no longer compiles; the errors
+		// have already been reported by compileSources().
+		if (compileSources())
+			outputCompilationResults();
+	}
+}
+
+void CommandLineInterface::runDaemon()
+{
+	// One process keeps a warm compiler stack: the standard sources stay parsed and
+	// the process-wide caches (interned strings, pooled types, artifact cache) stay
+	// hot across jobs. Each job gets a clean slate via reset().
+	m_compiler.reset(new CompilerStack(m_args.count(g_argAddStandard) > 0));
+	string line;
+	while (getline(cin, line))
+	{
+		if (line.empty())
+			continue;
+		cout << processDaemonJob(line);
+		cout.flush();
+	}
+}
+
+string CommandLineInterface::processDaemonJob(string const& _job)
+{
+	Json::Value output(Json::objectValue);
+	Json::Value errors(Json::arrayValue);
+
+	Json::Reader reader;
+	Json::Value job;
+	if (!reader.parse(_job, job, false))
+	{
+		errors.append("Error parsing job JSON: " + reader.getFormattedErrorMessages());
+		output["errors"] = errors;
+		return Json::FastWriter().write(output);
+	}
+
+	bool optimize = job["optimize"].asBool();
+	unsigned runs = job.isMember("optimizeRuns") ? job["optimizeRuns"].asUInt() : 200;
+	StringMap sources;
+	if (job["sources"].isObject())
+		for (auto const& sourceName: job["sources"].getMemberNames())
+			sources[sourceName] = job["sources"][sourceName].asString();
+
+	bool success = false;
+	try
+	{
+		m_compiler->reset();
+		m_compiler->addSources(sources);
+		success = m_compiler->compile(optimize, runs);
+		for (auto const& error: m_compiler->errors())
+		{
+			ostringstream formatted;
+			SourceReferenceFormatter::printExceptionInformation(
+				formatted,
+				*error,
+				(error->type() == Error::Type::Warning) ? "Warning" : "Error",
+				*m_compiler
+			);
+			errors.append(formatted.str());
+		}
+	}
+	catch (Exception const& _exception)
+	{
+		errors.append("Exception during compilation: " + boost::diagnostic_information(_exception));
+	}
+	catch (...)
+	{
+		errors.append("Unknown exception during compilation.");
+	}
+
+	if (errors.size() > 0)
+		output["errors"] = errors;
+	if (success)
+	{
+		output["contracts"] = Json::Value(Json::objectValue);
+		for (string const& contractName: m_compiler->contractNames())
+		{
+			Json::Value contractData(Json::objectValue);
+			contractData["interface"] = m_compiler->interface(contractName);
+			contractData["bytecode"] = m_compiler->object(contractName).toHex();
+			contractData["runtimeBytecode"] = m_compiler->runtimeObject(contractName).toHex();
+			output["contracts"][contractName] = contractData;
+		}
+	}
+	return Json::FastWriter().write(output);
 }
 
 bool CommandLineInterface::link()
 {
+	// Binaries named on the command line are mapped and patched in place across
+	// threads; only the stdin case still goes through strings and
+	// writeLinkedFiles().
+	if (m_args.count("input-file"))
+		return linkFilesInPlace();
 	for (auto& src: m_sourceCodes)
 	{
-		auto end = src.second.end();
-		for (auto it = src.second.begin(); it != end;)
+		ostringstream messages;
+		bool successful = linkBuffer(src.first, &src.second[0], src.second.size(), messages);
+		cerr << messages.str();
+		if (!successful)
+			return false;
+	}
+	return true;
+}
+
+bool CommandLineInterface::linkBuffer(string const& _fileName, char* _data, size_t _size, ostream& _messages)
+{
+	char* end = _data + _size;
+	for (char* it = _data; it != end;)
+	{
+		// memchr skips the bulk of the binary in one library call per placeholder.
+		it = static_cast<char*>(memchr(it, '_', end - it));
+		if (!it)
+			break;
+		char* insertStart = it;
+		while (it != end && *it == '_') ++it;
+		char* nameStart = it;
+		while (it != end && *it != '_') ++it;
+		char* nameEnd = it;
+		while (it != end && *it == '_') ++it;
+		char* insertEnd = it;
+
+		if (insertEnd - insertStart != 40)
 		{
-			while (it != end && *it != '_') ++it;
-			auto insertStart = it;
-			while (it != end && *it == '_') ++it;
-			auto nameStart = it;
-			while (it != end && *it != '_') ++it;
-			auto nameEnd = it;
-			while (it != end && *it == '_') ++it;
-			auto insertEnd = it;
-
-			if (insertStart == end)
-				break;
-
-			if (insertEnd - insertStart != 40)
-			{
-				cerr << "Error in binary object file " << src.first << " at position " << (insertStart - src.second.begin()) << endl;
-				return false;
-			}
+			_messages << "Error in binary object file " << _fileName << " at position " << (insertStart - _data) << endl;
+			return false;
+		}
 
-			string name(nameStart, nameEnd);
-			if (m_libraries.count(name))
-			{
-				string hexStr(toHex(m_libraries.at(name).asBytes()));
-				copy(hexStr.begin(), hexStr.end(), insertStart);
-			}
-			else
-				cerr << "Reference \"" << name << "\" in file \"" << src.first << "\" still unresolved." << endl;
+		string name(nameStart, nameEnd);
+		if (m_libraries.count(name))
+		{
+			string hexStr(toHex(m_libraries.at(name).asBytes()));
+			copy(hexStr.begin(), hexStr.end(), insertStart);
 		}
+		else
+			_messages << "Reference \"" << name << "\" in file \"" << _fileName << "\" still unresolved." << endl;
 	}
 	return true;
 }
 
+bool CommandLineInterface::linkFileInPlace(string const& _fileName, ostream& _messages)
+{
+	if (!boost::filesystem::exists(_fileName) || !boost::filesystem::is_regular_file(_fileName))
+		return true;
+#ifndef _WIN32
+	int fd = open(_fileName.c_str(), O_RDWR);
+	if (fd >= 0)
+	{
+		size_t size = boost::filesystem::file_size(_fileName);
+		if (size == 0)
+		{
+			close(fd);
+			return true;
+		}
+		void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		if (data != MAP_FAILED)
+		{
+			bool successful = linkBuffer(_fileName, static_cast<char*>(data), size, _messages);
+			munmap(data, size);
+			return successful;
+		}
+	}
+#endif
+	// Fallback: read, patch and write back.
+	string content = dev::contentsString(_fileName);
+	bool successful = linkBuffer(_fileName, &content[0], content.size(), _messages);
+	if (successful)
+		writeFile(_fileName, content);
+	return successful;
+}
+
+bool CommandLineInterface::linkFilesInPlace()
+{
+	vector<string> files = m_args["input-file"].as<vector<string>>();
+	size_t threadCount = min(files.size(), size_t(max(1u, thread::hardware_concurrency())));
+	vector<string> messages(files.size());
+	atomic<size_t> next(0);
+	atomic<bool> failed(false);
+	auto work = [&]()
+	{
+		for (size_t i = next++; i < files.size() && !failed; i = next++)
+		{
+			ostringstream fileMessages;
+			if (!linkFileInPlace(files[i], fileMessages))
+				failed = true;
+			messages[i] = fileMessages.str();
+		}
+	};
+	if (threadCount <= 1)
+		work();
+	else
+	{
+		vector<thread> workers;
+		for (size_t t = 1; t < threadCount; ++t)
+			workers.emplace_back(work);
+		work();
+		for (thread& worker: workers)
+			worker.join();
+	}
+	// Report in command line order, independent of scheduling.
+	for (string const& message: messages)
+		cerr << message;
+	return !failed;
+}
+
 void CommandLineInterface::writeLinkedFiles()
 {
 	for (auto const& src: m_sourceCodes)
@@ -715,14 +1321,76 @@ void CommandLineInterface::writeLinkedFiles()
 			writeFile(src.first, src.second);
 }
 
+void CommandLineInterface::precomputeMetadata()
+{
+	// Document generation through the InterfaceHandler is pure and independent per
+	// contract, so every requested document is computed over a pool of threads here
+	// and cached inside the compiler stack. The output handlers below then only
+	// print cached results, in the usual deterministic order.
+	set<string> combinedRequests;
+	if (m_args.count("combined-json"))
+		boost::split(combinedRequests, m_args["combined-json"].as<string>(), boost::is_any_of(","));
+
+	vector<DocumentationType> documentationTypes;
+	if (m_args.count(g_argAbiStr) || combinedRequests.count("abi"))
+		documentationTypes.push_back(DocumentationType::ABIInterface);
+	if (m_args.count(g_argAbiBinStr))
+		documentationTypes.push_back(DocumentationType::ABIBinary);
+	if (m_args.count(g_argSolInterfaceStr) || combinedRequests.count("interface"))
+		documentationTypes.push_back(DocumentationType::ABISolidityInterface);
+	if (m_args.count(g_argNatspecDevStr) || combinedRequests.count("devdoc"))
+		documentationTypes.push_back(DocumentationType::NatspecDev);
+	if (m_args.count(g_argNatspecUserStr) || combinedRequests.count("userdoc"))
+		documentationTypes.push_back(DocumentationType::NatspecUser);
+
+	vector<string> contracts = m_compiler->contractNames();
+	if (documentationTypes.empty() || contracts.size() <= 1)
+		return;
+
+	vector<exception_ptr> workerExceptions(contracts.size());
+	atomic<size_t> nextContract(0);
+	auto metadataWorker = [&]()
+	{
+		for (size_t i = nextContract++; i < contracts.size(); i = nextContract++)
+			try
+			{
+				for (DocumentationType type: documentationTypes)
+					m_compiler->metadata(contracts[i], type);
+			}
+			catch (...)
+			{
+				workerExceptions[i] = current_exception();
+			}
+	};
+	size_t threadCount = min(contracts.size(), size_t(max(1u, thread::hardware_concurrency())));
+	if (threadCount <= 1)
+		metadataWorker();
+	else
+	{
+		vector<thread> workers;
+		for (size_t i = 0; i < threadCount; ++i)
+			workers.emplace_back(metadataWorker);
+		for (thread& worker: workers)
+			worker.join();
+	}
+	for (size_t i = 0; i < contracts.size(); ++i)
+		if (workerExceptions[i])
+			rethrow_exception(workerExceptions[i]);
+}
+
 void CommandLineInterface::outputCompilationResults()
 {
+	precomputeMetadata();
+
 	handleCombinedJSON();
 
 	// do we need AST output?
 	handleAst(g_argAstStr);
 	handleAst(g_argAstJson);
 
+	handleTimings();
+	handleMemoryStats();
+
 	vector<string> contracts = m_compiler->contractNames();
 	for (string const& contract: contracts)
 	{
@@ -735,26 +1403,30 @@ void CommandLineInterface::outputCompilationResults()
 			if (m_args.count("output-dir"))
 			{
 				stringstream data;
-				m_compiler->streamAssembly(data, contract, m_sourceCodes, m_args.count(g_argAsmJsonStr));
+				m_compiler->streamAssembly(data, contract, sourceCodes(), m_args.count(g_argAsmJsonStr));
 				createFile(contract + (m_args.count(g_argAsmJsonStr) ? "_evm.json" : ".evm"), data.str());
 			}
 			else
 			{
 				cout << "EVM assembly:" << endl;
-				m_compiler->streamAssembly(cout, contract, m_sourceCodes, m_args.count(g_argAsmJsonStr));
+				m_compiler->streamAssembly(cout, contract, sourceCodes(), m_args.count(g_argAsmJsonStr));
 			}
 		}
 
 		if (m_args.count(g_argGas))
 			handleGasEstimation(contract);
+		handleGasProfile(contract);
 
 		handleBytecode(contract);
 		handleSignatureHashes(contract);
 		handleMeta(DocumentationType::ABIInterface, contract);
+		handleMeta(DocumentationType::ABIBinary, contract);
 		handleMeta(DocumentationType::ABISolidityInterface, contract);
 		handleMeta(DocumentationType::NatspecDev, contract);
 		handleMeta(DocumentationType::NatspecUser, contract);
 	} // end of contracts iteration
+
+	writeOutputFiles();
 }
 
 }
@@ -23,6 +23,7 @@
 
 #include <libsolidity/CompilerStack.h>
 #include <memory>
+#include <ostream>
 #include <boost/program_options.hpp>
 
 namespace dev
@@ -37,6 +38,7 @@ class CommandLineInterface
 {
 public:
 	CommandLineInterface() {}
+	~CommandLineInterface();
 
 	/// Parse command line arguments and return false if we should not continue
 	bool parseArguments(int _argc, char** _argv);
@@ -47,11 +49,36 @@ public:
 
 private:
 	bool link();
+	/// Substitutes library address placeholders in the given buffer in place.
+	bool linkBuffer(std::string const& _fileName, char* _data, size_t _size, std::ostream& _messages);
+	/// Links one prebuilt binary file, memory-mapped and patched in place where
+	/// possible, with a read-patch-rewrite fallback.
+	bool linkFileInPlace(std::string const& _fileName, std::ostream& _messages);
+	/// Links all input files in place across a pool of threads.
+	bool linkFilesInPlace();
 	void writeLinkedFiles();
 
+	/// Runs the compile server loop: one JSON job per input line, one JSON result
+	/// per output line, reusing the warm compiler stack across jobs.
+	void runDaemon();
+	/// Compiles a single daemon job and @returns its JSON result document.
+	std::string processDaemonJob(std::string const& _job);
+
+	/// (Re)compiles the current sources according to the requested outputs,
+	/// reusing the compiler stack and its cached ASTs if one already exists.
+	bool compileSources();
+	/// Polls the input files for changes and incrementally recompiles on each one.
+	void runWatchMode();
+
 	void outputCompilationResults();
 
+	/// Computes all requested per-contract documents in parallel so that the
+	/// output handlers only print cached results.
+	void precomputeMetadata();
+
 	void handleCombinedJSON();
+	void handleTimings();
+	void handleMemoryStats();
 	void handleAst(std::string const& _argStr);
 	void handleBinary(std::string const& _contract);
 	void handleOpcode(std::string const& _contract);
@@ -60,22 +87,37 @@ private:
 	void handleMeta(DocumentationType _type,
 					std::string const& _contract);
 	void handleGasEstimation(std::string const& _contract);
+	void handleGasProfile(std::string const& _contract);
 
 	/// Tries to read from the file @a _input or interprets _input literally if that fails.
 	/// It then tries to parse the contents and appends to m_libraries.
 	bool parseLibraryOption(std::string const& _input);
 
-	/// Create a file in the given directory
+	/// Buffer an output file in the output directory
 	/// @arg _fileName the name of the file
 	/// @arg _data to be written
 	void createFile(std::string const& _fileName, std::string const& _data);
 
+	/// Flushes all buffered output files in one batch, in parallel, skipping
+	/// files whose on-disk content is already up to date. With --output-archive
+	/// everything goes into a single artifacts.json manifest instead.
+	void writeOutputFiles();
+
+	/// @returns all source texts by name, materializing memory-mapped sources
+	/// into strings on first use. Only output paths that print source text pay
+	/// for this copy; compilation itself works directly on the mapped pages.
+	std::map<std::string, std::string> const& sourceCodes();
+
 	bool m_onlyLink = false;
 
 	/// Compiler arguments variable map
 	boost::program_options::variables_map m_args;
 	/// map of input files to source code strings
 	std::map<std::string, std::string> m_sourceCodes;
+	/// read-only memory-mapped input files (data pointer and size), unmapped on destruction
+	std::map<std::string, std::pair<char const*, size_t>> m_mappedSources;
+	/// output files buffered by createFile(), flushed by writeOutputFiles()
+	std::map<std::string, std::string> m_bufferedOutputs;
 	/// map of library names to addresses
 	std::map<std::string, h160> m_libraries;
 	/// Solidity compiler stack
@@ -114,16 +114,38 @@ Json::Value estimateGas(CompilerStack const& _compiler, string const& _contract)
 	return gasEstimates;
 }
 
-string compile(StringMap const& _sources, bool _optimize)
+/// How far a run through compileOnStack takes the sources; each stage also
+/// runs the earlier ones.
+enum class Stage
+{
+	Parse,     ///< scan and parse only, output is errors and ASTs
+	Typecheck, ///< all semantic checks, adds interfaces and function hashes
+	Compile    ///< code generation, adds bytecode, opcodes and gas estimates
+};
+
+/// Runs the given stage over @a _sources on the given stack and @returns the
+/// result document. If @a _previousBytecode is given, contracts whose bytecode
+/// is unchanged compared to the recorded state are only listed under
+/// "unchangedContracts" instead of being emitted in full, and the recorded
+/// state is updated.
+string compileOnStack(
+	CompilerStack& compiler,
+	StringMap const& _sources,
+	bool _optimize,
+	map<string, string>* _previousBytecode,
+	Stage _stage = Stage::Compile
+)
 {
 	Json::Value output(Json::objectValue);
 	Json::Value errors(Json::arrayValue);
-	CompilerStack compiler;
 	bool success = false;
 	try
 	{
 		compiler.addSources(_sources);
-		bool succ = compiler.compile(_optimize);
+		bool succ =
+			_stage == Stage::Parse ? compiler.parse() :
+			_stage == Stage::Typecheck ? compiler.typeCheck() :
+			compiler.compile(_optimize);
 		for (auto const& error: compiler.errors())
 		{
 			auto err = dynamic_pointer_cast<Error const>(error);
@@ -161,33 +183,94 @@ string compile(StringMap const& _sources, bool _optimize)
 
 	if (success)
 	{
-		output["contracts"] = Json::Value(Json::objectValue);
-		for (string const& contractName: compiler.contractNames())
+		Json::Value unchanged(Json::arrayValue);
+		if (_stage != Stage::Parse)
 		{
-			Json::Value contractData(Json::objectValue);
-			contractData["solidity_interface"] = compiler.solidityInterface(contractName);
-			contractData["interface"] = compiler.interface(contractName);
-			contractData["bytecode"] = compiler.object(contractName).toHex();
-			contractData["runtimeBytecode"] = compiler.runtimeObject(contractName).toHex();
-			contractData["opcodes"] = eth::disassemble(compiler.object(contractName).bytecode);
-			contractData["functionHashes"] = functionHashes(compiler.contractDefinition(contractName));
-			contractData["gasEstimates"] = estimateGas(compiler, contractName);
-			ostringstream unused;
-			contractData["assembly"] = compiler.streamAssembly(unused, contractName, _sources, true);
-			output["contracts"][contractName] = contractData;
+			output["contracts"] = Json::Value(Json::objectValue);
+			for (string const& contractName: compiler.contractNames())
+			{
+				if (_stage == Stage::Compile && _previousBytecode)
+				{
+					string bytecode = compiler.object(contractName).toHex();
+					auto previous = _previousBytecode->find(contractName);
+					if (previous != _previousBytecode->end() && previous->second == bytecode)
+					{
+						unchanged.append(contractName);
+						continue;
+					}
+					(*_previousBytecode)[contractName] = bytecode;
+				}
+				Json::Value contractData(Json::objectValue);
+				contractData["solidity_interface"] = compiler.solidityInterface(contractName);
+				contractData["interface"] = compiler.interface(contractName);
+				contractData["functionHashes"] = functionHashes(compiler.contractDefinition(contractName));
+				if (_stage == Stage::Compile)
+				{
+					contractData["bytecode"] = compiler.object(contractName).toHex();
+					contractData["runtimeBytecode"] = compiler.runtimeObject(contractName).toHex();
+					contractData["opcodes"] = eth::disassemble(compiler.object(contractName).bytecode);
+					contractData["gasEstimates"] = estimateGas(compiler, contractName);
+					ostringstream unused;
+					contractData["assembly"] = compiler.streamAssembly(unused, contractName, _sources, true);
+				}
+				output["contracts"][contractName] = contractData;
+			}
 		}
 
+		vector<string> sourceList;
+		for (auto const& source: _sources)
+			sourceList.push_back(source.first);
 		output["sources"] = Json::Value(Json::objectValue);
 		for (auto const& source: _sources)
 		{
 			output["sources"][source.first] = Json::Value(Json::objectValue);
-			output["sources"][source.first]["AST"] = ASTJsonConverter(compiler.ast(source.first)).json();
+			output["sources"][source.first]["AST"] = ASTJsonConverter(compiler.ast(source.first), sourceList).json();
 		}
+		if (_previousBytecode)
+			output["unchangedContracts"] = unchanged;
 	}
 
 	return Json::FastWriter().write(output);
 }
 
+string compile(StringMap const& _sources, bool _optimize)
+{
+	CompilerStack compiler;
+	return compileOnStack(compiler, _sources, _optimize, nullptr);
+}
+
+string runStageSingle(string const& _input, Stage _stage)
+{
+	StringMap sources;
+	sources[""] = _input;
+	CompilerStack compiler;
+	return compileOnStack(compiler, sources, false, nullptr, _stage);
+}
+
+/// A long-lived compilation session for the C API below. The compiler stack
+/// survives between compile() calls, so unchanged sources keep their cached
+/// ASTs and repeated compiles of an edited file only pay incremental cost.
+class CompilerSession
+{
+public:
+	void setSource(string const& _name, string const& _content) { m_sources[_name] = _content; }
+	char const* compile(bool _optimize)
+	{
+		// addSource() keeps the cached AST of every source whose content hash
+		// is unchanged; only edited files and their dependents are reparsed.
+		m_output = compileOnStack(m_compiler, m_sources, _optimize, &m_previousBytecode);
+		return m_output.c_str();
+	}
+
+private:
+	CompilerStack m_compiler;
+	StringMap m_sources;
+	/// Bytecode of the previous compile, used to report deltas.
+	map<string, string> m_previousBytecode;
+	/// Keeps the result of the last compile() alive for the C caller.
+	string m_output;
+};
+
 string compileMulti(string const& _input, bool _optimize)
 {
 	Json::Reader reader;
@@ -236,4 +319,39 @@ extern char const* compileJSONMulti(char const* _input, bool _optimize)
 	s_outputBuffer = compileMulti(_input, _optimize);
 	return s_outputBuffer.c_str();
 }
+/// Scans and parses only: returns errors and ASTs, no semantic checks or code.
+extern char const* parseJSON(char const* _input)
+{
+	s_outputBuffer = runStageSingle(_input, Stage::Parse);
+	return s_outputBuffer.c_str();
+}
+/// Runs all semantic checks but no code generation: returns errors, interfaces
+/// and function hashes in addition to the ASTs.
+extern char const* typecheckJSON(char const* _input)
+{
+	s_outputBuffer = runStageSingle(_input, Stage::Typecheck);
+	return s_outputBuffer.c_str();
+}
+/// Creates a compilation session that keeps compiler state alive between calls.
+extern void* createSession()
+{
+	return new CompilerSession();
+}
+/// Adds or replaces a source in the session; unchanged content keeps its parse state.
+extern void sessionAddSource(void* _session, char const* _name, char const* _content)
+{
+	static_cast<CompilerSession*>(_session)->setSource(_name, _content);
+}
+/// Compiles the session's sources and @returns a result document in the
+/// compileJSONMulti format; contracts whose bytecode did not change since the
+/// previous call are only named under "unchangedContracts". The returned
+/// pointer stays valid until the next sessionCompile() on the same session.
+extern char const* sessionCompile(void* _session, bool _optimize)
+{
+	return static_cast<CompilerSession*>(_session)->compile(_optimize);
+}
+extern void freeSession(void* _session)
+{
+	delete static_cast<CompilerSession*>(_session);
+}
 }
@@ -19,15 +19,240 @@
  * @date 2014
  * Stub for generating main boost.test module.
  * Original code taken from boost sources.
+ *
+ * Supports sharded execution: with SOLTEST_SHARDS=<n> in the environment the
+ * process forks <n> workers, partitions the test cases across them balanced
+ * by recorded historical durations, and merges the results. A single worker
+ * can also be selected manually by additionally setting SOLTEST_SHARD=<i>.
  */
 
 #define BOOST_TEST_MODULE EthereumTests
+#define BOOST_TEST_NO_MAIN
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 //#define BOOST_DISABLE_WIN32 //disables SEH warning
 #include <boost/test/included/unit_test.hpp>
 #pragma GCC diagnostic pop
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #include <test/TestHelper.h>
 using namespace boost::unit_test;
+using namespace std;
+
+namespace
+{
+
+string timingsFileName()
+{
+	char const* name = getenv("SOLTEST_TIMINGS");
+	return name ? name : "soltest_timings.txt";
+}
+
+/// Workers write their timings to a private file (set up by the runner) so
+/// parallel shards do not race on the shared one; the runner merges them.
+string timingsOutFileName()
+{
+	char const* name = getenv("SOLTEST_TIMINGS_OUT");
+	return name ? name : timingsFileName();
+}
+
+/// Reads recorded per-case durations (microseconds) from the timings file.
+map<string, unsigned long> readTimings(string const& _fileName)
+{
+	map<string, unsigned long> timings;
+	ifstream file(_fileName);
+	string line;
+	while (getline(file, line))
+	{
+		size_t tab = line.find('\t');
+		if (tab == string::npos)
+			continue;
+		timings[line.substr(0, tab)] = strtoul(line.c_str() + tab + 1, nullptr, 10);
+	}
+	return timings;
+}
+
+void writeTimings(string const& _fileName, map<string, unsigned long> const& _timings)
+{
+	ofstream file(_fileName);
+	for (auto const& timing: _timings)
+		file << timing.first << '\t' << timing.second << '\n';
+}
+
+/// Collects all leaf test cases with their full "suite/case" names.
+class CaseCollector: public test_tree_visitor
+{
+public:
+	struct Case
+	{
+		test_case* testCase;
+		string name;
+	};
+
+	void visit(test_case const& _case) override
+	{
+		Case collected;
+		collected.testCase = &const_cast<test_case&>(_case);
+		collected.name = m_path + string(_case.p_name);
+		m_cases.push_back(collected);
+	}
+	bool test_suite_start(test_suite const& _suite) override
+	{
+		if (_suite.p_id != framework::master_test_suite().p_id)
+			m_path += string(_suite.p_name) + "/";
+		return true;
+	}
+	void test_suite_finish(test_suite const& _suite) override
+	{
+		if (_suite.p_id != framework::master_test_suite().p_id)
+			m_path.resize(m_path.size() - string(_suite.p_name).size() - 1);
+	}
+
+	vector<Case> const& cases() const { return m_cases; }
+
+private:
+	string m_path;
+	vector<Case> m_cases;
+};
+
+/// Records the duration of every executed test case and folds it into the
+/// timings file on test completion, so later runs shard by real cost.
+class DurationRecorder: public test_observer
+{
+public:
+	void test_unit_start(test_unit const& _unit) override
+	{
+		if (_unit.p_type == tut_suite && _unit.p_id != framework::master_test_suite().p_id)
+			m_path += string(_unit.p_name) + "/";
+	}
+	void test_unit_finish(test_unit const& _unit, unsigned long _elapsed) override
+	{
+		if (_unit.p_type == tut_case)
+			m_durations[m_path + string(_unit.p_name)] = _elapsed;
+		else if (_unit.p_id != framework::master_test_suite().p_id)
+			m_path.resize(m_path.size() - string(_unit.p_name).size() - 1);
+	}
+	void test_finish() override
+	{
+		if (m_durations.empty())
+			return;
+		// Merge into the existing file so repeated runs only update their own cases.
+		map<string, unsigned long> timings = readTimings(timingsOutFileName());
+		for (auto const& duration: m_durations)
+			timings[duration.first] = duration.second;
+		writeTimings(timingsOutFileName(), timings);
+	}
+
+private:
+	string m_path;
+	map<string, unsigned long> m_durations;
+};
+
+DurationRecorder g_durationRecorder;
+
+/// Disables every test case that does not belong to this worker's shard.
+/// Cases are assigned greedily, longest recorded duration first, to the
+/// least loaded shard, so shards finish at roughly the same time.
+void applySharding(unsigned _shards, unsigned _shard)
+{
+	CaseCollector collector;
+	traverse_test_tree(framework::master_test_suite(), collector);
+	vector<CaseCollector::Case> cases = collector.cases();
+
+	map<string, unsigned long> timings = readTimings(timingsFileName());
+	auto duration = [&](CaseCollector::Case const& _case) -> unsigned long
+	{
+		auto it = timings.find(_case.name);
+		// Unknown cases get a nominal cost so they still spread out evenly.
+		return it == timings.end() ? 1000 : max<unsigned long>(it->second, 1);
+	};
+	stable_sort(cases.begin(), cases.end(), [&](CaseCollector::Case const& _a, CaseCollector::Case const& _b)
+	{
+		return duration(_a) > duration(_b);
+	});
+
+	vector<unsigned long> load(_shards, 0);
+	for (CaseCollector::Case const& testCase: cases)
+	{
+		size_t leastLoaded = min_element(load.begin(), load.end()) - load.begin();
+		load[leastLoaded] += duration(testCase);
+		if (leastLoaded != _shard)
+			testCase.testCase->p_enabled.value = false;
+	}
+}
+
+unsigned envNumber(char const* _name)
+{
+	char const* value = getenv(_name);
+	return value ? unsigned(strtoul(value, nullptr, 10)) : 0;
+}
+
+test_suite* initTests(int argc, char* argv[])
+{
+	test_suite* suite = init_unit_test_suite(argc, argv);
+	framework::register_observer(g_durationRecorder);
+	unsigned shards = envNumber("SOLTEST_SHARDS");
+	if (shards > 1)
+		applySharding(shards, min(envNumber("SOLTEST_SHARD"), shards - 1));
+	return suite;
+}
+
+}
 
+int main(int argc, char* argv[])
+{
+#ifndef _WIN32
+	unsigned shards = envNumber("SOLTEST_SHARDS");
+	if (shards > 1 && !getenv("SOLTEST_SHARD"))
+	{
+		// Runner mode: fork one worker per shard; each child continues into
+		// unit_test_main with its shard selected and the same arguments.
+		vector<pid_t> children;
+		for (unsigned shard = 0; shard < shards; ++shard)
+		{
+			pid_t child = fork();
+			if (child == 0)
+			{
+				setenv("SOLTEST_SHARD", to_string(shard).c_str(), 1);
+				setenv("SOLTEST_TIMINGS_OUT", (timingsFileName() + "." + to_string(shard)).c_str(), 1);
+				return unit_test_main(&initTests, argc, argv);
+			}
+			if (child > 0)
+				children.push_back(child);
+		}
+		int result = 0;
+		for (pid_t child: children)
+		{
+			int status = 0;
+			waitpid(child, &status, 0);
+			if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+				result = 1;
+		}
+		// Fold the workers' timing files into the shared one for the next run.
+		map<string, unsigned long> timings = readTimings(timingsFileName());
+		for (unsigned shard = 0; shard < shards; ++shard)
+		{
+			string shardFile = timingsFileName() + "." + to_string(shard);
+			for (auto const& timing: readTimings(shardFile))
+				timings[timing.first] = timing.second;
+			remove(shardFile.c_str());
+		}
+		writeTimings(timingsFileName(), timings);
+		return result;
+	}
+#endif
+	return unit_test_main(&initTests, argc, argv);
+}
@@ -0,0 +1,281 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Gas regression harness: records per-function execution gas and estimator
+ * values for the contract corpus in test/contracts against a checked-in
+ * baseline and fails with a readable diff when costs regress.
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <test/libsolidity/solidityExecutionFramework.h>
+#include <libsolidity/AST.h>
+#include <libsolidity/GasEstimator.h>
+
+using namespace std;
+using namespace dev::eth;
+using namespace dev::solidity;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+
+#ifndef SOLTEST_SOURCE_DIR
+#define SOLTEST_SOURCE_DIR "."
+#endif
+
+string baselineFileName()
+{
+	char const* name = getenv("SOLTEST_GAS_BASELINE");
+	return name ? name : string(SOLTEST_SOURCE_DIR) + "/libsolidity/gasBaseline.txt";
+}
+
+unsigned tolerancePercent()
+{
+	char const* tolerance = getenv("SOLTEST_GAS_TOLERANCE");
+	return tolerance ? unsigned(strtoul(tolerance, nullptr, 10)) : 5;
+}
+
+/// One baseline or measured figure; "inf" in the file maps to infinite and
+/// "unrecorded" marks an inventory entry whose values were never measured.
+struct GasFigures
+{
+	bool recorded = true;
+	bool estimateInfinite = false;
+	u256 estimate;
+	u256 actual;
+};
+
+string figureToString(bool _infinite, u256 const& _value)
+{
+	return _infinite ? string("inf") : _value.str();
+}
+
+/// Baseline format: one line per function,
+/// <contract>\t<signature>\t<estimate>\t<actual>, '#' starts a comment.
+map<pair<string, string>, GasFigures> readBaseline(string const& _fileName)
+{
+	map<pair<string, string>, GasFigures> baseline;
+	ifstream file(_fileName);
+	string line;
+	while (getline(file, line))
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+		istringstream fields(line);
+		string contract;
+		string signature;
+		string estimate;
+		string actual;
+		if (!getline(fields, contract, '\t') || !getline(fields, signature, '\t') ||
+			!getline(fields, estimate, '\t') || !getline(fields, actual, '\t'))
+			continue;
+		GasFigures figures;
+		figures.recorded = estimate != "unrecorded" && actual != "unrecorded";
+		if (figures.recorded)
+		{
+			figures.estimateInfinite = estimate == "inf";
+			if (!figures.estimateInfinite)
+				figures.estimate = u256(estimate);
+			figures.actual = u256(actual);
+		}
+		baseline[make_pair(contract, signature)] = figures;
+	}
+	return baseline;
+}
+
+void writeBaseline(string const& _fileName, map<pair<string, string>, GasFigures> const& _figures)
+{
+	ofstream file(_fileName);
+	file << "# Gas baseline for the test/contracts corpus.\n";
+	file << "# Regenerate with SOLTEST_UPDATE_GAS_BASELINE=1 after intended codegen changes.\n";
+	file << "# \"unrecorded\" entries list the function inventory but have not been measured\n";
+	file << "# yet; the first run that can measure them records their figures and warns so\n";
+	file << "# the updated baseline gets reviewed and committed.\n";
+	file << "# contract\tsignature\testimated\tactual\n";
+	for (auto const& figure: _figures)
+		if (figure.second.recorded)
+			file << figure.first.first << '\t' << figure.first.second << '\t'
+				<< figureToString(figure.second.estimateInfinite, figure.second.estimate) << '\t'
+				<< figure.second.actual.str() << '\n';
+		else
+			file << figure.first.first << '\t' << figure.first.second
+				<< "\tunrecorded\tunrecorded\n";
+}
+
+/// Extracts the contract source embedded as a raw string literal in one of
+/// the corpus fixtures in test/contracts.
+string extractEmbeddedSource(string const& _fileName)
+{
+	ifstream file(string(SOLTEST_SOURCE_DIR) + "/contracts/" + _fileName);
+	stringstream buffer;
+	buffer << file.rdbuf();
+	string content = buffer.str();
+	string const startMarker = "R\"DELIMITER(";
+	string const endMarker = ")DELIMITER\"";
+	size_t start = content.find(startMarker);
+	size_t end = content.find(endMarker);
+	if (start == string::npos || end == string::npos || end <= start)
+		return string();
+	start += startMarker.size();
+	return content.substr(start, end - start);
+}
+
+}
+
+class GasRegressionFramework: public ExecutionFramework
+{
+protected:
+	/// Compiles and deploys the contract and measures, for every external
+	/// function, the estimator's prediction and the gas actually consumed by
+	/// a call with zeroed arguments.
+	map<pair<string, string>, GasFigures> measureContract(
+		string const& _sourceCode,
+		string const& _contractName,
+		bytes const& _constructorArgs
+	)
+	{
+		m_optimize = true;
+		// Compile directly (not through the cached compileAndRun) because the
+		// measurements need the compiler stack's assembly items.
+		m_compiler.reset(false, m_addStandardSources);
+		m_compiler.addSource("", _sourceCode);
+		ETH_TEST_REQUIRE_NO_THROW(m_compiler.compile(m_optimize, m_optimizeRuns), "Compiling contract failed");
+		sendMessage(m_compiler.object(_contractName).bytecode + _constructorArgs, true, 0);
+		BOOST_REQUIRE(!m_output.empty());
+
+		map<pair<string, string>, GasFigures> figures;
+		for (auto const& function: m_compiler.contractDefinition(_contractName).interfaceFunctions())
+		{
+			string signature = function.second->externalSignature();
+			GasFigures figure;
+			GasEstimator::GasConsumption estimate = GasEstimator::functionalEstimation(
+				*m_compiler.runtimeAssemblyItems(_contractName),
+				signature
+			);
+			figure.estimateInfinite = estimate.isInfinite;
+			figure.estimate = estimate.value;
+			bytes arguments(function.second->parameterTypes().size() * 32, 0);
+			sendMessage(function.first.asBytes() + arguments, false, 0);
+			figure.actual = m_gasUsed;
+			figures[make_pair(_contractName, signature)] = figure;
+		}
+		return figures;
+	}
+};
+
+BOOST_FIXTURE_TEST_SUITE(GasRegression, GasRegressionFramework)
+
+BOOST_AUTO_TEST_CASE(corpus_gas_baseline)
+{
+	struct CorpusEntry
+	{
+		string fileName;
+		string contractName;
+		bytes constructorArgs;
+	};
+	vector<CorpusEntry> corpus{
+		{"Wallet.cpp", "Wallet", encodeArgs(u256(0x60), u256(1), u256(0), u256(0))},
+		{"AuctionRegistrar.cpp", "GlobalRegistrar", bytes()},
+		{"FixedFeeRegistrar.cpp", "FixedFeeRegistrar", bytes()}
+	};
+
+	map<pair<string, string>, GasFigures> current;
+	for (CorpusEntry const& entry: corpus)
+	{
+		string source = extractEmbeddedSource(entry.fileName);
+		BOOST_REQUIRE_MESSAGE(!source.empty(), "No embedded source found in " + entry.fileName);
+		for (auto const& figure: measureContract(source, entry.contractName, entry.constructorArgs))
+			current[figure.first] = figure.second;
+	}
+
+	if (getenv("SOLTEST_UPDATE_GAS_BASELINE"))
+	{
+		writeBaseline(baselineFileName(), current);
+		return;
+	}
+
+	map<pair<string, string>, GasFigures> baseline = readBaseline(baselineFileName());
+	unsigned tolerance = tolerancePercent();
+	vector<string> regressions;
+	vector<string> newlyRecorded;
+	for (auto const& figure: current)
+	{
+		string name = figure.first.first + "." + figure.first.second;
+		auto recorded = baseline.find(figure.first);
+		// A function the baseline does not cover yet is recorded now and
+		// reported as a warning; only measured figures can regress.
+		if (recorded == baseline.end() || !recorded->second.recorded)
+		{
+			baseline[figure.first] = figure.second;
+			newlyRecorded.push_back(name);
+			continue;
+		}
+		u256 actualLimit = recorded->second.actual + recorded->second.actual * tolerance / 100;
+		if (recorded->second.actual > 0 && figure.second.actual > actualLimit)
+			regressions.push_back(
+				name + ": execution gas " + recorded->second.actual.str() +
+				" -> " + figure.second.actual.str() + " (limit " + actualLimit.str() + ")"
+			);
+		if (!recorded->second.estimateInfinite && figure.second.estimateInfinite)
+			regressions.push_back(name + ": estimate became infinite");
+		else if (!recorded->second.estimateInfinite && !figure.second.estimateInfinite)
+		{
+			u256 estimateLimit = recorded->second.estimate + recorded->second.estimate * tolerance / 100;
+			if (recorded->second.estimate > 0 && figure.second.estimate > estimateLimit)
+				regressions.push_back(
+					name + ": estimated gas " + recorded->second.estimate.str() +
+					" -> " + figure.second.estimate.str() + " (limit " + estimateLimit.str() + ")"
+				);
+		}
+	}
+
+	if (!newlyRecorded.empty())
+	{
+		writeBaseline(baselineFileName(), baseline);
+		string recordedList;
+		for (string const& name: newlyRecorded)
+			recordedList += "\n\t" + name;
+		BOOST_WARN_MESSAGE(
+			false,
+			"Recorded first-time gas figures for " + to_string(newlyRecorded.size()) +
+			" function(s); review and commit the updated baseline:" + recordedList
+		);
+	}
+
+	string diff;
+	for (string const& regression: regressions)
+		diff += "\n\t" + regression;
+	BOOST_CHECK_MESSAGE(regressions.empty(), "Gas regressions beyond " + to_string(tolerance) + "%:" + diff);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+}
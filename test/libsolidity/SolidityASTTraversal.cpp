@@ -0,0 +1,148 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Unit tests for the iterative AST traversal engine.
+ */
+
+#include <string>
+#include <vector>
+#include <libsolidity/Scanner.h>
+#include <libsolidity/Parser.h>
+#include <libsolidity/ASTTraversal.h>
+#include <libsolidity/ASTStaticVisitor.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+namespace
+{
+
+ASTPointer<SourceUnit> parseText(string const& _source)
+{
+	ErrorList errors;
+	ASTPointer<SourceUnit> sourceUnit = Parser(errors).parse(make_shared<Scanner>(CharStream(_source)));
+	BOOST_REQUIRE(sourceUnit);
+	return sourceUnit;
+}
+
+/// Records the (event, node) sequence of a traversal.
+vector<pair<bool, ASTNode const*>> traversalEvents(ASTNode const& _root, bool _iterative)
+{
+	vector<pair<bool, ASTNode const*>> events;
+	SimpleASTVisitor visitor(
+		[&](ASTNode const& _node) { events.push_back({true, &_node}); return true; },
+		[&](ASTNode const& _node) { events.push_back({false, &_node}); }
+	);
+	if (_iterative)
+		acceptIteratively(_root, visitor);
+	else
+		_root.accept(visitor);
+	return events;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(SolidityASTTraversal)
+
+BOOST_AUTO_TEST_CASE(matches_recursive_traversal)
+{
+	ASTPointer<SourceUnit> sourceUnit = parseText(
+		"contract base { function foo(uint a) returns (uint) { return a * 2 + 1; } }\n"
+		"contract derived is base {\n"
+		"  struct S { uint x; bytes32 y; }\n"
+		"  mapping(address => uint) balances;\n"
+		"  function f() { if (true) { balances[msg.sender] = foo(3); } else { while (false) {} } }\n"
+		"}\n"
+	);
+	auto recursive = traversalEvents(*sourceUnit, false);
+	auto iterative = traversalEvents(*sourceUnit, true);
+	BOOST_REQUIRE_EQUAL(recursive.size(), iterative.size());
+	for (size_t i = 0; i < recursive.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL(recursive[i].first, iterative[i].first);
+		BOOST_CHECK(recursive[i].second == iterative[i].second);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(deeply_nested_expression)
+{
+	// Expression nesting deep enough to be painful for recursive passes but
+	// handled fine by the explicit work stack.
+	string expression = "1";
+	for (unsigned i = 0; i < 2000; ++i)
+		expression = "(" + expression + " + 1)";
+	ASTPointer<SourceUnit> sourceUnit = parseText(
+		"contract c { function f() { var x = " + expression + "; } }"
+	);
+	size_t visited = 0;
+	SimpleASTVisitor visitor(
+		[&](ASTNode const&) { visited++; return true; },
+		[](ASTNode const&) {}
+	);
+	acceptIteratively(*sourceUnit, visitor);
+	BOOST_CHECK(visited > 4000);
+}
+
+namespace
+{
+
+class CountingStaticVisitor: public ASTStaticVisitor<CountingStaticVisitor>
+{
+public:
+	bool visitNode(ASTNode const&) { m_visits++; return true; }
+	void endVisitNode(ASTNode const&) { m_endVisits++; }
+
+	size_t m_visits = 0;
+	size_t m_endVisits = 0;
+};
+
+}
+
+BOOST_AUTO_TEST_CASE(static_visitor_dispatch)
+{
+	ASTPointer<SourceUnit> sourceUnit = parseText(
+		"contract c { uint stored; function f(uint a) returns (uint) { stored = a; return stored + 1; } }"
+	);
+	auto recursive = traversalEvents(*sourceUnit, false);
+	CountingStaticVisitor counter;
+	counter.walk(*sourceUnit);
+	BOOST_CHECK_EQUAL(counter.m_visits, recursive.size() / 2);
+	BOOST_CHECK_EQUAL(counter.m_endVisits, recursive.size() / 2);
+}
+
+BOOST_AUTO_TEST_CASE(collect_children)
+{
+	ASTPointer<SourceUnit> sourceUnit = parseText("contract a {} contract b {}");
+	vector<ASTNode const*> children = collectChildren(*sourceUnit);
+	BOOST_REQUIRE_EQUAL(children.size(), 2);
+	BOOST_CHECK(dynamic_cast<ContractDefinition const*>(children[0]));
+	BOOST_CHECK(dynamic_cast<ContractDefinition const*>(children[1]));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+} // end namespaces
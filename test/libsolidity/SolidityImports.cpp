@@ -0,0 +1,153 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @date 2015
+ * Unit tests for the import dependency graph exposed by CompilerStack.
+ */
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+#include <libsolidity/CompilerStack.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+namespace dev
+{
+namespace solidity
+{
+namespace test
+{
+
+BOOST_AUTO_TEST_SUITE(SolidityImports)
+
+BOOST_AUTO_TEST_CASE(import_graph)
+{
+	CompilerStack stack(false);
+	stack.addSource("a", "contract A {}");
+	stack.addSource("b", "import \"a\"; contract B is A {}");
+	stack.addSource("c", "import \"b\"; contract C is B {}");
+	stack.addSource("d", "contract D {}");
+	BOOST_REQUIRE(stack.parse());
+
+	CompilerStack::ImportGraph const& graph = stack.importGraph();
+	auto position = [&](string const& _name)
+	{
+		auto it = find(graph.topologicalOrder.begin(), graph.topologicalOrder.end(), _name);
+		BOOST_REQUIRE(it != graph.topologicalOrder.end());
+		return it - graph.topologicalOrder.begin();
+	};
+	BOOST_CHECK(position("a") < position("b"));
+	BOOST_CHECK(position("b") < position("c"));
+	BOOST_CHECK(graph.imports.at("b") == vector<string>({"a"}));
+	BOOST_CHECK(graph.importers.at("a") == vector<string>({"b"}));
+	BOOST_CHECK(graph.importers.at("b") == vector<string>({"c"}));
+	BOOST_CHECK(!graph.imports.count("a"));
+}
+
+BOOST_AUTO_TEST_CASE(dirty_set)
+{
+	CompilerStack stack(false);
+	stack.addSource("a", "contract A {}");
+	stack.addSource("b", "import \"a\"; contract B is A {}");
+	stack.addSource("c", "import \"b\"; contract C is B {}");
+	stack.addSource("d", "contract D {}");
+	BOOST_REQUIRE(stack.parse());
+
+	BOOST_CHECK(stack.sourcesAffectedBy({"a"}) == set<string>({"a", "b", "c"}));
+	BOOST_CHECK(stack.sourcesAffectedBy({"b"}) == set<string>({"b", "c"}));
+	BOOST_CHECK(stack.sourcesAffectedBy({"d"}) == set<string>({"d"}));
+	BOOST_CHECK(stack.contractsAffectedBy({"b"}) == vector<string>({"B", "C"}));
+}
+
+BOOST_AUTO_TEST_CASE(signature_only_parse)
+{
+	CompilerStack stack(false);
+	stack.addSource("a", "contract A { function f(uint x) returns (uint) { return x + 1; } }");
+	stack.addSource("b", "import \"a\"; contract B is A { function g() { var y = f(2); y; } }");
+	BOOST_REQUIRE(stack.parseSignatures());
+
+	BOOST_CHECK(stack.importGraph().imports.at("b") == vector<string>({"a"}));
+	vector<string> contracts = stack.contractNames();
+	BOOST_CHECK(find(contracts.begin(), contracts.end(), "A") != contracts.end());
+	BOOST_CHECK(find(contracts.begin(), contracts.end(), "B") != contracts.end());
+
+	// A subsequent full parse must not reuse the body-less ASTs.
+	BOOST_REQUIRE(stack.parse());
+	BOOST_CHECK(!stack.contractDefinition("A").definedFunctions().empty());
+	BOOST_CHECK(stack.contractDefinition("A").definedFunctions().front()->isImplemented());
+}
+
+BOOST_AUTO_TEST_CASE(optimized_storage_layout)
+{
+	char const* text = "contract C { uint128 a; uint256 b; uint128 c; }";
+	CompilerStack stack(false);
+	stack.setOptimizeStorageLayout(true);
+	stack.addSource("", text);
+	BOOST_REQUIRE(stack.parse());
+	Json::Value layout = stack.storageLayout("C");
+	BOOST_REQUIRE_EQUAL(layout.size(), 3u);
+	map<string, string> slots;
+	for (Json::Value const& entry: layout)
+		slots[entry["name"].asString()] = entry["slot"].asString();
+	// With size-sorted assignment the two uint128 halves share one slot
+	// instead of padding out the slots around b.
+	BOOST_CHECK(slots["a"] == slots["c"]);
+	BOOST_CHECK(slots["a"] != slots["b"]);
+}
+
+BOOST_AUTO_TEST_CASE(streaming_diagnostics)
+{
+	char const* text = "contract A { function f() { uint x = true; x; bool y = 1; y; } }";
+
+	CompilerStack stack(false);
+	stack.addSource("a", text);
+	size_t seen = 0;
+	stack.setDiagnosticsSink([&](Error const&) { ++seen; return true; });
+	BOOST_CHECK(!stack.parse());
+	BOOST_CHECK_EQUAL(seen, stack.errors().size());
+	BOOST_CHECK(seen >= 2);
+
+	// Returning false from the sink cancels after the first error.
+	CompilerStack cancelling(false);
+	cancelling.addSource("a", text);
+	size_t cancelSeen = 0;
+	cancelling.setDiagnosticsSink([&](Error const&) { ++cancelSeen; return false; });
+	BOOST_CHECK(!cancelling.parse());
+	BOOST_CHECK_EQUAL(cancelSeen, 1);
+}
+
+BOOST_AUTO_TEST_CASE(lazy_body_checking)
+{
+	CompilerStack stack(false);
+	stack.addSource("a", "contract A { function f() { uint x = true; x; } }");
+	stack.addSource("b", "contract B { function g() returns (uint) { return 2; } }");
+	stack.setBodyCheckFocus({"b"});
+	// The type error inside A's body must not surface until its deferred check runs.
+	BOOST_REQUIRE(stack.parse());
+	BOOST_CHECK(stack.errors().empty());
+	BOOST_CHECK(!stack.checkContractBodies("A"));
+	BOOST_CHECK(!stack.errors().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
+} // end namespaces
@@ -20,6 +20,8 @@
  * Unit tests for the solidity scanner.
  */
 
+#include <chrono>
+#include <map>
 #include <libsolidity/Scanner.h>
 #include <boost/test/unit_test.hpp>
 
@@ -291,6 +293,134 @@ BOOST_AUTO_TEST_CASE(empty_comment)
 
 }
 
+BOOST_AUTO_TEST_CASE(pre_tokenized_mode)
+{
+	// The buffered scanner has to behave exactly like the on-the-fly one.
+	std::string source = "/// doc\ncontract C { function f() returns (uint) { return 0x42; } }";
+	Scanner streaming(CharStream(source));
+	Scanner buffered(CharStream(source), "", true);
+	BOOST_CHECK_EQUAL(buffered.currentCommentLiteral(), streaming.currentCommentLiteral());
+	while (true)
+	{
+		BOOST_CHECK_EQUAL(buffered.currentToken(), streaming.currentToken());
+		BOOST_CHECK_EQUAL(buffered.currentLiteral(), streaming.currentLiteral());
+		BOOST_CHECK_EQUAL(buffered.currentLocation().start, streaming.currentLocation().start);
+		BOOST_CHECK_EQUAL(buffered.currentLocation().end, streaming.currentLocation().end);
+		if (streaming.currentToken() == Token::EOS)
+			break;
+		streaming.next();
+		buffered.next();
+	}
+}
+
+BOOST_AUTO_TEST_CASE(pre_tokenized_lookahead)
+{
+	Scanner scanner(CharStream("contract C { }"), "", true);
+	BOOST_CHECK_EQUAL(scanner.peekToken(0), Token::Contract);
+	BOOST_CHECK_EQUAL(scanner.peekToken(1), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.peekToken(2), Token::LBrace);
+	BOOST_CHECK_EQUAL(scanner.peekToken(3), Token::RBrace);
+	BOOST_CHECK_EQUAL(scanner.peekToken(4), Token::EOS);
+	// Lookahead past the end stays on EOS.
+	BOOST_CHECK_EQUAL(scanner.peekToken(100), Token::EOS);
+	// The buffer walk has to leave normal iteration unaffected.
+	BOOST_CHECK_EQUAL(scanner.next(), Token::Identifier);
+	BOOST_CHECK_EQUAL(scanner.peekToken(2), Token::RBrace);
+}
+
+BOOST_AUTO_TEST_CASE(position_translation)
+{
+	CharStream stream("abc\nd\n\nef");
+	int line;
+	int column;
+	std::tie(line, column) = stream.translatePositionToLineColumn(0);
+	BOOST_CHECK(line == 0 && column == 0);
+	std::tie(line, column) = stream.translatePositionToLineColumn(3); // the first '\n'
+	BOOST_CHECK(line == 0 && column == 3);
+	std::tie(line, column) = stream.translatePositionToLineColumn(4);
+	BOOST_CHECK(line == 1 && column == 0);
+	std::tie(line, column) = stream.translatePositionToLineColumn(6); // the empty line
+	BOOST_CHECK(line == 2 && column == 0);
+	std::tie(line, column) = stream.translatePositionToLineColumn(8);
+	BOOST_CHECK(line == 3 && column == 1);
+	std::tie(line, column) = stream.translatePositionToLineColumn(9); // end of input
+	BOOST_CHECK(line == 3 && column == 2);
+	BOOST_CHECK_EQUAL(stream.lineAtPosition(1), "abc");
+	BOOST_CHECK_EQUAL(stream.lineAtPosition(4), "d");
+	BOOST_CHECK_EQUAL(stream.lineAtPosition(5), "d"); // points to the '\n' after 'd'
+	BOOST_CHECK_EQUAL(stream.lineAtPosition(8), "ef");
+}
+
+BOOST_AUTO_TEST_CASE(keyword_classification)
+{
+	// Every keyword from TOKEN_LIST has to be recognized by the hashed table...
+#define KEYWORD(name, string, precedence) \
+	BOOST_CHECK_EQUAL(Token::fromIdentifierOrKeyword(string), Token::name);
+#define TOKEN(name, string, precedence)
+	TOKEN_LIST(TOKEN, KEYWORD)
+#undef KEYWORD
+#undef TOKEN
+	// ... and near-keywords have to stay identifiers.
+	BOOST_CHECK_EQUAL(Token::fromIdentifierOrKeyword("contracts"), Token::Identifier);
+	BOOST_CHECK_EQUAL(Token::fromIdentifierOrKeyword("uint257"), Token::Identifier);
+	BOOST_CHECK_EQUAL(Token::fromIdentifierOrKeyword("Contract"), Token::Identifier);
+	BOOST_CHECK_EQUAL(Token::fromIdentifierOrKeyword("_"), Token::Identifier);
+	BOOST_CHECK_EQUAL(Token::fromIdentifierOrKeyword(""), Token::Identifier);
+}
+
+BOOST_AUTO_TEST_CASE(keyword_lookup_benchmark)
+{
+	// Micro-benchmark of keyword classification on a realistic identifier mix
+	// (mostly plain identifiers with keywords and type names interspersed),
+	// compared against the previous std::map based implementation. Only
+	// correctness is asserted; the timings are reported as test messages.
+	std::vector<std::string> mix;
+	for (unsigned i = 0; i < 200; ++i)
+	{
+		mix.push_back("owner" + std::to_string(i));
+		mix.push_back("transferFrom");
+		mix.push_back("balanceOf_" + std::to_string(i));
+		mix.push_back("uint256");
+		mix.push_back("function");
+		mix.push_back("msgSender");
+	}
+#define KEYWORD(name, string, precedence) {string, Token::name},
+#define TOKEN(name, string, precedence)
+	std::map<std::string, Token::Value> const legacyKeywords({TOKEN_LIST(TOKEN, KEYWORD)});
+#undef KEYWORD
+#undef TOKEN
+	auto legacyLookup = [&](std::string const& _name)
+	{
+		auto it = legacyKeywords.find(_name);
+		return it == legacyKeywords.end() ? Token::Identifier : it->second;
+	};
+	unsigned const repetitions = 200;
+	size_t tableHits = 0;
+	size_t mapHits = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (unsigned r = 0; r < repetitions; ++r)
+		for (auto const& name: mix)
+			if (Token::fromIdentifierOrKeyword(name) != Token::Identifier)
+				tableHits++;
+	auto tableTime = std::chrono::high_resolution_clock::now() - start;
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned r = 0; r < repetitions; ++r)
+		for (auto const& name: mix)
+			if (legacyLookup(name) != Token::Identifier)
+				mapHits++;
+	auto mapTime = std::chrono::high_resolution_clock::now() - start;
+	BOOST_CHECK_EQUAL(tableHits, mapHits);
+	for (auto const& name: mix)
+		BOOST_CHECK_EQUAL(Token::fromIdentifierOrKeyword(name), legacyLookup(name));
+	auto toNs = [](std::chrono::high_resolution_clock::duration _d)
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(_d).count();
+	};
+	size_t lookups = mix.size() * repetitions;
+	BOOST_TEST_MESSAGE("hashed keyword table: " + std::to_string(toNs(tableTime) / lookups) + " ns/lookup");
+	BOOST_TEST_MESSAGE("legacy std::map:      " + std::to_string(toNs(mapTime) / lookups) + " ns/lookup");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -49,6 +49,9 @@ public:
 		//m_state.resetCurrent();
 	}
 
+	/// Note that on a cache hit m_compiler is not repopulated; tests that
+	/// inspect the compiler stack afterwards (assembly items, ASTs) have to
+	/// compile directly instead.
 	bytes const& compileAndRunWithoutCheck(
 		std::string const& _sourceCode,
 		u256 const& _value = 0,
@@ -57,10 +60,30 @@ public:
 		std::map<std::string, Address> const& _libraryAddresses = std::map<std::string, Address>()
 	)
 	{
-		m_compiler.reset(false, m_addStandardSources);
-		m_compiler.addSource("", _sourceCode);
-		ETH_TEST_REQUIRE_NO_THROW(m_compiler.compile(m_optimize, m_optimizeRuns), "Compiling contract failed");
-		eth::LinkerObject obj = m_compiler.object(_contractName);
+		// Many test cases compile identical snippets; the unlinked object is
+		// cached across the whole run keyed by source hash and compiler settings,
+		// so repeated compilations become a hash lookup.
+		typedef std::tuple<h256, bool, unsigned, bool, std::string> CacheKey;
+		static std::map<CacheKey, eth::LinkerObject> s_compiledContracts;
+		CacheKey key = std::make_tuple(
+			dev::sha3(_sourceCode),
+			m_optimize,
+			m_optimizeRuns,
+			m_addStandardSources,
+			_contractName
+		);
+		eth::LinkerObject obj;
+		auto cached = s_compiledContracts.find(key);
+		if (cached != s_compiledContracts.end())
+			obj = cached->second;
+		else
+		{
+			m_compiler.reset(false, m_addStandardSources);
+			m_compiler.addSource("", _sourceCode);
+			ETH_TEST_REQUIRE_NO_THROW(m_compiler.compile(m_optimize, m_optimizeRuns), "Compiling contract failed");
+			obj = m_compiler.object(_contractName);
+			s_compiledContracts[key] = obj;
+		}
 		obj.link(_libraryAddresses);
 		BOOST_REQUIRE(obj.linkReferences.empty());
 		sendMessage(obj.bytecode + _arguments, true, _value);